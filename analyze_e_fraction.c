@@ -5,6 +5,15 @@
 
 #define E 2.718281828459045235360287471352662497757
 
+// Largest convergent of e with 64-bit terms (within 7.8e-39 of e)
+static const Rational E_RATIONAL = {INT64_C(5739439214861417731), INT64_C(2111421691000680031)};
+
+// a - b for two fractions with positive denominators, rounded once
+static long double rational_residual(Rational a, Rational b) {
+    __int128 e = (__int128)a.numerator * b.denominator - (__int128)b.numerator * a.denominator;
+    return (long double)e / ((long double)a.denominator * (long double)b.denominator);
+}
+
 int main() {
     // High-precision rational approximation of e
     Rational e_approx = {
@@ -16,7 +25,7 @@ int main() {
 
     // Calculate the actual value
     double value = (double)e_approx.numerator / (double)e_approx.denominator;
-    double error = fabs(value - E);
+    double error = (double)fabsl(rational_residual(e_approx, E_RATIONAL));
 
     printf("Input rational:\n");
     printf("  Numerator:    %" PRId64 "\n", e_approx.numerator);
@@ -67,7 +76,7 @@ int main() {
             cr_print_encoding(&cr);
 
             double cr_value = cr_to_double(&cr, NULL);
-            double cr_error = fabs(cr_value - E);
+            double cr_error = (double)fabsl(cr_residual(&cr, E_RATIONAL, NULL));
 
             printf("\n  CR value:     %.20f\n", cr_value);
             printf("  CR error:     %.20e\n", cr_error);
@@ -101,7 +110,7 @@ int main() {
 
     printf("Best single-tuple (2 + 181/252):\n");
     printf("  Value: %.20f\n", cr_to_double(&simple, NULL));
-    printf("  Error: %.20e\n", fabs(cr_to_double(&simple, NULL) - E));
+    printf("  Error: %.20Le\n", fabsl(cr_residual(&simple, E_RATIONAL, NULL)));
     printf("  Size:  4 bytes\n\n");
 
     // Compare with two-tuple
@@ -113,8 +122,20 @@ int main() {
 
     printf("Best two-tuple (2 + 55/166 + 89/230):\n");
     printf("  Value: %.20f\n", cr_to_double(&two_tuple, NULL));
-    printf("  Error: %.20e\n", fabs(cr_to_double(&two_tuple, NULL) - E));
+    printf("  Error: %.20Le\n", fabsl(cr_residual(&two_tuple, E_RATIONAL, NULL)));
     printf("  Size:  6 bytes\n");
 
+    printf("\n=== Exact Versus Double Error ===\n\n");
+
+    // Past two tuples the errors fall below the spacing of doubles near e:
+    // subtracting in double reports zero or rounding noise
+    printf("Tuples  %-24s  %-24s  %s\n", "Exact error", "Double error", "Closer than 2 tuples");
+    for (int n = 1; n <= MAX_TUPLES; n++) {
+        CompactRational best = cr_approximate_rational(E_RATIONAL, n, 0, NULL);
+        printf("%6d  %-24.15Le  %-24.15e  %s\n", n, fabsl(cr_residual(&best, E_RATIONAL, NULL)),
+               fabs(cr_to_double(&best, NULL) - E),
+               cr_cmp_distance(&best, &two_tuple, E_RATIONAL) < 0 ? "yes" : "no");
+    }
+
     return 0;
 }
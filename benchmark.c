@@ -0,0 +1,776 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "compact_rational.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Values per dataset; small enough to stay cache resident
+#define BENCH_N 4096
+
+// Default minimum measuring time per benchmark, in seconds
+#define BENCH_MIN_TIME 0.2
+
+// ============================================================================
+// DATASETS
+// ============================================================================
+
+/**
+ * Workload distributions
+ * - integers: whole numbers only (the bulk of a real score column)
+ * - mixed: 90% integers, 5% halves, 5% thirds
+ * - adversarial: three to five tuples on unrelated denominators
+ */
+typedef enum {
+    DIST_INTEGERS,
+    DIST_MIXED,
+    DIST_ADVERSARIAL,
+    DIST_COUNT
+} Distribution;
+
+static const char* dist_names[DIST_COUNT] = {"integers", "mixed", "adversarial"};
+
+typedef struct {
+    CompactRational values[BENCH_N];
+    CompactRational others[BENCH_N];  // Second operand for binary operations
+    int32_t nums[BENCH_N];            // Source fractions for cr_from_fraction
+    int32_t denoms[BENCH_N];
+    Rational pairs[BENCH_N];          // The same fractions as 64-bit pairs
+    CRPackedArray packed;             // values in packed form
+    CRColumn column;                  // values as lanes plus a fraction dictionary
+    CRZoneMap zones;                  // Block statistics of packed
+    CRDeltaEncoder delta;             // values as a delta/RLE stream
+    char* text;                       // values formatted one per line
+    size_t text_len;
+    double bytes_per_element;         // Mean cr_size() of values
+} Dataset;
+
+static Dataset datasets[DIST_COUNT];
+
+// Deterministic xorshift so runs are comparable
+static uint32_t rng_state = 0x12345678u;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static CompactRational adversarial_value(void) {
+    CompactRational cr;
+    cr_init(&cr);
+    int tuples = 3 + (int)(next_random() % 3);
+    cr.whole = (int16_t)(0x8000 | (((int)(next_random() % 2000) - 1000) & 0x7FFF));
+    for (int t = 0; t < tuples; t++) {
+        uint8_t offset = (uint8_t)(next_random() % 128);
+        uint8_t num = (uint8_t)(1 + next_random() % (MIN_DENOMINATOR + offset - 1));
+        cr.tuples[t] = (uint16_t)((num << 8) | offset | (t == tuples - 1 ? 0x80 : 0));
+    }
+    return cr;
+}
+
+static void make_source(Distribution dist, int32_t* num, int32_t* denom) {
+    uint32_t r = next_random();
+    int32_t whole = (int32_t)(r % 2000) - 1000;
+    if (dist == DIST_INTEGERS || (dist == DIST_MIXED && r % 20 >= 2)) {
+        *num = whole;
+        *denom = 1;
+    } else if (dist == DIST_MIXED) {
+        *denom = r % 20 == 0 ? 2 : 3;
+        *num = whole * *denom + 1;
+    } else {
+        // Denominators that do not divide one antichain denominator
+        *denom = 256 + (int32_t)(next_random() % 5000);
+        *num = whole * *denom + (int32_t)(next_random() % (uint32_t)*denom);
+    }
+}
+
+static void make_dataset(Distribution dist, Dataset* ds) {
+    size_t bytes = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        make_source(dist, &ds->nums[i], &ds->denoms[i]);
+        ds->pairs[i] = (Rational){ds->nums[i], ds->denoms[i]};
+        if (dist == DIST_ADVERSARIAL) {
+            ds->values[i] = adversarial_value();
+            ds->others[i] = adversarial_value();
+        } else {
+            int32_t n2, d2;
+            make_source(dist, &n2, &d2);
+            ds->values[i] = cr_from_fraction(ds->nums[i], ds->denoms[i], NULL);
+            ds->others[i] = cr_from_fraction(n2, d2, NULL);
+        }
+        bytes += cr_size(&ds->values[i]);
+    }
+    ds->bytes_per_element = (double)bytes / BENCH_N;
+    cr_packed_init(&ds->packed);
+    cr_pack_array(ds->values, BENCH_N, &ds->packed, NULL);
+    cr_column_init(&ds->column);
+    cr_column_append_array(&ds->column, ds->values, BENCH_N, NULL);
+    cr_zone_map_build(&ds->zones, &ds->packed, 256, NULL);
+    cr_delta_encoder_init(&ds->delta);
+    cr_delta_encode(&ds->delta, ds->values, BENCH_N, NULL);
+    cr_delta_encoder_flush(&ds->delta, NULL);
+
+    size_t cap = (size_t)BENCH_N * 64;
+    ds->text = malloc(cap);
+    ds->text_len = 0;
+    for (int i = 0; ds->text != NULL && i < BENCH_N; i++) {
+        ds->text_len += cr_format(ds->text + ds->text_len, cap - ds->text_len, &ds->values[i], 0);
+        ds->text[ds->text_len++] = '\n';
+    }
+}
+
+// ============================================================================
+// BENCHMARK KERNELS
+// ============================================================================
+
+// Results feed this sink so the compiler cannot drop the work
+static volatile int64_t sink;
+
+// Each kernel processes all BENCH_N elements of a dataset once
+typedef void (*BenchKernel)(const Dataset* ds);
+
+static void bench_from_int(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational cr = cr_from_int(ds->nums[i], NULL);
+        acc += cr.whole;
+    }
+    sink += acc;
+}
+
+static void bench_from_fraction(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational cr = cr_from_fraction(ds->nums[i], ds->denoms[i], NULL);
+        acc += cr.whole + cr.tuples[0];
+    }
+    sink += acc;
+}
+
+static void bench_encode_optimal(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational cr = cr_encode_optimal(ds->nums[i], ds->denoms[i], NULL);
+        acc += cr.whole + cr.tuples[0];
+    }
+    sink += acc;
+}
+
+// Bulk ingest: convert and pack in one pass; one thread, so it compares
+// with the serial loop on any machine
+static void bench_pipeline_pack(const Dataset* ds) {
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    cr_pipeline_pack(ds->pairs, BENCH_N, 1, &pa, NULL);
+    sink += (int64_t)pa.size;
+    cr_packed_free(&pa);
+}
+
+static void bench_pipeline_via_serial(const Dataset* ds) {
+    static CompactRational values[BENCH_N];
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    for (int i = 0; i < BENCH_N; i++) {
+        values[i] = cr_encode_optimal(ds->pairs[i].numerator, ds->pairs[i].denominator, NULL);
+    }
+    cr_pack_array(values, BENCH_N, &pa, NULL);
+    sink += (int64_t)pa.size;
+    cr_packed_free(&pa);
+}
+
+// Warm cache shared by all passes, as on a long-running ingest path
+static CRCache bench_cache;
+
+static void bench_cache_encode_optimal(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational cr = cr_cache_encode_optimal(&bench_cache, ds->nums[i], ds->denoms[i], NULL);
+        acc += cr.whole + cr.tuples[0];
+    }
+    sink += acc;
+}
+
+static void bench_to_rational(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        Rational r = cr_to_rational(&ds->values[i]);
+        acc += r.numerator + r.denominator;
+    }
+    sink += acc;
+}
+
+static void bench_to_double(const Dataset* ds) {
+    double acc = 0.0;
+    for (int i = 0; i < BENCH_N; i++) {
+        acc += cr_to_double(&ds->values[i], NULL);
+    }
+    sink += (int64_t)acc;
+}
+
+static void bench_to_double_batch(const Dataset* ds) {
+    static double out[BENCH_N];
+    cr_to_double_batch(ds->values, BENCH_N, out, NULL);
+    sink += (int64_t)out[BENCH_N - 1];
+}
+
+static void bench_add(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational sum = cr_add(&ds->values[i], &ds->others[i], NULL);
+        acc += sum.whole + sum.tuples[0];
+    }
+    sink += acc;
+}
+
+// The same sums through 16-bit lanes, redoing only tagged lanes with cr_add
+static void bench_cr16_add_array(const Dataset* ds) {
+    static cr16_t a[BENCH_N], b[BENCH_N], out[BENCH_N];
+    cr16_from_array(ds->values, BENCH_N, a);
+    cr16_from_array(ds->others, BENCH_N, b);
+    int64_t acc = 0;
+    if (cr16_add_array(a, b, out, BENCH_N, NULL) > 0) {
+        for (int i = 0; i < BENCH_N; i++) {
+            if (cr16_is_integer(out[i])) continue;
+            CompactRational sum = cr_add(&ds->values[i], &ds->others[i], NULL);
+            acc += sum.tuples[0];
+        }
+    }
+    sink += acc + out[BENCH_N - 1];
+}
+
+// Running total in the 64-bit variant: never clamps, unlike cr_add
+static void bench_add64(const Dataset* ds) {
+    CompactRational64 total;
+    cr64_init(&total);
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational64 v = cr64_from_cr(&ds->values[i]);
+        total = cr64_add(&total, &v, NULL);
+    }
+    sink += total.whole + total.tuples[0];
+}
+
+// Sums kept for a short job: packed into an arena, freed by one reset
+static void bench_arena_add(const Dataset* ds) {
+    static CRArena arena;
+    static bool ready = false;
+    if (!ready) {
+        cr_arena_init(&arena, 0);
+        ready = true;
+    }
+    cr_arena_reset(&arena);
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        const uint8_t* sum = cr_arena_add(&arena, &ds->values[i], &ds->others[i], NULL);
+        acc += sum[0];
+    }
+    sink += acc + (int64_t)arena.bytes;
+}
+
+// The same job with one malloc per result and a free per result
+static void bench_add_via_malloc(const Dataset* ds) {
+    static CompactRational* results[BENCH_N];
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        results[i] = malloc(sizeof(CompactRational));
+        *results[i] = cr_add(&ds->values[i], &ds->others[i], NULL);
+        acc += results[i]->whole;
+    }
+    for (int i = 0; i < BENCH_N; i++) {
+        free(results[i]);
+    }
+    sink += acc;
+}
+
+static void bench_mul(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational product = cr_mul(&ds->values[i], &ds->others[i], NULL);
+        acc += product.whole + product.tuples[0];
+    }
+    sink += acc;
+}
+
+static void bench_cmp(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        acc += cr_cmp(&ds->values[i], &ds->others[i]);
+    }
+    sink += acc;
+}
+
+// The comparison cr_cmp replaces in ranking code
+static void bench_cmp_via_double(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        double a = cr_to_double(&ds->values[i], NULL);
+        double b = cr_to_double(&ds->others[i], NULL);
+        acc += (a > b) - (a < b);
+    }
+    sink += acc;
+}
+
+static void bench_canonicalize(const Dataset* ds) {
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational r = cr_canonicalize(&ds->values[i], NULL);
+        acc += r.whole;
+    }
+    sink += acc;
+}
+
+static void bench_canonicalize_array(const Dataset* ds) {
+    static CompactRational out[BENCH_N];
+    cr_canonicalize_array(ds->values, BENCH_N, out, NULL);
+    sink += out[BENCH_N - 1].whole;
+}
+
+static void bench_parse_array(const Dataset* ds) {
+    static CompactRational out[BENCH_N];
+    size_t n = cr_parse_array(ds->text, ds->text_len, ',', true, out, BENCH_N, NULL, NULL);
+    sink += (int64_t)n + out[BENCH_N - 1].whole;
+}
+
+// The ingest path cr_parse_array replaces: strtod on every line
+static void bench_parse_via_strtod(const Dataset* ds) {
+    const char* p = ds->text;
+    double acc = 0.0;
+    for (int i = 0; i < BENCH_N; i++) {
+        char* end;
+        acc += strtod(p, &end);
+        p = strchr(end, '\n') + 1;
+    }
+    sink += (int64_t)acc;
+}
+
+static void bench_format(const Dataset* ds) {
+    char buf[CR_FORMAT_MAX];
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        acc += (int64_t)cr_format(buf, sizeof(buf), &ds->values[i], 0);
+    }
+    sink += acc;
+}
+
+// Decimal text for a report column, as cr_print used to produce it
+static void bench_format_fixed(const Dataset* ds) {
+    char buf[CR_FORMAT_MAX];
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        acc += (int64_t)cr_format(buf, sizeof(buf), &ds->values[i], CR_FORMAT_FIXED);
+    }
+    sink += acc;
+}
+
+// The printf path cr_format replaces: decode to double, then snprintf
+static void bench_format_via_snprintf(const Dataset* ds) {
+    char buf[CR_FORMAT_MAX];
+    int64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        acc += snprintf(buf, sizeof(buf), "%.6f", cr_to_double(&ds->values[i], NULL));
+    }
+    sink += acc;
+}
+
+static void bench_format_array(const Dataset* ds) {
+    static char buf[1 << 16];
+    size_t done = 0;
+    while (done < BENCH_N) {
+        size_t written;
+        done += cr_format_array(buf, sizeof(buf), ds->values + done, BENCH_N - done, '\n', 0, &written);
+        sink += buf[written - 1];
+    }
+}
+
+static void bench_unpack_array(const Dataset* ds) {
+    static CompactRational out[BENCH_N];
+    cr_unpack_array(&ds->packed, 0, BENCH_N, out, NULL);
+    sink += out[BENCH_N - 1].whole;
+}
+
+// The same range decoded from the raw stream, as a receiver would
+static void bench_view_read(const Dataset* ds) {
+    static CompactRational out[BENCH_N];
+    CRView v;
+    cr_view_init(&v, ds->packed.data, ds->packed.size);
+    cr_view_read(&v, out, BENCH_N, NULL);
+    sink += out[BENCH_N - 1].whole;
+}
+
+// A received batch totalled without decoding into structs
+static void bench_view_accumulate(const Dataset* ds) {
+    CRView v;
+    CRAccumulator acc;
+    cr_view_init(&v, ds->packed.data, ds->packed.size);
+    cr_acc_init(&acc);
+    cr_view_accumulate(&v, BENCH_N, &acc, NULL);
+    sink += acc.whole;
+}
+
+static void bench_column_unpack(const Dataset* ds) {
+    static CompactRational out[BENCH_N];
+    cr_column_unpack(&ds->column, 0, BENCH_N, out, NULL);
+    sink += out[BENCH_N - 1].whole;
+}
+
+static void bench_delta_decode(const Dataset* ds) {
+    static CompactRational out[BENCH_N];
+    CRDeltaDecoder dec;
+    cr_delta_decoder_init(&dec, ds->delta.data, ds->delta.size);
+    cr_delta_decode(&dec, out, BENCH_N, NULL);
+    sink += out[BENCH_N - 1].whole;
+}
+
+static void bench_delta_encode(const Dataset* ds) {
+    static CRDeltaEncoder enc;
+    cr_delta_encoder_init(&enc);
+    cr_delta_encode(&enc, ds->values, BENCH_N, NULL);
+    cr_delta_encoder_flush(&enc, NULL);
+    sink += (int64_t)enc.size;
+    cr_delta_encoder_free(&enc);
+}
+
+// Scan of the integer part alone: 2 bytes per row, whatever the fractions
+static void bench_column_scan(const Dataset* ds) {
+    sink += cr16_sum(cr_column_wholes(&ds->column), ds->column.count, NULL);
+}
+
+// Threshold query "at least 89 1/2" against a scan comparing every value
+static void bench_filter_range(const Dataset* ds) {
+    static uint64_t bitmap[BENCH_N / 64];
+    CompactRational lo = cr_from_fraction(179, 2, NULL);
+    sink += (int64_t)cr_filter_range(&ds->packed, &ds->zones, &lo, NULL, bitmap, NULL);
+}
+
+static void bench_filter_via_cmp(const Dataset* ds) {
+    static uint64_t bitmap[BENCH_N / 64];
+    CompactRational lo = cr_from_fraction(179, 2, NULL);
+    static CompactRational decoded[BENCH_N];
+    size_t selected = 0;
+    memset(bitmap, 0, sizeof(bitmap));
+    cr_unpack_array(&ds->packed, 0, BENCH_N, decoded, NULL);
+    for (int i = 0; i < BENCH_N; i++) {
+        if (cr_cmp(&decoded[i], &lo) >= 0) {
+            bitmap[i / 64] |= (uint64_t)1 << (i % 64);
+            selected++;
+        }
+    }
+    sink += (int64_t)selected;
+}
+
+static void bench_sort(const Dataset* ds) {
+    static size_t order[BENCH_N];
+    cr_sort(&ds->packed, order, NULL);
+    sink += (int64_t)order[0];
+}
+
+typedef struct {
+    double value;
+    size_t index;
+} DoubleItem;
+
+static int compare_double_items(const void* a, const void* b) {
+    const DoubleItem* x = a;
+    const DoubleItem* y = b;
+    if (x->value != y->value) return x->value < y->value ? -1 : 1;
+    return x->index < y->index ? -1 : x->index > y->index;
+}
+
+// The leaderboard path cr_sort replaces: decode to double, then qsort
+static void bench_sort_via_double(const Dataset* ds) {
+    static DoubleItem items[BENCH_N];
+    for (int i = 0; i < BENCH_N; i++) {
+        items[i].value = cr_to_double(&ds->values[i], NULL);
+        items[i].index = (size_t)i;
+    }
+    qsort(items, BENCH_N, sizeof(DoubleItem), compare_double_items);
+    sink += (int64_t)items[0].index;
+}
+
+static void bench_topk(const Dataset* ds) {
+    size_t top[100];
+    cr_topk(&ds->packed, 100, top, NULL);
+    sink += (int64_t)top[0];
+}
+
+static void bench_sum_parallel(const Dataset* ds) {
+    CompactRational sum = cr_sum_parallel(ds->values, BENCH_N, 1, NULL);
+    sink += sum.whole;
+}
+
+// Running total of a group: one accumulator add per value, one finish
+static void bench_acc_add(const Dataset* ds) {
+    CRAccumulator acc;
+    cr_acc_init(&acc);
+    for (int i = 0; i < BENCH_N; i++) {
+        cr_acc_add(&acc, &ds->values[i]);
+    }
+    CompactRational64 total = cr_acc_finish64(&acc, NULL);
+    sink += total.whole;
+}
+
+// The same fold through cr64_add, which re-encodes at every step
+static void bench_acc_via_add(const Dataset* ds) {
+    CompactRational64 total;
+    cr64_init(&total);
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational64 v = cr64_from_cr(&ds->values[i]);
+        total = cr64_add(&total, &v, NULL);
+    }
+    sink += total.whole;
+}
+
+// Grouping key: the value hash, then the encoding hash canonical columns can use
+static void bench_hash(const Dataset* ds) {
+    uint64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        acc += cr_hash(&ds->values[i]);
+    }
+    sink += (int64_t)acc;
+}
+
+static void bench_hash_bits(const Dataset* ds) {
+    uint64_t acc = 0;
+    for (int i = 0; i < BENCH_N; i++) {
+        acc += cr_hash_bits(&ds->values[i]);
+    }
+    sink += (int64_t)acc;
+}
+
+// Group-by count of the packed column into a fresh map
+static void bench_count_packed(const Dataset* ds) {
+    CRCountMap map;
+    cr_count_map_init(&map, BENCH_N, 0, NULL);
+    cr_count_packed(&map, &ds->packed, 1, NULL);
+    sink += (int64_t)map.size;
+    cr_count_map_free(&map);
+}
+
+// Grade weights: a few small fractions, cycled
+static const CompactRational* grade_weights(void) {
+    static CompactRational weights[BENCH_N];
+    static bool ready = false;
+    if (!ready) {
+        const int32_t denoms[4] = {3, 4, 6, 4};
+        for (int i = 0; i < BENCH_N; i++) {
+            weights[i] = cr_from_fraction(1, denoms[i % 4], NULL);
+        }
+        ready = true;
+    }
+    return weights;
+}
+
+static void bench_weighted_sum(const Dataset* ds) {
+    CompactRational sum = cr_weighted_sum(grade_weights(), ds->values, BENCH_N, NULL);
+    sink += sum.whole;
+}
+
+// The chain cr_weighted_sum replaces: cr_mul and cr_add per pair
+static void bench_weighted_via_mul(const Dataset* ds) {
+    const CompactRational* weights = grade_weights();
+    CompactRational sum;
+    cr_init(&sum);
+    for (int i = 0; i < BENCH_N; i++) {
+        CompactRational product = cr_mul(&weights[i], &ds->values[i], NULL);
+        sum = cr_add(&sum, &product, NULL);
+    }
+    sink += sum.whole;
+}
+
+// Two-tuple best approximations of irrational-looking doubles near the dataset
+static void bench_approximate(const Dataset* ds) {
+    for (int i = 0; i < BENCH_N; i++) {
+        double target = cr_to_double(&ds->values[i], NULL) / 3.7 + 0.1234567;
+        CompactRational approx = cr_approximate(target, 2, 1, NULL);
+        sink += approx.whole;
+    }
+}
+
+typedef struct {
+    const char* name;
+    BenchKernel kernel;
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+    {"cr_from_int", bench_from_int},
+    {"cr_from_fraction", bench_from_fraction},
+    {"cr_encode_optimal", bench_encode_optimal},
+    {"cr_cache_encode_optimal", bench_cache_encode_optimal},
+    {"cr_pipeline_pack/threads:1", bench_pipeline_pack},
+    {"cr_pipeline_pack/via_serial", bench_pipeline_via_serial},
+    {"cr_to_rational", bench_to_rational},
+    {"cr_to_double", bench_to_double},
+    {"cr_to_double_batch", bench_to_double_batch},
+    {"cr_add", bench_add},
+    {"cr16_add_array", bench_cr16_add_array},
+    {"cr64_add/running_total", bench_add64},
+    {"cr_arena_add", bench_arena_add},
+    {"cr_arena_add/via_malloc", bench_add_via_malloc},
+    {"cr_mul", bench_mul},
+    {"cr_cmp", bench_cmp},
+    {"cr_cmp/via_double", bench_cmp_via_double},
+    {"cr_canonicalize", bench_canonicalize},
+    {"cr_canonicalize_array", bench_canonicalize_array},
+    {"cr_parse_array", bench_parse_array},
+    {"cr_parse_array/via_strtod", bench_parse_via_strtod},
+    {"cr_format", bench_format},
+    {"cr_format/fixed", bench_format_fixed},
+    {"cr_format/fixed_via_snprintf", bench_format_via_snprintf},
+    {"cr_format_array", bench_format_array},
+    {"cr_unpack_array", bench_unpack_array},
+    {"cr_view_read", bench_view_read},
+    {"cr_view_accumulate", bench_view_accumulate},
+    {"cr_column_unpack", bench_column_unpack},
+    {"cr16_sum/column_wholes", bench_column_scan},
+    {"cr_delta_encode", bench_delta_encode},
+    {"cr_delta_decode", bench_delta_decode},
+    {"cr_filter_range", bench_filter_range},
+    {"cr_filter_range/via_cmp", bench_filter_via_cmp},
+    {"cr_sort", bench_sort},
+    {"cr_sort/via_double", bench_sort_via_double},
+    {"cr_topk/k:100", bench_topk},
+    {"cr_sum_parallel/threads:1", bench_sum_parallel},
+    {"cr_acc_add", bench_acc_add},
+    {"cr_acc_add/via_cr64_add", bench_acc_via_add},
+    {"cr_hash", bench_hash},
+    {"cr_hash_bits", bench_hash_bits},
+    {"cr_count_packed/threads:1", bench_count_packed},
+    {"cr_weighted_sum", bench_weighted_sum},
+    {"cr_weighted_sum/via_mul_add", bench_weighted_via_mul},
+    {"cr_approximate/tuples:2", bench_approximate},
+};
+
+// ============================================================================
+// RUNNER
+// ============================================================================
+
+typedef struct {
+    char name[96];
+    uint64_t iterations;   // Elements processed
+    double ns_per_op;
+    double bytes_per_element;
+} BenchResult;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Time one kernel on one dataset
+ * Like Google Benchmark, the pass count doubles until a run lasts at least
+ * min_time; the reported figure is that final run divided by the elements
+ * it processed.
+ */
+static BenchResult run_benchmark(const Benchmark* b, Distribution dist, double min_time) {
+    BenchResult result;
+    snprintf(result.name, sizeof(result.name), "%s/%s", b->name, dist_names[dist]);
+    result.bytes_per_element = datasets[dist].bytes_per_element;
+
+    b->kernel(&datasets[dist]);  // Warm up caches and branch predictors
+
+    uint64_t passes = 1;
+    for (;;) {
+        double start = now_seconds();
+        for (uint64_t p = 0; p < passes; p++) {
+            b->kernel(&datasets[dist]);
+        }
+        double elapsed = now_seconds() - start;
+        if (elapsed >= min_time || passes >= (1ull << 30)) {
+            result.iterations = passes * BENCH_N;
+            result.ns_per_op = elapsed * 1e9 / (double)result.iterations;
+            return result;
+        }
+        passes *= 2;
+    }
+}
+
+static void write_json(FILE* f, const BenchResult* results, size_t count) {
+    fprintf(f, "{\n");
+    fprintf(f, "  \"context\": {\n");
+    fprintf(f, "    \"elements_per_pass\": %d,\n", BENCH_N);
+    fprintf(f, "    \"sizeof_compact_rational\": %zu\n", sizeof(CompactRational));
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < count; i++) {
+        fprintf(f, "    {\"name\": \"%s\", \"iterations\": %llu, \"real_time\": %.3f, "
+                   "\"time_unit\": \"ns\", \"bytes_per_element\": %.3f}%s\n",
+                results[i].name, (unsigned long long)results[i].iterations, results[i].ns_per_op,
+                results[i].bytes_per_element, i + 1 < count ? "," : "");
+    }
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--filter SUBSTRING] [--min-time SECONDS] [--json FILE]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    const char* filter = NULL;
+    const char* json_path = NULL;
+    double min_time = BENCH_MIN_TIME;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    for (int d = 0; d < DIST_COUNT; d++) {
+        make_dataset((Distribution)d, &datasets[d]);
+    }
+    if (!cr_cache_init(&bench_cache, 4 * BENCH_N * DIST_COUNT, NULL)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    size_t num_benchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    BenchResult* results = malloc(num_benchmarks * DIST_COUNT * sizeof(BenchResult));
+    if (results == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    size_t count = 0;
+
+    printf("%-44s %12s %14s %12s\n", "Benchmark", "Time (ns/op)", "Iterations", "Bytes/elem");
+    printf("--------------------------------------------------------------------------------------\n");
+    for (size_t b = 0; b < num_benchmarks; b++) {
+        for (int d = 0; d < DIST_COUNT; d++) {
+            char name[96];
+            snprintf(name, sizeof(name), "%s/%s", benchmarks[b].name, dist_names[d]);
+            if (filter != NULL && strstr(name, filter) == NULL) continue;
+
+            BenchResult r = run_benchmark(&benchmarks[b], (Distribution)d, min_time);
+            printf("%-44s %12.2f %14llu %12.2f\n", r.name, r.ns_per_op,
+                   (unsigned long long)r.iterations, r.bytes_per_element);
+            results[count++] = r;
+        }
+    }
+
+    if (json_path != NULL) {
+        FILE* f = fopen(json_path, "w");
+        if (f == NULL) {
+            fprintf(stderr, "Cannot open %s for writing\n", json_path);
+            free(results);
+            return 1;
+        }
+        write_json(f, results, count);
+        fclose(f);
+        printf("\nWrote %zu results to %s\n", count, json_path);
+    }
+
+    free(results);
+    cr_cache_free(&bench_cache);
+    return 0;
+}
@@ -1,118 +1,6 @@
 #include "compact_rational.h"
 #include <stdio.h>
-#include <stdlib.h>
-#include <stdbool.h>
-
-#define DENOM_RANGE (MAX_DENOMINATOR - MIN_DENOMINATOR + 1)
-
-// ============================================================================
-// CANONICALIZATION - APPROACH 1: GREEDY TUPLE MERGING
-// ============================================================================
-
-/**
- * Canonicalize a CompactRational to its minimal form.
- *
- * Properties of canonical form:
- * 1. No duplicate denominators (each antichain denominator appears at most once)
- * 2. All numerators satisfy: 0 < numerator < denominator
- * 3. Whole part is maximized (all complete integers extracted from tuples)
- * 4. Tuples are sorted by denominator (ascending order)
- * 5. Zero numerators are omitted
- *
- * Algorithm:
- * 1. Decode CompactRational to extract whole and fractional parts
- * 2. Accumulate all numerators by denominator (using array indexed by denom)
- * 3. Extract whole parts from numerators (when numerator >= denominator)
- * 4. Build new tuple list with only non-zero remainders
- * 5. Re-encode with proper end flags
- */
-CompactRational cr_canonicalize(const CompactRational* cr) {
-    CompactRational result;
-    cr_init(&result);
-
-    // Step 1: Extract whole part from input
-    int16_t whole_value = cr->whole & 0x7FFF;  // Bits 14-0
-    if (whole_value & 0x4000) {  // Sign-extend if negative
-        whole_value |= 0x8000;
-    }
-    int32_t whole = whole_value;
-
-    // Step 2: Accumulate numerators by denominator
-    // Use array indexed by (denominator - MIN_DENOMINATOR)
-    uint32_t numerators[DENOM_RANGE] = {0};
-
-    // Check if tuples exist
-    if (cr->whole & 0x8000) {
-        // Process each tuple
-        for (int i = 0; i < MAX_TUPLES; i++) {
-            uint8_t num = (cr->tuples[i] >> 8) & 0xFF;
-            uint8_t denom_byte = cr->tuples[i] & 0xFF;
-            uint8_t offset = denom_byte & 0x7F;
-            bool is_last = (denom_byte & 0x80) != 0;
-
-            // Accumulate numerator for this denominator
-            numerators[offset] += num;
-
-            if (is_last) break;
-        }
-    }
-
-    // Step 3: Extract whole parts from numerators and normalize
-    for (int i = 0; i < DENOM_RANGE; i++) {
-        if (numerators[i] > 0) {
-            uint8_t denom = MIN_DENOMINATOR + i;
-            // Extract complete integers
-            whole += numerators[i] / denom;
-            numerators[i] %= denom;
-        }
-    }
-
-    // Step 4: Clamp whole to valid range
-    if (whole > MAX_WHOLE_VALUE) {
-        fprintf(stderr, "Warning: canonical whole part %d exceeds MAX_WHOLE_VALUE, clamping\n", whole);
-        whole = MAX_WHOLE_VALUE;
-    }
-    if (whole < MIN_WHOLE_VALUE) {
-        fprintf(stderr, "Warning: canonical whole part %d below MIN_WHOLE_VALUE, clamping\n", whole);
-        whole = MIN_WHOLE_VALUE;
-    }
-
-    // Step 5: Build canonical tuple list
-    // Only include non-zero numerators, sorted by denominator (implicit in array traversal)
-    int tuple_count = 0;
-    for (int i = 0; i < DENOM_RANGE && tuple_count < MAX_TUPLES; i++) {
-        if (numerators[i] > 0) {
-            tuple_count++;
-        }
-    }
-
-    if (tuple_count == 0) {
-        // Pure integer, no tuples needed
-        result.whole = (int16_t)(whole & 0x7FFF);  // Bit 15 = 0
-        return result;
-    }
-
-    // Set bit 15 = 1 (tuples present)
-    result.whole = (int16_t)((whole & 0x7FFF) | 0x8000);
-
-    // Encode tuples
-    int tuple_idx = 0;
-    for (int i = 0; i < DENOM_RANGE && tuple_idx < MAX_TUPLES; i++) {
-        if (numerators[i] > 0) {
-            uint8_t offset = i;
-            uint8_t num = (uint8_t)numerators[i];
-
-            // Check if this is the last tuple
-            bool is_last = (tuple_idx == tuple_count - 1);
-            uint8_t denom_byte = offset | (is_last ? 0x80 : 0x00);
-
-            result.tuples[tuple_idx] = ((uint16_t)num << 8) | denom_byte;
-            tuple_idx++;
-        }
-    }
-
-    return result;
-}
+#include <string.h>
 
 // ============================================================================
 // HELPER: Create non-canonical CompactRationals for testing
@@ -212,7 +100,7 @@ void test_canonicalization() {
     printf(" [%zu bytes]\n  ", cr_size(&cr1));
     cr_print_encoding(&cr1);
 
-    CompactRational canon1 = cr_canonicalize(&cr1);
+    CompactRational canon1 = cr_canonicalize(&cr1, NULL);
     printf("  After:  ");
     cr_print(&canon1);
     printf(" [%zu bytes]\n  ", cr_size(&canon1));
@@ -227,7 +115,7 @@ void test_canonicalization() {
     printf(" [%zu bytes]\n  ", cr_size(&cr2));
     cr_print_encoding(&cr2);
 
-    CompactRational canon2 = cr_canonicalize(&cr2);
+    CompactRational canon2 = cr_canonicalize(&cr2, NULL);
     printf("  After:  ");
     cr_print(&canon2);
     printf(" [%zu bytes]\n  ", cr_size(&canon2));
@@ -242,7 +130,7 @@ void test_canonicalization() {
     printf(" [%zu bytes]\n  ", cr_size(&cr3));
     cr_print_encoding(&cr3);
 
-    CompactRational canon3 = cr_canonicalize(&cr3);
+    CompactRational canon3 = cr_canonicalize(&cr3, NULL);
     printf("  After:  ");
     cr_print(&canon3);
     printf(" [%zu bytes]\n  ", cr_size(&canon3));
@@ -257,7 +145,7 @@ void test_canonicalization() {
     printf(" [%zu bytes]\n  ", cr_size(&cr4));
     cr_print_encoding(&cr4);
 
-    CompactRational canon4 = cr_canonicalize(&cr4);
+    CompactRational canon4 = cr_canonicalize(&cr4, NULL);
     printf("  After:  ");
     cr_print(&canon4);
     printf(" [%zu bytes]\n  ", cr_size(&canon4));
@@ -276,13 +164,33 @@ void test_canonicalization() {
     printf(" [%zu bytes]\n  ", cr_size(&cr5));
     cr_print_encoding(&cr5);
 
-    CompactRational canon5 = cr_canonicalize(&cr5);
+    CompactRational canon5 = cr_canonicalize(&cr5, NULL);
     printf("  After:  ");
     cr_print(&canon5);
     printf(" [%zu bytes]\n  ", cr_size(&canon5));
     cr_print_encoding(&canon5);
     printf("  Expected: No change (7 + 43/129)\n\n");
 
+    // Test 6: Batch variant
+    printf("Test 6: cr_canonicalize_array over Tests 1-5 (in place)\n");
+    CompactRational batch[5] = {cr1, cr2, cr3, cr4, cr5};
+    CompactRational singles[5] = {canon1, canon2, canon3, canon4, canon5};
+    CRError error;
+    size_t clamped = cr_canonicalize_array(batch, 5, batch, &error);
+    printf("  Clamped: %zu, error: %s\n", clamped, error.message);
+    printf("  Matches cr_canonicalize: %s\n", memcmp(batch, singles, sizeof(batch)) == 0 ? "yes" : "NO");
+    printf("  Expected: 0 clamped, matches\n\n");
+
+    // Test 7: Carry past MAX_WHOLE_VALUE
+    printf("Test 7: Carry past MAX_WHOLE_VALUE (16383 + 200/128 + 100/128)\n");
+    CompactRational cr7 = cr2;
+    cr7.whole = (int16_t)(0x8000 | MAX_WHOLE_VALUE);
+    CompactRational canon7 = cr_canonicalize(&cr7, &error);
+    printf("  After:  ");
+    cr_print(&canon7);
+    printf("\n  Error: %s\n", error.message);
+    printf("  Expected: 16383 + 44/128, clamped from 16385\n\n");
+
     printf("=== All Tests Complete ===\n");
 }
 
@@ -16,6 +16,56 @@
 #define MAX_WHOLE_VALUE 16383
 #define MIN_WHOLE_VALUE -16383
 
+// Whole-part range of CompactRational32 and CompactRational64
+#define CR32_MAX_WHOLE_VALUE INT32_C(1073741823)
+#define CR32_MIN_WHOLE_VALUE (-CR32_MAX_WHOLE_VALUE)
+#define CR64_MAX_WHOLE_VALUE INT64_C(4611686018427387903)
+#define CR64_MIN_WHOLE_VALUE (-CR64_MAX_WHOLE_VALUE)
+
+// Largest packed encoding: 2 bytes for whole + 2 bytes per tuple
+#define CR_MAX_PACKED_SIZE (2 + 2 * MAX_TUPLES)
+
+// Number of values between entries of a CRPackedArray offset index
+#ifndef CR_PACKED_INDEX_STRIDE
+#define CR_PACKED_INDEX_STRIDE 64
+#endif
+
+// Default payload bytes per CRArena block
+#ifndef CR_ARENA_DEFAULT_BLOCK_SIZE
+#define CR_ARENA_DEFAULT_BLOCK_SIZE 65536
+#endif
+
+// Pairs per work item of the bulk conversion pipeline
+#ifndef CR_PIPELINE_CHUNK
+#define CR_PIPELINE_CHUNK 4096
+#endif
+
+// Inline fast paths for the hottest calls in programs; make INLINE=1
+#ifndef CR_INLINE
+#define CR_INLINE 0
+#endif
+
+// Instrumentation counters (see cr_stats_snapshot); build with make STATS=1
+#ifndef CR_ENABLE_STATS
+#define CR_ENABLE_STATS 0
+#endif
+
+// Column file format version and default values per statistics block
+#define CR_FILE_VERSION 1
+#define CR_FILE_DEFAULT_BLOCK_SIZE 4096
+
+// cr_file_open flags
+#define CR_FILE_VERIFY 0x1            // Walk the whole stream and check every section
+
+// cr_format flags
+#define CR_FORMAT_IMPROPER 0x1        // "22/3" instead of the mixed number "7 1/3"
+#define CR_FORMAT_DECIMAL 0x2         // Append the value to six places: "7 1/3 (7.333333)"
+#define CR_FORMAT_FIXED 0x4           // Only the value to six places: "7.333333"
+#define CR_FORMAT_ENCODING 0x8        // Raw encoding, as cr_print_encoding shows it
+
+// Buffer size that holds any cr_format output, including the NUL
+#define CR_FORMAT_MAX 128
+
 // ============================================================================
 // TYPE DEFINITIONS
 // ============================================================================
@@ -30,7 +80,13 @@ typedef enum {
     CR_ERROR_VALUE_CLAMPED,           // Input value was clamped to valid range
     CR_ERROR_OVERFLOW,                // Arithmetic overflow detected
     CR_ERROR_INVALID_DENOMINATOR,     // Zero denominator in rational conversion
-    CR_ERROR_TUPLE_BOUNDS             // Tuple array bounds exceeded
+    CR_ERROR_TUPLE_BOUNDS,            // Tuple array bounds exceeded
+    CR_ERROR_OUT_OF_MEMORY,           // Memory allocation failed
+    CR_ERROR_OUT_OF_BOUNDS,           // Element index outside the container
+    CR_ERROR_INVALID_ENCODING,        // Malformed or truncated packed byte stream
+    CR_ERROR_INEXACT,                 // No exact encoding within MAX_TUPLES; value approximated
+    CR_ERROR_IO,                      // File could not be opened, mapped, read or written (value1 = errno)
+    CR_ERROR_SYNTAX                   // Text is not a number (value1 = field, value2 = byte offset)
 } CRErrorCode;
 
 /**
@@ -44,6 +100,63 @@ typedef struct {
     int32_t value2;                   // Additional context value (e.g., limit that was exceeded)
 } CRError;
 
+/**
+ * Library operation that reported a status (for lazy message formatting)
+ */
+typedef enum {
+    CR_OP_NONE = 0,
+    CR_OP_FROM_INT,
+    CR_OP_FROM_FRACTION,
+    CR_OP_TO_DOUBLE,
+    CR_OP_ADD,
+    CR_OP_PACKED_RESERVE,
+    CR_OP_PACKED_GET,
+    CR_OP_UNPACK_ARRAY,
+    CR_OP_TO_DOUBLE_BATCH,
+    CR_OP_SUM,
+    CR_OP_ENCODE_OPTIMAL,
+    CR_OP_CACHE_INIT,
+    CR_OP_FILE_WRITE,
+    CR_OP_FILE_OPEN,
+    CR_OP_SUB,
+    CR_OP_MUL,
+    CR_OP_DIV,
+    CR_OP_NEG,
+    CR_OP_SORT,
+    CR_OP_TOPK,
+    CR_OP_HISTOGRAM,
+    CR_OP_CANONICALIZE,
+    CR_OP_PARSE,
+    CR_OP_NARROW,
+    CR_OP_ARENA,
+    CR_OP_WEIGHTED_SUM,
+    CR_OP_APPROXIMATE,
+    CR_OP_COLUMN_APPEND,
+    CR_OP_COLUMN_GET,
+    CR_OP_ZONE_MAP,
+    CR_OP_FILTER,
+    CR_OP_DELTA,
+    CR_OP_PIPELINE,
+    CR_OP_COUNT_MAP,
+    CR_OP_VIEW
+} CROperation;
+
+/**
+ * Compact 16-byte status record
+ * The same code and context values as CRError, plus the operation, without
+ * the message buffer; cr_error_format() produces the text on demand.
+ */
+typedef struct {
+    CRErrorCode code;                 // Error code
+    uint16_t op;                      // CROperation that reported it
+    uint16_t reserved;
+    int32_t value1;                   // Same meaning as CRError.value1
+    int32_t value2;                   // Same meaning as CRError.value2
+} CRStatus;
+
+// Bit for an error code in cr_error_flags()
+#define CR_ERROR_FLAG(code) (1u << (code))
+
 /**
  * Compact Rational structure
  *
@@ -58,6 +171,188 @@ typedef struct {
     uint16_t tuples[MAX_TUPLES];      // Each: high byte = numerator, low byte = denom info
 } CompactRational;
 
+/**
+ * Packed array of compact rationals
+ *
+ * Values are stored back to back in their real 2+2n byte form (little-endian
+ * whole, then little-endian tuples), so an integer costs 2 bytes instead of
+ * sizeof(CompactRational). The offset index records the byte position of
+ * every CR_PACKED_INDEX_STRIDE-th value for random access.
+ *
+ * A view borrows its stream and index from elsewhere (a mapped column
+ * file): freeing it releases nothing, and the first append copies the
+ * borrowed storage into memory the array owns.
+ */
+typedef struct {
+    uint8_t* data;                    // Packed byte stream
+    size_t size;                      // Bytes in use
+    size_t capacity;                  // Bytes allocated
+    size_t count;                     // Number of values stored
+    uint64_t* index;                  // Byte offset of value i * CR_PACKED_INDEX_STRIDE
+    size_t index_capacity;            // Index entries allocated
+    bool view;                        // Storage is borrowed and read-only
+} CRPackedArray;
+
+// Number of hit/miss counter stripes in a CRCache
+#ifndef CR_CACHE_STRIPES
+#define CR_CACHE_STRIPES 16
+#endif
+
+/**
+ * One slot of a CRCache
+ * seq is a seqlock sequence: odd while a writer is filling the slot.
+ */
+typedef struct {
+    uint32_t seq;                     // Seqlock sequence (odd = being written)
+    uint32_t kind;                    // Encoder that produced value (0 = empty)
+    int64_t num;                      // Reduced numerator (key)
+    int64_t denom;                    // Reduced denominator (key)
+    uint32_t value[3];                // Cached CompactRational, bit for bit
+} CRCacheEntry;
+
+/**
+ * Hit and miss counters for one stripe, padded and aligned to a cache line
+ * so threads counting on different stripes do not contend (padding alone
+ * would leave each stripe straddling two lines of the CRCache)
+ */
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint8_t pad[48];
+} __attribute__((aligned(64))) CRCacheCounters;
+
+/**
+ * Bounded, thread-safe memoization cache for encodings
+ * A fixed table of seqlock slots: lookups never lock or write shared
+ * state except their own counter stripe, and inserts skip a slot another
+ * writer holds instead of waiting. The counter stripes make the struct
+ * 64-byte aligned: allocate one with aligned_alloc, not malloc.
+ */
+typedef struct {
+    CRCacheEntry* entries;            // 2^k slots
+    size_t mask;                      // Slot count - 1
+    CRCacheCounters counters[CR_CACHE_STRIPES];
+} CRCache;
+
+// One block of arena memory (defined in compact_rational_arena.c)
+typedef struct CRArenaBlock CRArenaBlock;
+
+/**
+ * Bump allocator for packed values
+ * Values are written in their packed 2+2n byte form, back to back in large
+ * blocks, so a value costs its real size with no per-value malloc and no
+ * padding. cr_arena_reset() rewinds to the first block and keeps every
+ * block for the next job; nothing is freed one value at a time.
+ */
+typedef struct {
+    CRArenaBlock* first;              // Oldest block (allocation restarts here after a reset)
+    CRArenaBlock* current;            // Block being filled
+    size_t used;                      // Bytes used in current
+    size_t block_size;                // Payload bytes of a regular block
+    size_t bytes;                     // Bytes handed out since the last reset
+    size_t reserved;                  // Payload bytes of all blocks held
+} CRArena;
+
+/**
+ * Column file header (128 bytes at offset 0)
+ *
+ * A column file holds one packed stream plus the metadata needed to use
+ * it in place. All fields are little-endian and every section starts on a
+ * 64-byte boundary, so the sections can be read straight from a mapping:
+ *
+ *   header | packed stream | block table | offset index | integer bitmap
+ *
+ * The offset index has the layout of CRPackedArray.index and the bitmap
+ * has one bit per value (bit i % 64 of word i / 64), set when bit 15 of
+ * the value's whole field is clear.
+ */
+typedef struct {
+    char magic[8];                    // "CRCOLUMN"
+    uint32_t version;                 // CR_FILE_VERSION
+    uint32_t header_size;             // sizeof(CRFileHeader)
+    uint64_t count;                   // Number of values
+    uint32_t block_size;              // Values per statistics block
+    uint32_t index_stride;            // CR_PACKED_INDEX_STRIDE of the writer
+    uint64_t block_count;             // Entries in the block table
+    uint64_t data_offset;             // Packed stream
+    uint64_t data_size;
+    uint64_t blocks_offset;           // CRFileBlock[block_count]
+    uint64_t index_offset;            // uint64_t[ceil(count / index_stride)]
+    uint64_t bitmap_offset;           // uint64_t[ceil(count / 64)]
+    uint64_t file_size;               // Total bytes, for truncation checks
+    uint64_t reserved[5];
+} CRFileHeader;
+
+// Block statistics flags
+#define CR_FILE_BLOCK_SUM_INEXACT 0x1 // sum_fraction was approximated (needed > MAX_TUPLES)
+
+/**
+ * Statistics for one block of a column file (64 bytes)
+ * The block sum is sum_whole + sum_fraction, kept apart so it never clamps.
+ */
+typedef struct {
+    uint64_t offset;                  // Stream offset of the block's first value
+    uint32_t count;                   // Values in the block
+    uint32_t integer_count;           // Values with no tuples
+    int64_t sum_whole;                // Whole part of the exact block sum
+    CompactRational min;              // Smallest value
+    CompactRational max;              // Largest value
+    CompactRational sum_fraction;     // Canonical fractional part of the sum (whole = 0)
+    uint32_t flags;                   // CR_FILE_BLOCK_* bits
+} CRFileBlock;
+
+/**
+ * A column file opened for reading
+ * Every pointer refers into one read-only mapping of the file; values is
+ * a view, so cr_packed_get() and cr_unpack_array() read the stream in
+ * place.
+ */
+typedef struct {
+    const uint8_t* map;               // Whole-file mapping
+    size_t map_size;
+    const CRFileHeader* header;
+    const CRFileBlock* blocks;        // header->block_count entries
+    const uint64_t* integer_bitmap;   // ceil(count / 64) words
+    size_t block_count;
+    CRPackedArray values;             // View of the stream and offset index
+} CRFile;
+
+/**
+ * Streaming column file writer
+ * Values are staged one block at a time; the stream is written as each
+ * block fills, and the tables and header when the writer is closed.
+ */
+typedef struct {
+    void* stream;                     // FILE* being written
+    uint32_t block_size;
+    CompactRational* pending;         // Values of the block being filled
+    size_t pending_count;
+    uint64_t count;                   // Values written so far
+    uint64_t data_size;               // Stream bytes written so far
+    uint8_t* packed;                  // Staging buffer for one packed block
+    CRFileBlock* blocks;
+    size_t block_count;
+    size_t block_capacity;
+    uint64_t* index;
+    size_t index_capacity;
+    uint64_t* bitmap;
+    size_t bitmap_capacity;
+    bool failed;                      // An earlier write failed
+} CRFileWriter;
+
+/**
+ * Zone map: column-file block statistics for a packed stream
+ * Block i covers values i * block_size onward and its offset is where
+ * they start in the stream. Built for a CRPackedArray, or a view of the
+ * block table of an open CRFile.
+ */
+typedef struct {
+    const CRFileBlock* blocks;        // block_count entries
+    size_t block_count;
+    uint32_t block_size;              // Values per block (the last may hold fewer)
+    bool view;                        // blocks belong to a CRFile
+} CRZoneMap;
+
 /**
  * Standard rational structure (for intermediate calculations)
  */
@@ -115,6 +410,74 @@ CompactRational cr_from_int(int32_t value, CRError* error);
  */
 CompactRational cr_from_fraction(int32_t num, int32_t denom, CRError* error);
 
+/**
+ * Encode a fraction with the fewest tuples that represent it exactly
+ * Unlike cr_from_fraction, denominators above 255 are split across up to
+ * MAX_TUPLES antichain denominators (1/17947 = -1 + 22/131 + 114/137). The
+ * minimal tuple count is the smallest set of antichain denominators whose
+ * lcm the reduced denominator divides; numerators then follow from partial
+ * fractions, so no numerator search is needed. When the tuples can only
+ * carry the fraction plus a whole number, the whole part is lowered to
+ * match, so the value stays exact.
+ *
+ * @param num The numerator
+ * @param denom The denominator (must not be zero)
+ * @param error Optional error output: CR_ERROR_INEXACT if no exact
+ *        encoding fits MAX_TUPLES; the fraction is then rounded to within
+ *        5e-13 and encoded exactly (value1 = tuples used)
+ * @return CompactRational representation of the fraction
+ */
+CompactRational cr_encode_optimal(int64_t num, int64_t denom, CRError* error);
+
+// ============================================================================
+// APPROXIMATION
+// ============================================================================
+
+/**
+ * Closest value to a target with at most max_tuples tuples
+ * A set of antichain denominators reaches exactly the multiples of 1/lcm,
+ * so the search runs over denominator sets (largest first) and rounds the
+ * target to each lcm. A subtree is skipped when the continued-fraction
+ * bound on what its extra denominators could add (the best approximation
+ * of the remaining residue with bounded denominator) cannot beat the best
+ * so far. Targets with an exact encoding within max_tuples return it
+ * directly. Ties go to the smaller value, so the result does not depend on
+ * the thread count.
+ *
+ * @param target The value; doubles are taken exactly when their fraction
+ *        fits 63 bits (every |target| >= 2^-10), else rounded to 2^-63
+ * @param max_tuples Tuple budget, 0 (nearest integer) to MAX_TUPLES
+ * @param threads Thread count, as for cr_sum_parallel
+ * @param error Optional error output: CR_ERROR_INEXACT if the result is
+ *        not the target (value1 = tuples used, value2 = max_tuples; NaN
+ *        gives zero), CR_ERROR_VALUE_CLAMPED if the whole part is out of
+ *        range, CR_ERROR_DIVISION_BY_ZERO for a zero denominator
+ * @return The best approximation, encoded as cr_encode_optimal would
+ */
+CompactRational cr_approximate(double target, int max_tuples, int threads, CRError* error);
+CompactRational cr_approximate_rational(Rational target, int max_tuples, int threads, CRError* error);
+
+/**
+ * cr - target, from the exact residual
+ * The difference is formed exactly in 128-bit integers over the product of
+ * the denominators and divided once, so even errors near 1e-30 (a target
+ * like a 64-bit convergent of e against five tuples) keep full long double
+ * precision instead of cancelling as fabs(cr_to_double(cr) - target) does.
+ *
+ * @param error Optional error output: CR_ERROR_DIVISION_BY_ZERO for a zero
+ *        target denominator (0 is returned)
+ */
+long double cr_residual(const CompactRational* cr, Rational target, CRError* error);
+
+/**
+ * Compare the distances of a and b from target exactly
+ * No rounding at all: the residuals are cross-multiplied in 192 bits.
+ * target.denominator must not be zero.
+ *
+ * @return Negative, zero or positive as a is closer, as close, or farther
+ */
+int cr_cmp_distance(const CompactRational* a, const CompactRational* b, Rational target);
+
 // ============================================================================
 // CONVERSION FUNCTIONS
 // ============================================================================
@@ -138,15 +501,70 @@ double cr_to_double(const CompactRational* cr, CRError* error);
 // ============================================================================
 
 /**
- * Add two compact rationals
- * Result is automatically reduced and re-encoded
+ * Arithmetic on two compact rationals
+ * Simple shapes (integers, single tuples on one denominator) are handled
+ * directly on the encoding. Everything else is computed exactly with
+ * 128-bit intermediates and re-encoded as cr_encode_optimal would, so
+ * results are exact whenever MAX_TUPLES tuples can hold them. A whole
+ * part outside the 15-bit range is clamped (CR_ERROR_VALUE_CLAMPED); a
+ * fraction that needs more tuples is rounded (CR_ERROR_INEXACT).
  *
  * @param a First compact rational
  * @param b Second compact rational
  * @param error Optional error output (pass NULL to ignore errors)
- * @return Sum of a and b as a compact rational
+ * @return a + b, a - b, a * b or a / b
  */
 CompactRational cr_add(const CompactRational* a, const CompactRational* b, CRError* error);
+CompactRational cr_sub(const CompactRational* a, const CompactRational* b, CRError* error);
+CompactRational cr_mul(const CompactRational* a, const CompactRational* b, CRError* error);
+
+/**
+ * Divide two compact rationals (see cr_add)
+ * Reports CR_ERROR_DIVISION_BY_ZERO and returns zero if b is zero.
+ */
+CompactRational cr_div(const CompactRational* a, const CompactRational* b, CRError* error);
+
+/**
+ * Negate a compact rational
+ * Only -(MAX_WHOLE_VALUE + f) with f > 0 clamps, since the whole part
+ * of the result is -MAX_WHOLE_VALUE - 1.
+ */
+CompactRational cr_neg(const CompactRational* a, CRError* error);
+
+/**
+ * Exact three-way comparison: -1 if a < b, 0 if equal, 1 if a > b
+ * Never decodes to double or reduces: whole parts decide when they differ
+ * by 10 or more (a fraction part is always below 10), otherwise the
+ * unreduced fraction parts are cross-multiplied in 128 bits. Different
+ * encodings of the same value compare equal.
+ */
+int cr_cmp(const CompactRational* a, const CompactRational* b);
+
+// ============================================================================
+// CANONICALIZATION
+// ============================================================================
+
+/**
+ * Canonicalize a compact rational to its minimal form
+ *
+ * Properties of canonical form:
+ * 1. No duplicate denominators (each antichain denominator appears at most once)
+ * 2. All numerators satisfy: 0 < numerator < denominator
+ * 3. Whole part is maximized (all complete integers extracted from tuples)
+ * 4. Tuples are sorted by denominator (ascending order)
+ * 5. Zero numerators are omitted
+ *
+ * Works in O(tuple count): the tuples are sorted in a local array and
+ * merged in one pass, with no per-denominator scratch table. Tuples on
+ * different denominators are not combined, so 1/2 + 1/3 + 1/6 stays three
+ * tuples (cr_encode_optimal finds the minimal encoding of a value).
+ *
+ * @param cr The compact rational to canonicalize
+ * @param error Optional error output: CR_ERROR_VALUE_CLAMPED if the whole
+ *        part after carrying is out of range (the tuples are kept)
+ * @return The canonical form
+ */
+CompactRational cr_canonicalize(const CompactRational* cr, CRError* error);
 
 // ============================================================================
 // DISPLAY AND DEBUG FUNCTIONS
@@ -154,13 +572,14 @@ CompactRational cr_add(const CompactRational* a, const CompactRational* b, CRErr
 
 /**
  * Print compact rational in human-readable form
- * Format: "whole num/denom (decimal_value)"
+ * Format: "whole num/denom (decimal_value)", i.e. cr_format with
+ * CR_FORMAT_DECIMAL
  */
 void cr_print(const CompactRational* cr);
 
 /**
  * Print raw encoding (for debugging)
- * Shows the internal bit representation
+ * Shows the internal bit representation (cr_format with CR_FORMAT_ENCODING)
  */
 void cr_print_encoding(const CompactRational* cr);
 
@@ -170,4 +589,1456 @@ void cr_print_encoding(const CompactRational* cr);
  */
 size_t cr_size(const CompactRational* cr);
 
+// ============================================================================
+// PACKED STORAGE
+// ============================================================================
+
+/**
+ * Write one value in packed form (2 + 2n bytes)
+ * The end flag is forced on the last tuple written.
+ *
+ * @param cr The compact rational to pack
+ * @param buf Destination buffer
+ * @param cap Bytes available in buf
+ * @return Bytes written, or 0 if buf is too small
+ */
+size_t cr_pack(const CompactRational* cr, uint8_t* buf, size_t cap);
+
+/**
+ * Read one packed value
+ *
+ * @param buf Source buffer
+ * @param len Bytes available in buf
+ * @param cr Output compact rational (unused tuples are zeroed)
+ * @return Bytes consumed, or 0 if the stream is truncated or malformed
+ */
+size_t cr_unpack(const uint8_t* buf, size_t len, CompactRational* cr);
+
+/**
+ * Initialize an empty packed array
+ */
+void cr_packed_init(CRPackedArray* pa);
+
+/**
+ * Release the storage owned by a packed array and reset it to empty
+ */
+void cr_packed_free(CRPackedArray* pa);
+
+/**
+ * Reserve room for additional values
+ *
+ * @param pa The packed array
+ * @param extra_bytes Packed bytes about to be appended
+ * @param extra_count Values about to be appended
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return true on success, false if allocation failed
+ */
+bool cr_packed_reserve(CRPackedArray* pa, size_t extra_bytes, size_t extra_count, CRError* error);
+
+/**
+ * Append one value to a packed array
+ *
+ * @param pa The packed array
+ * @param cr The value to append
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return true on success, false if allocation failed
+ */
+bool cr_packed_append(CRPackedArray* pa, const CompactRational* cr, CRError* error);
+
+/**
+ * Random access into a packed array
+ * Seeks through the offset index, then skips at most
+ * CR_PACKED_INDEX_STRIDE - 1 values.
+ *
+ * @param pa The packed array
+ * @param i Element index
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return The value at index i, or zero if i is out of range
+ */
+CompactRational cr_packed_get(const CRPackedArray* pa, size_t i, CRError* error);
+
+/**
+ * Byte footprint of a packed array (stream plus offset index)
+ */
+size_t cr_packed_footprint(const CRPackedArray* pa);
+
+/**
+ * Append an array of values to a packed array
+ * Storage is sized exactly once before the values are written.
+ *
+ * @param values Values to pack
+ * @param n Number of values
+ * @param out Destination packed array (values are appended)
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return true on success, false if allocation failed
+ */
+bool cr_pack_array(const CompactRational* values, size_t n, CRPackedArray* out, CRError* error);
+
+/**
+ * Decode a range of a packed array
+ *
+ * @param pa The packed array
+ * @param start Index of the first value to decode
+ * @param n Number of values to decode
+ * @param out Destination array (room for n values)
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return Number of values decoded (less than n if the range runs past the end)
+ */
+size_t cr_unpack_array(const CRPackedArray* pa, size_t start, size_t n, CompactRational* out, CRError* error);
+
+// ============================================================================
+// ARENA STORAGE
+// ============================================================================
+
+/**
+ * Initialize an empty arena; no memory is allocated until the first value
+ *
+ * @param arena The arena
+ * @param block_size Payload bytes per block (0 = CR_ARENA_DEFAULT_BLOCK_SIZE)
+ */
+void cr_arena_init(CRArena* arena, size_t block_size);
+
+/**
+ * Release every block and reset to empty (the block size is kept)
+ */
+void cr_arena_free(CRArena* arena);
+
+/**
+ * Invalidate everything allocated so far, keeping the blocks for reuse
+ * O(1): the cursor moves back to the first block.
+ */
+void cr_arena_reset(CRArena* arena);
+
+/**
+ * Allocate bytes from the arena (byte-aligned, as packed values need)
+ * Requests larger than a block get a block of their own.
+ *
+ * @param arena The arena
+ * @param bytes Number of bytes
+ * @param error Optional error output (CR_ERROR_OUT_OF_MEMORY, value1 = block bytes)
+ * @return The memory, valid until the next reset or free; NULL on failure
+ */
+void* cr_arena_alloc(CRArena* arena, size_t bytes, CRError* error);
+
+/**
+ * Copy a value into the arena in packed form
+ *
+ * @return The packed value (read it with cr_arena_load); NULL on failure
+ */
+const uint8_t* cr_arena_store(CRArena* arena, const CompactRational* cr, CRError* error);
+
+/**
+ * Decode a value stored by any cr_arena_* function
+ */
+CompactRational cr_arena_load(const uint8_t* value);
+
+/**
+ * cr_add, cr_canonicalize and cr_encode_optimal writing their result
+ * straight into the arena
+ * The error reports the operation's own outcome (clamping, inexactness)
+ * unless the arena itself runs out of memory.
+ *
+ * @return The packed result; NULL if no memory could be allocated
+ */
+const uint8_t* cr_arena_add(CRArena* arena, const CompactRational* a, const CompactRational* b, CRError* error);
+const uint8_t* cr_arena_canonicalize(CRArena* arena, const CompactRational* cr, CRError* error);
+const uint8_t* cr_arena_encode_optimal(CRArena* arena, int64_t num, int64_t denom, CRError* error);
+
+/**
+ * Bytes of block memory the arena holds
+ */
+size_t cr_arena_footprint(const CRArena* arena);
+
+/**
+ * The calling thread's own arena
+ * Created on first use with the default block size and freed when the
+ * thread exits. Only the owning thread may use it, so no locking is
+ * needed; reset it at the end of each job.
+ *
+ * @return The arena (never NULL)
+ */
+CRArena* cr_arena_thread(void);
+
+// ============================================================================
+// BATCH OPERATIONS
+// ============================================================================
+
+/**
+ * Convert an array of compact rationals to doubles
+ * Blocks with bit 15 clear everywhere skip tuple decoding entirely; other
+ * blocks sum num/(128+offset) directly in floating point without forming a
+ * reduced rational. Results for values with tuples may differ from
+ * cr_to_double() in the last bits.
+ *
+ * @param values Input array
+ * @param n Number of values
+ * @param out Output array (room for n doubles)
+ * @param error Optional error output, set once for the whole batch
+ * @return Number of malformed values (tuple flag set but no end flag within
+ *         MAX_TUPLES); these are still decoded as cr_to_double() would
+ */
+size_t cr_to_double_batch(const CompactRational* values, size_t n, double* out, CRError* error);
+
+/**
+ * Canonicalize an array of compact rationals (see cr_canonicalize)
+ * Blocks with bit 15 clear everywhere are copied without visiting tuples.
+ *
+ * @param values Input array
+ * @param n Number of values
+ * @param out Output array (room for n values; may be values itself)
+ * @param error Optional error output, set once for the whole batch
+ *        (CR_ERROR_VALUE_CLAMPED describes the first clamped value)
+ * @return Number of values whose whole part was clamped
+ */
+size_t cr_canonicalize_array(const CompactRational* values, size_t n, CompactRational* out, CRError* error);
+
+/**
+ * Sum a column of compact rationals exactly
+ * Each thread accumulates its slice into a wide accumulator (64-bit whole,
+ * 64-bit numerator per antichain denominator); the partial sums are merged
+ * and canonicalized once, so intermediate totals never clamp or overflow.
+ *
+ * @param values Input array
+ * @param n Number of values
+ * @param threads Thread count (0 or negative = one per online CPU); small
+ *        inputs use fewer threads
+ * @param error Optional error output: CR_ERROR_VALUE_CLAMPED if the final
+ *        whole part is out of range, CR_ERROR_TUPLE_BOUNDS if the exact sum
+ *        needs more than MAX_TUPLES tuples (the tail is then approximated)
+ * @return The canonical sum
+ */
+CompactRational cr_sum_parallel(const CompactRational* values, size_t n, int threads, CRError* error);
+
+/**
+ * Sum of weights[i] * scores[i], exactly
+ * Both columns are scaled to integers by the lcm of their tuple
+ * denominators (which are all in 128..255, so a handful of distinct
+ * weights keeps the lcm small) and multiplied as a fixed-point dot
+ * product; the total is reduced and encoded once. Columns whose lcm passes
+ * 2^32 fall back to cr_mul per pair and the column-sum accumulator.
+ *
+ * @param weights Weight column
+ * @param scores Score column
+ * @param n Number of pairs
+ * @param error Optional error output: CR_ERROR_VALUE_CLAMPED if the total's
+ *        whole part is out of range, CR_ERROR_INEXACT if it needs more than
+ *        MAX_TUPLES tuples
+ * @return The weighted sum
+ */
+CompactRational cr_weighted_sum(const CompactRational* weights, const CompactRational* scores, size_t n,
+                                CRError* error);
+
+// ============================================================================
+// ERROR REPORTING
+// ============================================================================
+
+/**
+ * Every failure is also recorded per thread, whether or not a CRError was
+ * passed: a sticky bit per error code and the last failing CRStatus. Hot
+ * loops can pass NULL and check cr_error_flags() once per batch; passing a
+ * CRError costs a message format only when something fails.
+ *
+ * A result that is both rounded and clamped reports CR_ERROR_VALUE_CLAMPED
+ * in error->code and cr_last_error(), the clamp being the larger error;
+ * both sticky flags are set.
+ */
+
+/**
+ * Format the human-readable message for a status (snprintf semantics)
+ *
+ * @param buf Destination buffer
+ * @param cap Bytes available in buf
+ * @param status Status to describe
+ * @return Length of the full message, excluding the terminator
+ */
+size_t cr_error_format(char* buf, size_t cap, const CRStatus* status);
+
+/**
+ * Error codes reported on this thread since the last cr_error_clear(),
+ * as a mask of CR_ERROR_FLAG(code) bits (0 = no failures)
+ */
+uint32_t cr_error_flags(void);
+
+/**
+ * Most recent failure on this thread (code CR_SUCCESS if none)
+ */
+CRStatus cr_last_error(void);
+
+/**
+ * Reset this thread's sticky flags and last failure
+ */
+void cr_error_clear(void);
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+/**
+ * Counters on the library's slow and lossy branches, compiled in only when
+ * the library is built with CR_ENABLE_STATS=1. Each thread bumps its own
+ * block with relaxed atomic stores (no locked instructions, no shared
+ * cache lines); snapshots add up every block. Without the flag the hooks
+ * compile to nothing and snapshots read zero.
+ */
+
+// Histogram buckets by log2 of the cycle count; the last one is open-ended
+#define CR_STATS_CYCLE_BUCKETS 24
+
+typedef enum {
+    CR_STAT_FROM_FRACTION = 0,        // cr_from_fraction calls
+    CR_STAT_FROM_FRACTION_LOSSY,      // ... truncating a denominator above 255 to a 1/128 multiple
+    CR_STAT_ADD,                      // Additions (cr_add, and cr_sub through negation)
+    CR_STAT_ADD_SLOW,                 // ... taking the 128-bit path instead of a fast path
+    CR_STAT_ADD_CLAMPED,              // ... whose whole part was clamped
+    CR_STAT_CLAMPED,                  // Clamped whole parts, any operation
+    CR_STAT_INEXACT,                  // Approximated values, any operation
+    CR_STAT_COUNTER_COUNT
+} CRStatCounter;
+
+typedef struct {
+    bool enabled;                                       // Library built with CR_ENABLE_STATS
+    uint64_t counters[CR_STAT_COUNTER_COUNT];           // Indexed by CRStatCounter
+    uint64_t to_rational_depth[MAX_TUPLES + 1];         // cr_to_rational calls by tuples walked
+    uint64_t add_slow_cycles[CR_STATS_CYCLE_BUCKETS];   // 128-bit additions: bucket b holds 2^b..2^(b+1)-1 cycles
+} CRStats;
+
+/**
+ * Totals over every thread, including threads that have exited
+ * Counters only grow; export differences between snapshots. Values from
+ * threads still running may be a few events behind.
+ */
+CRStats cr_stats_snapshot(void);
+
+// ============================================================================
+// ENCODING CACHE
+// ============================================================================
+
+/**
+ * Initialize an empty cache
+ *
+ * @param cache The cache
+ * @param capacity Minimum number of slots (rounded up to a power of two)
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return true on success, false if allocation failed
+ */
+bool cr_cache_init(CRCache* cache, size_t capacity, CRError* error);
+
+/**
+ * Release a cache's table (no other thread may be using it)
+ */
+void cr_cache_free(CRCache* cache);
+
+/**
+ * cr_from_fraction with memoization on the reduced (num, denom) pair
+ * Safe to call from many threads on the same cache. Only results that
+ * encode without error are cached.
+ *
+ * @param cache The cache
+ * @param num The numerator
+ * @param denom The denominator (must not be zero)
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return Same value cr_from_fraction(num, denom) returns
+ */
+CompactRational cr_cache_from_fraction(CRCache* cache, int32_t num, int32_t denom, CRError* error);
+
+/**
+ * cr_encode_optimal with memoization on the reduced (num, denom) pair
+ *
+ * @param cache The cache
+ * @param num The numerator
+ * @param denom The denominator (must not be zero)
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return Same value cr_encode_optimal(num, denom) returns
+ */
+CompactRational cr_cache_encode_optimal(CRCache* cache, int64_t num, int64_t denom, CRError* error);
+
+/**
+ * Read the hit and miss totals across all counter stripes
+ * Either output may be NULL.
+ */
+void cr_cache_stats(const CRCache* cache, uint64_t* hits, uint64_t* misses);
+
+// ============================================================================
+// COLUMN FILES
+// ============================================================================
+
+/**
+ * Create a column file for writing
+ *
+ * @param w The writer
+ * @param path File to create (truncated if it exists)
+ * @param block_size Values per statistics block (0 = CR_FILE_DEFAULT_BLOCK_SIZE)
+ * @param error Optional error output: CR_ERROR_IO (value1 = errno) or
+ *        CR_ERROR_OUT_OF_MEMORY
+ * @return true on success; on failure nothing needs closing
+ */
+bool cr_file_writer_open(CRFileWriter* w, const char* path, uint32_t block_size, CRError* error);
+
+/**
+ * Append values to a column file
+ *
+ * @param w The writer
+ * @param values Values to append
+ * @param n Number of values
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return true on success; after a failure the writer only accepts close
+ */
+bool cr_file_writer_append(CRFileWriter* w, const CompactRational* values, size_t n, CRError* error);
+
+/**
+ * Flush the last block, write the tables and header, and close the file
+ * The writer's memory is released whether or not this succeeds.
+ *
+ * @param w The writer
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return true if the complete file was written
+ */
+bool cr_file_writer_close(CRFileWriter* w, CRError* error);
+
+/**
+ * Write a packed array as a column file in one call
+ *
+ * @param path File to create
+ * @param pa Values to store
+ * @param block_size Values per statistics block (0 = default)
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return true on success
+ */
+bool cr_file_write_packed(const char* path, const CRPackedArray* pa, uint32_t block_size, CRError* error);
+
+/**
+ * Reasons reported in value1 of CR_ERROR_INVALID_ENCODING by cr_file_open
+ * (value2 is the offending value index for CR_FILE_BAD_STREAM)
+ */
+typedef enum {
+    CR_FILE_BAD_MAGIC = 1,            // Not a column file
+    CR_FILE_BAD_VERSION,              // Written by an unsupported format version
+    CR_FILE_BAD_LAYOUT,               // Section sizes or offsets do not fit the file
+    CR_FILE_BAD_STRIDE,               // Offset index built with another CR_PACKED_INDEX_STRIDE
+    CR_FILE_BAD_STREAM,               // Stream, index, bitmap or blocks disagree (CR_FILE_VERIFY)
+    CR_FILE_BIG_ENDIAN                // Host cannot read little-endian sections in place
+} CRFileFault;
+
+/**
+ * Map a column file for reading
+ * Without CR_FILE_VERIFY only the header and section bounds are checked,
+ * so opening costs the same for any file size; an index entry or value
+ * that turns out malformed is reported by the read that meets it
+ * (CR_ERROR_INVALID_ENCODING from cr_packed_get or cr_unpack_array).
+ * With CR_FILE_VERIFY every value, index entry, bitmap bit and block
+ * offset is checked once.
+ *
+ * @param f The file
+ * @param path File to open
+ * @param flags CR_FILE_* flags
+ * @param error Optional error output: CR_ERROR_IO (value1 = errno) or
+ *        CR_ERROR_INVALID_ENCODING (the file is malformed; value1 is a
+ *        CRFileFault)
+ * @return true on success
+ */
+bool cr_file_open(CRFile* f, const char* path, uint32_t flags, CRError* error);
+
+/**
+ * Unmap a column file; views and pointers into it become invalid
+ */
+void cr_file_close(CRFile* f);
+
+/**
+ * Number of values in an open column file
+ */
+static inline size_t cr_file_count(const CRFile* f) {
+    return f->values.count;
+}
+
+/**
+ * Whether value i has no tuples, from the integer bitmap (no stream access)
+ */
+static inline bool cr_file_is_integer(const CRFile* f, size_t i) {
+    return (f->integer_bitmap[i / 64] >> (i % 64)) & 1;
+}
+
+/**
+ * Read value i of an open column file (see cr_packed_get)
+ */
+CompactRational cr_file_get(const CRFile* f, size_t i, CRError* error);
+
+// ============================================================================
+// BULK CONVERSION
+// ============================================================================
+
+/**
+ * Convert Rational pairs to packed values on a worker pool
+ *
+ * The input is cut into chunks of CR_PIPELINE_CHUNK pairs. Workers claim
+ * chunks in order and reduce, classify and encode them into a ring of
+ * 2 * threads chunk buffers: pairs with an integer quotient skip the gcd
+ * and fraction search, the rest go through cr_encode_optimal on the full
+ * 64-bit values (nothing is truncated to int32_t). The calling thread
+ * packs each buffer as soon as it is ready, in row order, and hands it
+ * back; a worker may run at most the ring's length ahead of it. Every
+ * value is bit for bit what cr_encode_optimal returns for its pair.
+ *
+ * @param pairs Input pairs
+ * @param n Number of pairs
+ * @param threads Encoding threads (0 or negative = one per online CPU;
+ *        1 = convert and pack on the calling thread); no more threads
+ *        than chunks are started
+ * @param out Destination packed array (values are appended)
+ * @param error Optional error output: the first failing row as
+ *        cr_encode_optimal reports it (CR_ERROR_DIVISION_BY_ZERO,
+ *        CR_ERROR_VALUE_CLAMPED or CR_ERROR_INEXACT; all rows are still
+ *        converted), or an allocation failure, which stops the pipeline
+ * @return Number of values appended (n unless allocation failed)
+ */
+size_t cr_pipeline_pack(const Rational* pairs, size_t n, int threads, CRPackedArray* out, CRError* error);
+
+/**
+ * Convert Rational pairs straight into a column file (see cr_pipeline_pack)
+ * Each chunk is appended with cr_file_writer_append, so block statistics
+ * and writes overlap the encoding of the chunks behind it.
+ *
+ * @param pairs Input pairs
+ * @param n Number of pairs
+ * @param threads Encoding threads (0 or negative = one per online CPU)
+ * @param w An open writer; the caller closes it
+ * @param error Optional error output (as cr_pipeline_pack, or the writer's
+ *        CR_ERROR_IO, which stops the pipeline)
+ * @return Number of values appended
+ */
+size_t cr_pipeline_write(const Rational* pairs, size_t n, int threads, CRFileWriter* w, CRError* error);
+
+// ============================================================================
+// RANGE QUERIES
+// ============================================================================
+
+/**
+ * Compute block statistics for a packed array
+ * The same min, max, exact sum, count and integer count a column file
+ * records per block.
+ *
+ * @param zm The zone map
+ * @param pa Values to summarize
+ * @param block_size Values per block (0 = CR_FILE_DEFAULT_BLOCK_SIZE)
+ * @param error Optional error output (CR_ERROR_OUT_OF_MEMORY, or
+ *        CR_ERROR_INVALID_ENCODING for a malformed stream)
+ * @return true on success
+ */
+bool cr_zone_map_build(CRZoneMap* zm, const CRPackedArray* pa, uint32_t block_size, CRError* error);
+
+/**
+ * Zone map of an open column file, borrowing its block table
+ * Valid until the file is closed; use with f->values.
+ */
+void cr_zone_map_from_file(CRZoneMap* zm, const CRFile* f);
+
+/**
+ * Release a built zone map (a file view releases nothing)
+ */
+void cr_zone_map_free(CRZoneMap* zm);
+
+/**
+ * Select the values in [lo, hi]
+ * Blocks whose min and max lie inside the range are selected whole and
+ * blocks outside it are skipped, without reading the stream. Only blocks
+ * that straddle a bound are decoded: all-integer blocks by comparing
+ * their 16-bit whole words directly, and the others value by value.
+ *
+ * @param pa Values the zone map was built for
+ * @param zm Block statistics of pa
+ * @param lo Lower bound, inclusive (NULL = unbounded)
+ * @param hi Upper bound, inclusive (NULL = unbounded)
+ * @param bitmap Output: ceil(pa->count / 64) words, bit i % 64 of word
+ *        i / 64 set for each selected value (every word is written)
+ * @param error Optional error output: CR_ERROR_OUT_OF_BOUNDS if the zone
+ *        map does not cover pa (value1 = values summarized), or
+ *        CR_ERROR_INVALID_ENCODING for a malformed stream
+ * @return Number of values selected
+ */
+size_t cr_filter_range(const CRPackedArray* pa, const CRZoneMap* zm, const CompactRational* lo,
+                       const CompactRational* hi, uint64_t* bitmap, CRError* error);
+
+// ============================================================================
+// SORTING AND SELECTION
+// ============================================================================
+
+/**
+ * Order-preserving 56-bit integer key
+ * floor((whole + 16384 + fraction) * 2^40), computed exactly in 64-bit
+ * integers. a < b implies key(a) <= key(b); equal keys mean the values
+ * differ by less than 2^-40 and need cr_cmp to tell apart. Integer values
+ * (and values with equal keys and no fraction bits) are exactly equal.
+ */
+uint64_t cr_sort_key(const CompactRational* cr);
+
+/**
+ * Sort a packed column without converting to double
+ * Keys are extracted in one pass over the stream and radix sorted; runs
+ * of equal keys are then ordered exactly with cr_cmp. The sort is stable:
+ * equal values keep their original relative order. Also works on the
+ * values view of a mapped column file.
+ *
+ * @param pa The packed array
+ * @param order Output permutation (room for pa->count indices):
+ *        pa[order[0]] <= pa[order[1]] <= ...
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return true on success, false if scratch allocation failed or the
+ *         stream is malformed (CR_ERROR_INVALID_ENCODING, value1 = index)
+ */
+bool cr_sort(const CRPackedArray* pa, size_t* order, CRError* error);
+
+/**
+ * Indices of the k largest values, largest first
+ * One pass with a k-entry heap; once it is full most values are rejected
+ * on their key alone. Equal values rank by original index, so the result
+ * matches the first k entries of a descending stable sort.
+ *
+ * @param pa The packed array
+ * @param k Number of values wanted
+ * @param order Output indices (room for k)
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return Number of indices written: min(k, pa->count), or 0 on failure
+ */
+size_t cr_topk(const CRPackedArray* pa, size_t k, size_t* order, CRError* error);
+
+/**
+ * Count values per bin, exactly
+ * Bin b holds edges[b] <= v < edges[b + 1]; values below edges[0] or at
+ * or above edges[bins] are not counted. Each value costs a binary search
+ * over the edge keys, with cr_cmp only when a key equals an edge's.
+ *
+ * @param pa The packed array
+ * @param edges bins + 1 ascending bin edges
+ * @param bins Number of bins
+ * @param counts Output counts (room for bins)
+ * @param error Optional error output (pass NULL to ignore errors)
+ * @return Number of values that fell in some bin
+ */
+size_t cr_histogram(const CRPackedArray* pa, const CompactRational* edges, size_t bins,
+                    uint64_t* counts, CRError* error);
+
+// ============================================================================
+// HASHING AND GROUPING
+// ============================================================================
+
+/**
+ * Whether two values are equal as rationals, whatever their encoding
+ * (64/128 + 32/128 equals 96/128, 1/2 + 1/3 + 1/6 equals 1)
+ */
+bool cr_equal(const CompactRational* a, const CompactRational* b);
+
+/**
+ * Hash of a value, consistent with cr_equal
+ * The value is evaluated modulo the prime 2^61 - 1, each tuple as its
+ * numerator times a tabled inverse of its denominator, so equal values
+ * give equal residues without a gcd or any reduction; the residue is then
+ * mixed. Costs a multiply per tuple.
+ */
+uint64_t cr_hash(const CompactRational* cr);
+
+/**
+ * Hash of a value's encoding (whole field and the tuples up to the end
+ * flag)
+ * Cheaper than cr_hash, but equal values only hash equal when they are
+ * encoded the same way: use it for columns known canonical, such as the
+ * output of cr_encode_optimal, which is a function of the value.
+ */
+uint64_t cr_hash_bits(const CompactRational* cr);
+
+// cr_count_map_init flags
+#define CR_COUNT_CANONICAL 0x1        // Keys are compared and hashed by encoding (cr_hash_bits)
+
+/**
+ * One slot of a CRCountMap
+ * state is 0 while empty, 1 while the thread that claimed it writes the
+ * key, and 2 once the key can be read.
+ */
+typedef struct {
+    uint64_t hash;                    // Hash of key
+    uint32_t state;                   // 0 = empty, 1 = key being written, 2 = ready
+    CompactRational key;              // First encoding counted for the value
+    uint64_t count;
+} CRCountSlot;
+
+/**
+ * Concurrent count map keyed on values
+ * A fixed open-addressing table with linear probing: threads claim empty
+ * slots with a compare-and-swap and bump counts with atomic adds, with no
+ * locks. The table does not grow; size it for the distinct values
+ * expected.
+ */
+typedef struct {
+    CRCountSlot* slots;
+    size_t mask;                      // Slot count - 1
+    uint32_t flags;                   // CR_COUNT_* flags
+    size_t size;                      // Distinct values counted
+} CRCountMap;
+
+/**
+ * Initialize an empty count map
+ *
+ * @param map The map
+ * @param capacity Distinct values it must hold (the table is at least
+ *        twice as large, rounded up to a power of two)
+ * @param flags CR_COUNT_* flags
+ * @param error Optional error output (CR_ERROR_OUT_OF_MEMORY)
+ * @return true on success
+ */
+bool cr_count_map_init(CRCountMap* map, size_t capacity, uint32_t flags, CRError* error);
+
+/**
+ * Release a count map's table (no other thread may be using it)
+ */
+void cr_count_map_free(CRCountMap* map);
+
+/**
+ * Add n to the count of a value; safe from many threads at once
+ *
+ * @param map The map
+ * @param cr Value to count
+ * @param n Amount to add
+ * @param error Optional error output: CR_ERROR_OUT_OF_BOUNDS if the value
+ *        is new and every slot is taken
+ * @return true on success
+ */
+bool cr_count_map_add(CRCountMap* map, const CompactRational* cr, uint64_t n, CRError* error);
+
+/**
+ * Count of a value (0 if it was never added)
+ */
+uint64_t cr_count_map_get(const CRCountMap* map, const CompactRational* cr);
+
+/**
+ * Copy out the distinct values and their counts, in table order
+ *
+ * @param map The map
+ * @param keys Output keys (room for max), or NULL
+ * @param counts Output counts (room for max), or NULL
+ * @param max Entries to copy at most
+ * @return Number of entries copied
+ */
+size_t cr_count_map_entries(const CRCountMap* map, CompactRational* keys, uint64_t* counts, size_t max);
+
+/**
+ * Count every value of a packed column into a map, on several threads
+ * Each thread decodes its slice in blocks and folds repeats into a small
+ * private table first, so frequent values cost one shared atomic add per
+ * flush rather than one per row.
+ *
+ * @param map The map (counted into; may already hold counts)
+ * @param pa The packed column
+ * @param threads Thread count (0 or negative = one per online CPU); small
+ *        columns use fewer threads
+ * @param error Optional error output: CR_ERROR_OUT_OF_BOUNDS if the map
+ *        filled up, or a malformed value (counts are then incomplete)
+ * @return true if every value was counted
+ */
+bool cr_count_packed(CRCountMap* map, const CRPackedArray* pa, int threads, CRError* error);
+
+// ============================================================================
+// TEXT INPUT AND OUTPUT
+// ============================================================================
+
+/**
+ * Parse one value from text
+ * Accepts integers ("7", "-12"), fractions ("22/3"), mixed numbers
+ * ("7 1/3", "-7 1/3" meaning -(7 + 1/3), as cr_format writes them) and
+ * decimals ("0.5", "-.25"). Leading blanks are skipped; each digit run may
+ * have at most 18 digits. The value is encoded exactly as
+ * cr_encode_optimal would (decimals other than short binary or quinary
+ * fractions may be CR_ERROR_INEXACT).
+ *
+ * @param text Input characters (need not be NUL-terminated)
+ * @param len Characters available
+ * @param out Output value (zero on a syntax error)
+ * @param error Optional error output: CR_ERROR_SYNTAX if no number starts
+ *        the text, or the encoding outcome
+ * @return Characters consumed, 0 on a syntax error
+ */
+size_t cr_parse(const char* text, size_t len, CompactRational* out, CRError* error);
+
+/**
+ * Parse a stream of delimited fields into a caller-provided array
+ * Fields end at the delimiter or a line break (LF, CR or CR LF) and may be
+ * padded with blanks; blank lines are skipped, an empty field before a
+ * delimiter is a syntax error. Short integer fields take a SWAR path that
+ * reads eight bytes at a time. No memory is allocated.
+ *
+ * For streaming, pass final = false while more text will follow: a last
+ * field without its separator is then left unparsed, and *consumed tells
+ * where the next buffer should resume. Pass final = true for the end of
+ * the input.
+ *
+ * @param text Input characters
+ * @param len Characters available
+ * @param delimiter Field separator (',' or '\t', say; not a blank)
+ * @param final Whether text ends the input
+ * @param out Output values
+ * @param max Room in out
+ * @param consumed Optional output: characters fully processed
+ * @param error Optional error output, set once for the call: CR_ERROR_SYNTAX
+ *        (value1 = field index, value2 = byte offset) stops parsing; else
+ *        the first clamped or inexact value, or CR_SUCCESS
+ * @return Number of values written
+ */
+size_t cr_parse_array(const char* text, size_t len, char delimiter, bool final,
+                      CompactRational* out, size_t max, size_t* consumed, CRError* error);
+
+/**
+ * Parse a stream of delimited fields straight into a packed array
+ * Same rules as cr_parse_array; values are staged in a small stack buffer
+ * and appended in chunks.
+ *
+ * @return false on a syntax error or if the packed array could not grow
+ */
+bool cr_parse_packed(const char* text, size_t len, char delimiter, bool final,
+                     CRPackedArray* out, size_t* consumed, CRError* error);
+
+/**
+ * Format a value into a buffer, with no stdio
+ * By default writes "7", "-1/3" or "7 1/3" from the reduced value, which
+ * cr_parse reads back exactly; see the CR_FORMAT_* flags for the other
+ * forms. Decimals are rounded from the exact value, not through double.
+ * Like snprintf the output is truncated to cap - 1 characters and
+ * NUL-terminated.
+ *
+ * @param buf Output buffer
+ * @param cap Size of buf (CR_FORMAT_MAX always suffices)
+ * @param cr Value to format
+ * @param flags CR_FORMAT_* bits
+ * @return Length of the full text, excluding the NUL
+ */
+size_t cr_format(char* buf, size_t cap, const CompactRational* cr, uint32_t flags);
+
+/**
+ * Format a column into one contiguous buffer
+ * Each value is written as cr_format would, followed by separator. A value
+ * that does not fit completely (with its separator) is not started, so a
+ * report writer can flush buf and continue from the returned index. No NUL
+ * is written.
+ *
+ * @param buf Output buffer
+ * @param cap Size of buf
+ * @param values Values to format
+ * @param n Number of values
+ * @param separator Character written after each value ('\n', say)
+ * @param flags CR_FORMAT_* bits
+ * @param written Optional output: bytes written
+ * @return Number of values written
+ */
+size_t cr_format_array(char* buf, size_t cap, const CompactRational* values, size_t n,
+                       char separator, uint32_t flags, size_t* written);
+
+// ============================================================================
+// WIDE WHOLE PARTS
+// ============================================================================
+
+/**
+ * The 16-bit type under its width-qualified name
+ * Columns, packed arrays and files keep using it: an integer still costs
+ * 2 bytes there.
+ */
+typedef CompactRational CompactRational16;
+
+/**
+ * Declare the compact rational type with a BITS-wide whole field
+ * CompactRational<BITS> has the CompactRational layout scaled up: the top
+ * bit of whole is the tuple flag, the rest a signed whole part (to
+ * CR<BITS>_MAX_WHOLE_VALUE), and the tuples are encoded exactly as in the
+ * 16-bit type. The generated functions mirror the 16-bit ones; errors are
+ * reported the same way, with context values saturated to int32_t.
+ *
+ * - cr<BITS>_init: set to zero
+ * - cr<BITS>_from_int: clamp to the wider range
+ * - cr<BITS>_from_fraction: exact as cr_encode_optimal (the denominator
+ *   may go up to 2^63); CR_ERROR_INEXACT if it needs more than MAX_TUPLES
+ * - cr<BITS>_from_cr: widen a CompactRational, always exact
+ * - cr<BITS>_to_cr: narrow, clamping the whole part (CR_OP_NARROW)
+ * - cr<BITS>_to_double, cr<BITS>_add, cr<BITS>_sub, cr<BITS>_neg,
+ *   cr<BITS>_cmp and cr<BITS>_format: as the cr_ functions. Arithmetic
+ *   adds the whole parts in 128 bits and the tuples with cr_add, so the
+ *   result only clamps outside the wider range.
+ */
+#define CR_DECLARE_WIDE_TYPE(BITS, WHOLE_T)                                                          \
+    typedef struct {                                                                                 \
+        WHOLE_T whole;                /* Top bit: tuple flag, rest: signed whole part */              \
+        uint16_t tuples[MAX_TUPLES];  /* Same encoding as CompactRational */                         \
+    } CompactRational##BITS;                                                                         \
+                                                                                                     \
+    void cr##BITS##_init(CompactRational##BITS* cr);                                                 \
+    CompactRational##BITS cr##BITS##_from_int(int64_t value, CRError* error);                        \
+    CompactRational##BITS cr##BITS##_from_fraction(int64_t num, int64_t denom, CRError* error);      \
+    CompactRational##BITS cr##BITS##_from_cr(const CompactRational* cr);                             \
+    CompactRational cr##BITS##_to_cr(const CompactRational##BITS* cr, CRError* error);               \
+    double cr##BITS##_to_double(const CompactRational##BITS* cr, CRError* error);                    \
+    CompactRational##BITS cr##BITS##_add(const CompactRational##BITS* a, const CompactRational##BITS* b, \
+                                         CRError* error);                                            \
+    CompactRational##BITS cr##BITS##_sub(const CompactRational##BITS* a, const CompactRational##BITS* b, \
+                                         CRError* error);                                            \
+    CompactRational##BITS cr##BITS##_neg(const CompactRational##BITS* a, CRError* error);            \
+    int cr##BITS##_cmp(const CompactRational##BITS* a, const CompactRational##BITS* b);              \
+    size_t cr##BITS##_format(char* buf, size_t cap, const CompactRational##BITS* cr, uint32_t flags);
+
+CR_DECLARE_WIDE_TYPE(32, int32_t)
+CR_DECLARE_WIDE_TYPE(64, int64_t)
+
+/**
+ * Sum a column into a 64-bit whole part
+ * cr_sum_parallel without the final clamp: totals up to
+ * CR64_MAX_WHOLE_VALUE stay exact.
+ *
+ * @param values Input array
+ * @param n Number of values
+ * @param threads Thread count, as for cr_sum_parallel
+ * @param error Optional error output (CR_ERROR_TUPLE_BOUNDS as for
+ *        cr_sum_parallel)
+ * @return The canonical sum
+ */
+CompactRational64 cr64_sum_parallel(const CompactRational* values, size_t n, int threads, CRError* error);
+
+// ============================================================================
+// ACCUMULATOR
+// ============================================================================
+
+/**
+ * Exact running sum of compact rationals
+ * A 64-bit whole part and one numerator counter per denominator offset:
+ * adding a value adds its whole part and each tuple's numerator to its
+ * offset's counter, with no gcd, carry or re-encode, so a fold of cr_add
+ * calls that re-encodes (and may approximate) at every step becomes a
+ * handful of integer adds per value. Reduction happens once, in
+ * cr_acc_finish. The counters hold ~1.4e16 values before they can wrap.
+ */
+typedef struct {
+    int64_t whole;                    // Sum of whole parts
+    uint64_t numerators[MAX_DENOMINATOR - MIN_DENOMINATOR + 1];  // Sum of numerators per offset
+} CRAccumulator;
+
+/**
+ * Reset an accumulator to zero
+ */
+void cr_acc_init(CRAccumulator* acc);
+
+/**
+ * Add one value, in O(MAX_TUPLES) integer adds
+ * Tuples are walked as cr_to_rational walks them: up to the end flag or
+ * MAX_TUPLES.
+ */
+static inline void cr_acc_add(CRAccumulator* acc, const CompactRational* cr) {
+    acc->whole += (int16_t)((uint16_t)cr->whole << 1) >> 1;
+    if (!(cr->whole & 0x8000)) {
+        return;
+    }
+    for (int t = 0; t < MAX_TUPLES; t++) {
+        uint16_t tuple = cr->tuples[t];
+        acc->numerators[tuple & 0x7F] += tuple >> 8;
+        if (tuple & 0x80) {
+            break;
+        }
+    }
+}
+
+/**
+ * Add an array of values
+ */
+void cr_acc_add_array(CRAccumulator* acc, const CompactRational* values, size_t n);
+
+/**
+ * Fold another accumulator (a partial group, another thread's) into acc
+ */
+void cr_acc_merge(CRAccumulator* acc, const CRAccumulator* other);
+
+/**
+ * Canonical value of the sum so far
+ * The accumulator is left unchanged, so adding can continue.
+ *
+ * @param acc The accumulator
+ * @param error Optional error output: CR_ERROR_VALUE_CLAMPED if the whole
+ *        part is out of range, CR_ERROR_TUPLE_BOUNDS if the exact sum needs
+ *        more than MAX_TUPLES tuples (the tail is then approximated), as for
+ *        cr_sum_parallel
+ * @return The canonical sum
+ */
+CompactRational cr_acc_finish(const CRAccumulator* acc, CRError* error);
+
+/**
+ * cr_acc_finish with a 64-bit whole part: no clamp below
+ * CR64_MAX_WHOLE_VALUE
+ */
+CompactRational64 cr_acc_finish64(const CRAccumulator* acc, CRError* error);
+
+// ============================================================================
+// 16-BIT LANES
+// ============================================================================
+
+/**
+ * A value's whole word, passed by value
+ * The bits of CompactRational.whole: with bit 15 clear the lane is the
+ * integer in bits 14-0 and needs nothing else; with bit 15 set ("tagged")
+ * the value has tuples and bits 14-0 hold only its whole part w, a lower
+ * bound: the encoders may move tuple excess out of the whole part, and
+ * every tuple they write is below 1, so the value lies in
+ * [w, w + MAX_TUPLES), not necessarily in [w, w + 1). Integer-mostly
+ * data can run in lanes, in registers and in loops the compiler
+ * vectorizes, and promote the tagged lanes to full values when it needs
+ * them. Lane operations are branchless and saturate at the whole-part
+ * range without reporting; the array functions report clamps.
+ */
+typedef uint16_t cr16_t;
+
+// Tag bit of a lane: the value has tuples
+#define CR16_TAG 0x8000u
+
+/**
+ * Lane for an integer, saturated to MIN_WHOLE_VALUE..MAX_WHOLE_VALUE
+ */
+static inline cr16_t cr16_from_int(int32_t value) {
+    value = value < MIN_WHOLE_VALUE ? MIN_WHOLE_VALUE : value;
+    value = value > MAX_WHOLE_VALUE ? MAX_WHOLE_VALUE : value;
+    return (cr16_t)(value & 0x7FFF);
+}
+
+/**
+ * Lane of a full value: its whole word, tagged if it has tuples
+ */
+static inline cr16_t cr16_from_cr(const CompactRational* cr) {
+    return (cr16_t)cr->whole;
+}
+
+/**
+ * Whether a lane is an integer on its own
+ */
+static inline bool cr16_is_integer(cr16_t lane) {
+    return (lane & CR16_TAG) == 0;
+}
+
+/**
+ * Integer of a lane; for a tagged lane the whole part, a lower bound on
+ * the value (which is below it + MAX_TUPLES)
+ */
+static inline int32_t cr16_whole(cr16_t lane) {
+    return (int16_t)(uint16_t)(lane << 1) >> 1;
+}
+
+/**
+ * Saturating sum of two lanes
+ * Exact when both are integers. Otherwise the result is tagged and holds
+ * the sum s of the whole parts, still a lower bound: a + b lies in
+ * [s, s + MAX_TUPLES) with one tagged operand and [s, s + 2 * MAX_TUPLES)
+ * with two. Add the full values with cr_add.
+ */
+static inline cr16_t cr16_add(cr16_t a, cr16_t b) {
+    return (cr16_t)(cr16_from_int(cr16_whole(a) + cr16_whole(b)) | ((a | b) & CR16_TAG));
+}
+
+/**
+ * Saturating difference of two lanes (see cr16_add)
+ * A tagged result holds the difference d of the whole parts, which
+ * bounds nothing from below when b is tagged: a - b lies in
+ * (d - MAX_TUPLES, d + MAX_TUPLES) in general.
+ */
+static inline cr16_t cr16_sub(cr16_t a, cr16_t b) {
+    return (cr16_t)(cr16_from_int(cr16_whole(a) - cr16_whole(b)) | ((a | b) & CR16_TAG));
+}
+
+/**
+ * Promote an integer lane to a full value
+ * A tagged lane promotes to its whole part (a lower bound, not the
+ * floor); its tuples live in the full value it came from.
+ */
+static inline CompactRational cr16_to_cr(cr16_t lane) {
+    CompactRational cr = {(int16_t)(lane & 0x7FFF), {0}};
+    return cr;
+}
+
+/**
+ * Take the lanes of an array of full values
+ *
+ * @param values Input array
+ * @param n Number of values
+ * @param lanes Output array of n lanes
+ * @return Number of tagged lanes (values with tuples)
+ */
+size_t cr16_from_array(const CompactRational* values, size_t n, cr16_t* lanes);
+
+/**
+ * Saturating element-wise sum of lane arrays (see cr16_add)
+ *
+ * @param a First operands
+ * @param b Second operands
+ * @param out Output array of n lanes (may alias a or b)
+ * @param n Number of lanes
+ * @param error Optional error output (CR_ERROR_VALUE_CLAMPED with the
+ *        first saturated sum)
+ * @return Number of tagged results, to redo with cr_add
+ */
+size_t cr16_add_array(const cr16_t* a, const cr16_t* b, cr16_t* out, size_t n, CRError* error);
+
+/**
+ * Sum of the integers of an array of lanes, never clamped
+ *
+ * @param lanes Input array
+ * @param n Number of lanes
+ * @param tagged Optional output: number of tagged lanes, which contribute
+ *        only their whole part, so the true total lies in
+ *        [sum, sum + MAX_TUPLES * tagged)
+ * @return Sum of cr16_whole over the lanes
+ */
+int64_t cr16_sum(const cr16_t* lanes, size_t n, size_t* tagged);
+
+// ============================================================================
+// COLUMNAR STORAGE
+// ============================================================================
+
+// Distinct tuple sequences a CRColumn can hold (pattern numbers are 16-bit)
+#define CR_COLUMN_MAX_PATTERNS 65536
+
+/**
+ * Column of values split into whole words and a fraction dictionary
+ *
+ * Every row keeps its whole word, as a cr16_t lane, in one dense array:
+ * scans over the integer part read 2 bytes per row and nothing else.
+ * Rows with tuples (tagged lanes) also have a 16-bit pattern number, in row
+ * order, into a dictionary of the distinct tuple sequences, so a column
+ * whose fractions repeat costs 2 bytes per integer and 4 per fraction
+ * however many tuples it has. The rank index counts tagged rows at every
+ * CR_PACKED_INDEX_STRIDE-th row for random access.
+ */
+typedef struct {
+    cr16_t* wholes;                   // Whole word of every row
+    size_t count;                     // Number of rows
+    size_t capacity;                  // Rows allocated
+    uint16_t* refs;                   // Pattern number of each tagged row
+    size_t tagged;                    // Number of tagged rows
+    size_t refs_capacity;             // Pattern numbers allocated
+    uint64_t* rank;                   // Tagged rows before row i * CR_PACKED_INDEX_STRIDE
+    size_t rank_capacity;             // Rank entries allocated
+    uint16_t* patterns;               // MAX_TUPLES tuples per distinct sequence
+    size_t pattern_count;             // Distinct sequences
+    size_t pattern_capacity;          // Sequences allocated
+    uint32_t* slots;                  // Pattern hash table: pattern number + 1, 0 = empty
+    size_t slot_count;                // Power of two, at most half full
+} CRColumn;
+
+/**
+ * Initialize an empty column
+ */
+void cr_column_init(CRColumn* col);
+
+/**
+ * Release storage and reset to empty
+ */
+void cr_column_free(CRColumn* col);
+
+/**
+ * Append one value
+ * Tuples are stored as cr_pack stores them, so a value reads back bit for
+ * bit as cr_unpack would return it.
+ *
+ * @param col Target column
+ * @param cr Value to append
+ * @param error Optional error output (CR_ERROR_OUT_OF_MEMORY, or
+ *        CR_ERROR_OUT_OF_BOUNDS when a new pattern would exceed
+ *        CR_COLUMN_MAX_PATTERNS)
+ * @return true on success; on failure the column is unchanged
+ */
+bool cr_column_append(CRColumn* col, const CompactRational* cr, CRError* error);
+
+/**
+ * Append an array of values, sizing row storage once
+ *
+ * @return Number of values appended (n unless an error stopped it)
+ */
+size_t cr_column_append_array(CRColumn* col, const CompactRational* values, size_t n, CRError* error);
+
+/**
+ * Random access: one rank lookup and a scan of at most
+ * CR_PACKED_INDEX_STRIDE tag bits
+ *
+ * @param error Optional error output (CR_ERROR_OUT_OF_BOUNDS)
+ */
+CompactRational cr_column_get(const CRColumn* col, size_t i, CRError* error);
+
+/**
+ * Decode a contiguous range after a single rank lookup
+ *
+ * @param col Source column
+ * @param start First row
+ * @param n Rows wanted (fewer are decoded at the end of the column)
+ * @param out Output array
+ * @param error Optional error output (CR_ERROR_OUT_OF_BOUNDS if start is past the end)
+ * @return Number of rows decoded
+ */
+size_t cr_column_unpack(const CRColumn* col, size_t start, size_t n, CompactRational* out, CRError* error);
+
+/**
+ * Bytes in use: lanes, pattern numbers, rank index and dictionary
+ * (hash table excluded, as it only serves appends)
+ */
+size_t cr_column_footprint(const CRColumn* col);
+
+/**
+ * The dense lane array of a column, for scans such as cr16_sum
+ */
+static inline const cr16_t* cr_column_wholes(const CRColumn* col) {
+    return col->wholes;
+}
+
+// ============================================================================
+// DELTA CODEC
+// ============================================================================
+
+// Values per delta codec block
+#define CR_DELTA_BLOCK 128
+
+/**
+ * Delta/RLE stream encoder
+ *
+ * The stream is a sequence of blocks of up to CR_DELTA_BLOCK values:
+ *
+ *   count - 1 | bit width b | runs - 1 | 0 | deltas | runs
+ *
+ * Whole parts are stored as zigzag deltas from the previous value (the
+ * first value of the stream from 0), bit-packed at the block's widest b
+ * in four interleaved 32-bit lanes (value i in lane i % 4, 16 * b bytes
+ * per block), so the decoder unpacks the lanes side by side. Tuple
+ * sequences are run-length encoded: each run is its length - 1, its
+ * tuple count and the little-endian tuples, and integers are runs of
+ * zero tuples. Tuples are stored as cr_pack stores them, so values decode
+ * bit for bit as cr_unpack returns them. An integer column with steady
+ * steps costs a few bits per value.
+ */
+typedef struct {
+    uint8_t* data;                    // Encoded stream
+    size_t size;                      // Bytes in use
+    size_t capacity;                  // Bytes allocated
+    size_t count;                     // Values encoded, including pending ones
+    CompactRational pending[CR_DELTA_BLOCK];  // Values of the block being filled
+    size_t pending_count;
+    int32_t last_whole;               // Whole part of the last value flushed
+} CRDeltaEncoder;
+
+/**
+ * Streaming decoder over an encoded delta stream (borrowed, not copied)
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;                       // Next block
+    int32_t last_whole;               // Whole part of the last value decoded
+    CompactRational block[CR_DELTA_BLOCK];  // Decoded values of the current block
+    size_t block_len;
+    size_t block_pos;                 // Next value of block to return
+} CRDeltaDecoder;
+
+/**
+ * Initialize an empty encoder
+ */
+void cr_delta_encoder_init(CRDeltaEncoder* enc);
+
+/**
+ * Release an encoder's stream and reset it to empty
+ */
+void cr_delta_encoder_free(CRDeltaEncoder* enc);
+
+/**
+ * Append values, encoding each block as it fills
+ *
+ * @param enc The encoder
+ * @param values Values to append
+ * @param n Number of values
+ * @param error Optional error output (CR_ERROR_OUT_OF_MEMORY)
+ * @return true on success
+ */
+bool cr_delta_encode(CRDeltaEncoder* enc, const CompactRational* values, size_t n, CRError* error);
+
+/**
+ * Encode the partly filled last block
+ * enc->data then holds the complete stream; more values may still be
+ * appended, starting a new block.
+ *
+ * @param enc The encoder
+ * @param error Optional error output (CR_ERROR_OUT_OF_MEMORY)
+ * @return true on success
+ */
+bool cr_delta_encoder_flush(CRDeltaEncoder* enc, CRError* error);
+
+/**
+ * Start decoding a stream
+ */
+void cr_delta_decoder_init(CRDeltaDecoder* dec, const uint8_t* data, size_t size);
+
+/**
+ * Decode up to n values
+ *
+ * @param dec The decoder
+ * @param out Output array
+ * @param n Values wanted
+ * @param error Optional error output (CR_ERROR_INVALID_ENCODING with the
+ *        stream offset of a malformed block)
+ * @return Number of values decoded; fewer than n at the end of the stream
+ */
+size_t cr_delta_decode(CRDeltaDecoder* dec, CompactRational* out, size_t n, CRError* error);
+
+// ============================================================================
+// WIRE FORMAT VIEWS
+// ============================================================================
+
+/**
+ * Iterator over a packed byte stream in a borrowed buffer
+ *
+ * The stream is the wire format of SPECIFICATION.md: values back to back
+ * in their 2+2n byte form, whole and tuples little-endian, no header and
+ * no padding, exactly as cr_pack and CRPackedArray store them. Values are
+ * decoded from the bytes where they lie (a receive buffer, a mapped file)
+ * on hosts of either byte order; nothing is copied or indexed first.
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;                       // Byte offset of the next value
+    size_t count;                     // Values read so far
+} CRView;
+
+/**
+ * Start a view over size bytes of data
+ */
+void cr_view_init(CRView* v, const uint8_t* data, size_t size);
+
+/**
+ * Decode the next value
+ * Returns false at the end of the data. A value cut off by the end of the
+ * buffer is not an error: it is left unread, and cr_view_remaining() says
+ * how many bytes to carry over in front of the next receive.
+ *
+ * @param v The view
+ * @param out Output value (unused tuples are zeroed)
+ * @param error Optional error output: CR_ERROR_INVALID_ENCODING with the
+ *        value's index and byte offset if no end flag appears within
+ *        MAX_TUPLES (the view then stays on it)
+ * @return true if a value was decoded
+ */
+bool cr_view_next(CRView* v, CompactRational* out, CRError* error);
+
+/**
+ * Decode up to max values, stopping early as cr_view_next does
+ *
+ * @return Number of values decoded
+ */
+size_t cr_view_read(CRView* v, CompactRational* out, size_t max, CRError* error);
+
+/**
+ * Step over up to n values without decoding them
+ *
+ * @return Number of values skipped
+ */
+size_t cr_view_skip(CRView* v, size_t n, CRError* error);
+
+/**
+ * Add up to n values to an accumulator straight from the bytes
+ * Decodes neither into structs nor through cr_to_rational; a group total
+ * over a received batch costs a few integer adds per value.
+ *
+ * @return Number of values added
+ */
+size_t cr_view_accumulate(CRView* v, size_t n, CRAccumulator* acc, CRError* error);
+
+/**
+ * Bytes not yet read, including a cut-off value at the end
+ */
+size_t cr_view_remaining(const CRView* v);
+
+/**
+ * Write values into a send buffer in the wire format
+ * A value that does not fit completely is not started, so a sender can
+ * flush buf and continue from the returned index.
+ *
+ * @param buf Output buffer
+ * @param cap Size of buf
+ * @param values Values to write
+ * @param n Number of values
+ * @param written Optional output: bytes written
+ * @return Number of values written
+ */
+size_t cr_write_values(uint8_t* buf, size_t cap, const CompactRational* values, size_t n, size_t* written);
+
+/**
+ * Gather values from scattered locations (records, free lists, hash map
+ * slots) into one send buffer, as cr_write_values does
+ *
+ * @param values Pointers to the values to write
+ */
+size_t cr_write_gather(uint8_t* buf, size_t cap, const CompactRational* const* values, size_t n, size_t* written);
+
+/**
+ * Copy a range of a packed array into a send buffer
+ * The packed stream already is the wire format: one index seek, a scan of
+ * the value lengths and a single memcpy.
+ *
+ * @param buf Output buffer
+ * @param cap Size of buf
+ * @param pa The packed array
+ * @param start First value
+ * @param n Values wanted (fewer if the range ends or buf fills)
+ * @param written Optional output: bytes written
+ * @return Number of values written
+ */
+size_t cr_write_packed(uint8_t* buf, size_t cap, const CRPackedArray* pa, size_t start, size_t n, size_t* written);
+
+// ============================================================================
+// INLINE FAST PATHS
+// ============================================================================
+
+/**
+ * With CR_INLINE=1 a program's calls to cr_init, cr_size, cr_from_int and
+ * cr_to_rational compile to the definitions below, so the common cases
+ * (an in-range integer with no CRError, a value without tuples) need no
+ * call into the library; every other case calls the library function, so
+ * results, reports and thread flags are the same either way. The library
+ * itself is built without the macros (compact_rational_internal.h sets
+ * CR_BUILDING_LIBRARY). Stats builds keep the plain calls so every
+ * cr_to_rational is counted.
+ */
+#if CR_INLINE && !CR_ENABLE_STATS && !defined(CR_BUILDING_LIBRARY)
+
+static inline void cr_inline_init(CompactRational* cr) {
+    CompactRational zero = {0, {0}};
+    *cr = zero;
+}
+
+static inline size_t cr_inline_size(const CompactRational* cr) {
+    size_t size = 2;
+    if (cr->whole & 0x8000) {
+        for (int i = 0; i < MAX_TUPLES; i++) {
+            size += 2;
+            if (cr->tuples[i] & 0x80) {
+                break;
+            }
+        }
+    }
+    return size;
+}
+
+static inline CompactRational cr_inline_from_int(int32_t value, CRError* error) {
+    if (error == NULL && value >= MIN_WHOLE_VALUE && value <= MAX_WHOLE_VALUE) {
+        CompactRational cr = {(int16_t)(value & 0x7FFF), {0}};
+        return cr;
+    }
+    return (cr_from_int)(value, error);
+}
+
+static inline Rational cr_inline_to_rational(const CompactRational* cr) {
+    if (!(cr->whole & 0x8000)) {
+        Rational r = {(int16_t)((uint16_t)cr->whole << 1) >> 1, 1};
+        return r;
+    }
+    return (cr_to_rational)(cr);
+}
+
+#define cr_init(cr) cr_inline_init(cr)
+#define cr_size(cr) cr_inline_size(cr)
+#define cr_from_int(value, error) cr_inline_from_int(value, error)
+#define cr_to_rational(cr) cr_inline_to_rational(cr)
+
+#endif
+
 #endif // COMPACT_RATIONAL_H
@@ -0,0 +1,402 @@
+#include "compact_rational_internal.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Relative margin on the shared double bound: pruning only ever drops
+// subtrees strictly worse than a candidate already found
+#define CR_APPROX_SLACK 1e-12
+
+// Plain recursion below this budget; the thread start-up costs more
+#define CR_APPROX_MIN_PARALLEL_TUPLES 3
+
+// ============================================================================
+// SEARCH STATE
+// ============================================================================
+
+/**
+ * The target's fraction p/q (0 <= p < q <= 2^63) and the best error found
+ * by any thread (for pruning only). Tasks are first denominators, handed
+ * out from MAX_DENOMINATOR down.
+ */
+typedef struct {
+    uint64_t p;
+    uint64_t q;
+    int max_tuples;
+    int next_task;
+    uint64_t shared_error;    // Bits of a nonnegative double, which order as integers
+} ApproxSearch;
+
+/**
+ * Best candidate of one thread: the value num/lcm, at distance dist/(q * lcm)
+ */
+typedef struct {
+    uint64_t dist;
+    uint64_t lcm;
+    uint64_t num;
+} ApproxCandidate;
+
+typedef struct {
+    ApproxSearch* search;
+    ApproxCandidate best;
+} ApproxWorker;
+
+// Order on candidates: smaller error, then smaller value
+static bool candidate_better(const ApproxCandidate* a, const ApproxCandidate* b) {
+    unsigned __int128 ea = (unsigned __int128)a->dist * b->lcm;
+    unsigned __int128 eb = (unsigned __int128)b->dist * a->lcm;
+    if (ea != eb) return ea < eb;
+    return (unsigned __int128)a->num * b->lcm < (unsigned __int128)b->num * a->lcm;
+}
+
+static uint64_t error_bits(double e) {
+    uint64_t bits;
+    memcpy(&bits, &e, sizeof(bits));
+    return bits;
+}
+
+static double shared_error(ApproxSearch* s) {
+    uint64_t bits = __atomic_load_n(&s->shared_error, __ATOMIC_RELAXED);
+    double e;
+    memcpy(&e, &bits, sizeof(e));
+    return e;
+}
+
+// Lower the shared error to e unless another thread got lower first
+static void share_error(ApproxSearch* s, double e) {
+    uint64_t bits = error_bits(e);
+    uint64_t seen = __atomic_load_n(&s->shared_error, __ATOMIC_RELAXED);
+    while (bits < seen && !__atomic_compare_exchange_n(&s->shared_error, &seen, bits, true,
+                                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static uint64_t gcd_u64(uint64_t a, uint64_t b) {
+    while (b != 0) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * Round p/q to a multiple of 1/lcm, given the residue r = p * lcm mod q
+ * Exact halves round down, keeping the smaller value.
+ */
+static void consider(ApproxWorker* w, uint64_t lcm, uint64_t r) {
+    const ApproxSearch* s = w->search;
+    bool up = s->q - r < r;
+    ApproxCandidate c;
+    c.dist = up ? s->q - r : r;
+    c.lcm = lcm;
+
+    // Cheap reject before forming the numerator
+    unsigned __int128 ec = (unsigned __int128)c.dist * w->best.lcm;
+    unsigned __int128 eb = (unsigned __int128)w->best.dist * lcm;
+    if (ec > eb) return;
+
+    c.num = (uint64_t)(((unsigned __int128)s->p * lcm - r) / s->q) + (up ? 1 : 0);
+    if (!candidate_better(&c, &w->best)) return;
+    w->best = c;
+    share_error(w->search, (double)c.dist / ((double)s->q * (double)lcm));
+}
+
+// ============================================================================
+// CONTINUED-FRACTION BOUND
+// ============================================================================
+
+/**
+ * Smallest |r/q - j/m| over integers j and 1 <= m <= limit
+ * The closest fraction with a bounded denominator is the last convergent
+ * of r/q within the limit or the largest semiconvergent after it, so one
+ * run of Euclid's algorithm settles it exactly. Returns the distance as
+ * a double.
+ */
+static double best_distance(uint64_t r, uint64_t q, uint64_t limit) {
+    uint64_t h2 = 0, k2 = 1;  // Convergent before last
+    uint64_t h1 = 1, k1 = 0;  // Last convergent
+    uint64_t n = r, d = q;
+    uint64_t hs = 0, ks = 0;  // Semiconvergent, if the limit cuts a step short
+
+    for (;;) {
+        uint64_t a = n / d;
+        uint64_t room = k1 != 0 ? (limit - k2) / k1 : UINT64_MAX;
+        if (a > room) {
+            hs = h2 + room * h1;
+            ks = k2 + room * k1;
+            break;
+        }
+        uint64_t h = a * h1 + h2, k = a * k1 + k2;
+        h2 = h1;
+        k2 = k1;
+        h1 = h;
+        k1 = k;
+        uint64_t t = n - a * d;
+        if (t == 0) return 0.0;  // r/q itself is within the limit
+        n = d;
+        d = t;
+    }
+
+    __int128 e1 = (__int128)r * k1 - (__int128)h1 * q;
+    double best = (double)(e1 < 0 ? -e1 : e1) / ((double)q * (double)k1);
+    if (ks != 0) {
+        __int128 es = (__int128)r * ks - (__int128)hs * q;
+        double semi = (double)(es < 0 ? -es : es) / ((double)q * (double)ks);
+        if (semi < best) best = semi;
+    }
+    return best;
+}
+
+/**
+ * Whether no extension of a set can beat the best error found
+ * Adding denominators multiplies lcm by some m <= limit, and the rounded
+ * target then misses by min |r/q - j/m| / lcm.
+ */
+static bool prune(ApproxWorker* w, uint64_t lcm, uint64_t r, uint64_t limit) {
+    double found = shared_error(w->search);
+    if (found == 0.0) return true;  // Exact: nothing can differ from it
+    double bound = best_distance(r, w->search->q, limit) / (double)lcm;
+    return bound > found * (1.0 + CR_APPROX_SLACK);
+}
+
+// ============================================================================
+// DENOMINATOR SET SEARCH
+// ============================================================================
+
+/**
+ * Visit the set whose smallest denominator is last and whose lcm is lcm
+ * (residue r), then its extensions by smaller denominators. A denominator
+ * dividing the lcm adds nothing, and its extensions repeat smaller sets.
+ */
+static void search_set(ApproxWorker* w, uint64_t lcm, uint64_t r, int last, int depth) {
+    const ApproxSearch* s = w->search;
+    consider(w, lcm, r);
+
+    int remaining = s->max_tuples - depth;
+    if (remaining > last - MIN_DENOMINATOR) remaining = last - MIN_DENOMINATOR;
+    if (remaining <= 0) return;
+
+    uint64_t limit = 1;
+    for (int i = 1; i <= remaining; i++) {
+        limit *= (uint64_t)(last - i);
+    }
+    if (prune(w, lcm, r, limit)) return;
+
+    for (int d = last - 1; d >= MIN_DENOMINATOR; d--) {
+        uint64_t g = gcd_u64((uint64_t)d, lcm % (uint64_t)d);
+        if (g == (uint64_t)d) continue;
+        uint64_t m = (uint64_t)d / g;
+        search_set(w, lcm * m, (uint64_t)((unsigned __int128)r * m % s->q), d, depth + 1);
+    }
+}
+
+// Search the sets led by each first denominator still unclaimed
+static void* approx_worker(void* arg) {
+    ApproxWorker* w = (ApproxWorker*)arg;
+    ApproxSearch* s = w->search;
+    for (;;) {
+        int task = __atomic_fetch_add(&s->next_task, 1, __ATOMIC_RELAXED);
+        int d = MAX_DENOMINATOR - task;
+        if (d < MIN_DENOMINATOR) break;
+        search_set(w, (uint64_t)d, (uint64_t)((unsigned __int128)s->p * (uint64_t)d % s->q), d, 1);
+    }
+    return NULL;
+}
+
+// Threads to use for a search
+static int approx_thread_count(int max_tuples, int threads) {
+    if (max_tuples < CR_APPROX_MIN_PARALLEL_TUPLES) return 1;
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    return threads < CR_DENOM_RANGE ? threads : CR_DENOM_RANGE;
+}
+
+// Best multiple of 1/lcm over every set of up to max_tuples denominators
+static ApproxCandidate search_all(uint64_t p, uint64_t q, int max_tuples, int threads) {
+    ApproxSearch s = {p, q, max_tuples, 0, error_bits(INFINITY)};
+    ApproxWorker first = {&s, {q, 1, 0}};  // Stand-in, beaten by the integer below
+    consider(&first, 1, p);
+    if (max_tuples == 0) return first.best;
+
+    threads = approx_thread_count(max_tuples, threads);
+    ApproxWorker* workers = threads > 1 ? malloc((size_t)threads * sizeof(ApproxWorker)) : NULL;
+    pthread_t* ids = workers != NULL ? malloc((size_t)threads * sizeof(pthread_t)) : NULL;
+    bool* started = ids != NULL ? calloc((size_t)threads, sizeof(bool)) : NULL;
+    if (started == NULL) {
+        // Single thread requested, or no memory for bookkeeping: search inline
+        free(ids);
+        free(workers);
+        approx_worker(&first);
+        return first.best;
+    }
+
+    workers[0] = first;
+    for (int t = 1; t < threads; t++) {
+        workers[t] = first;
+        started[t] = pthread_create(&ids[t], NULL, approx_worker, &workers[t]) == 0;
+    }
+    approx_worker(&workers[0]);
+
+    ApproxCandidate best = workers[0].best;
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(ids[t], NULL);
+        }
+        if (candidate_better(&workers[t].best, &best)) {
+            best = workers[t].best;
+        }
+    }
+
+    free(started);
+    free(ids);
+    free(workers);
+    return best;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+/**
+ * Approximate whole + p/q (0 <= p < q, reduced)
+ * Fractions with an exact encoding within the budget skip the search.
+ */
+static CompactRational approximate_parts(int64_t whole, uint64_t p, uint64_t q, int max_tuples, int threads,
+                                         CRError* error) {
+    if (max_tuples < 0) max_tuples = 0;
+    if (max_tuples > MAX_TUPLES) max_tuples = MAX_TUPLES;
+
+    int exact = p != 0 ? cr_exact_tuple_count(p, q) : 0;
+    if (exact >= 0 && exact <= max_tuples) {
+        return cr_encode_wide((__int128)whole * q + p, q, CR_OP_APPROXIMATE, error);
+    }
+
+    ApproxCandidate best = search_all(p, q, max_tuples, threads);
+    __int128 whole_after = whole + (__int128)(best.num / best.lcm);
+    CompactRational cr = cr_encode_wide((__int128)whole * best.lcm + best.num, best.lcm, CR_OP_APPROXIMATE, error);
+    if (whole_after >= MIN_WHOLE_VALUE && whole_after <= MAX_WHOLE_VALUE) {
+        cr_report(error, CR_ERROR_INEXACT, CR_OP_APPROXIMATE, (int32_t)(cr_size(&cr) - 2) / 2, max_tuples);
+    } else {
+        cr_report_flag(CR_ERROR_INEXACT);  // The clamp cr_encode_wide reported outranks it
+    }
+    return cr;
+}
+
+// Best approximation of a double
+CompactRational cr_approximate(double target, int max_tuples, int threads, CRError* error) {
+    if (isnan(target)) {
+        CompactRational zero;
+        cr_init(&zero);
+        cr_report(error, CR_ERROR_INEXACT, CR_OP_APPROXIMATE, 0, max_tuples);
+        return zero;
+    }
+    if (fabs(target) >= 0x1p62) {
+        return cr_encode_wide(target > 0 ? INT64_MAX : INT64_MIN, 1, CR_OP_APPROXIMATE, error);
+    }
+
+    // The fraction is exact in a double; scaled by 2^63 it is an integer
+    // unless it has bits below 2^-63
+    double whole = floor(target);
+    uint64_t p = (uint64_t)nearbyint(ldexp(target - whole, 63));
+    uint64_t q = UINT64_C(1) << 63;
+    if (p == q) {
+        p = 0;
+        whole += 1;
+    }
+    if (p != 0) {
+        int shift = __builtin_ctzll(p);
+        p >>= shift;
+        q >>= shift;
+    }
+    return approximate_parts((int64_t)whole, p, q, max_tuples, threads, error);
+}
+
+// Best approximation of a rational
+CompactRational cr_approximate_rational(Rational target, int max_tuples, int threads, CRError* error) {
+    if (target.denominator == 0) {
+        CompactRational zero;
+        cr_init(&zero);
+        cr_report(error, CR_ERROR_DIVISION_BY_ZERO, CR_OP_APPROXIMATE, cr_saturate_i32(target.numerator), 0);
+        return zero;
+    }
+
+    // Floor division in 128 bits, so INT64_MIN / -1 is harmless
+    __int128 n = target.numerator, d = target.denominator;
+    if (d < 0) {
+        n = -n;
+        d = -d;
+    }
+    __int128 whole = n / d, rem = n % d;
+    if (rem < 0) {
+        rem += d;
+        whole -= 1;
+    }
+    uint64_t g = gcd_u64((uint64_t)rem, (uint64_t)d);
+    int64_t whole64 = whole > INT64_MAX ? INT64_MAX : (int64_t)whole;
+    return approximate_parts(whole64, (uint64_t)rem / g, (uint64_t)d / g, max_tuples, threads, error);
+}
+
+// ============================================================================
+// EXACT ERROR
+// ============================================================================
+
+/**
+ * cr - target as the exact fraction *residual / (*denom * target denominator)
+ * The value is whole * D + n over the product D of its tuple denominators
+ * (below 2^40, so the value's numerator stays below 2^55); with a target
+ * denominator up to 2^63 the residual needs at most 119 bits.
+ */
+static __int128 residual_parts(const CompactRational* cr, Rational target, int64_t* denom, __int128* target_denom) {
+    int64_t n, d;
+    cr_fraction_parts(cr, &n, &d);
+    __int128 value = (__int128)cr_whole_value(cr->whole) * d + n;
+
+    __int128 tn = target.numerator, td = target.denominator;
+    if (td < 0) {
+        tn = -tn;
+        td = -td;
+    }
+    *denom = d;
+    *target_denom = td;
+    return value * td - tn * d;
+}
+
+// Compare a * x with b * y, products of up to 192 bits
+static int cmp_scaled(unsigned __int128 a, uint64_t x, unsigned __int128 b, uint64_t y) {
+    unsigned __int128 lo_a = (unsigned __int128)(uint64_t)a * x;
+    unsigned __int128 hi_a = (unsigned __int128)(uint64_t)(a >> 64) * x + (lo_a >> 64);
+    unsigned __int128 lo_b = (unsigned __int128)(uint64_t)b * y;
+    unsigned __int128 hi_b = (unsigned __int128)(uint64_t)(b >> 64) * y + (lo_b >> 64);
+    if (hi_a != hi_b) return hi_a < hi_b ? -1 : 1;
+    uint64_t la = (uint64_t)lo_a, lb = (uint64_t)lo_b;
+    return (la > lb) - (la < lb);
+}
+
+// cr - target, rounded once from the exact residual
+long double cr_residual(const CompactRational* cr, Rational target, CRError* error) {
+    if (target.denominator == 0) {
+        cr_report(error, CR_ERROR_DIVISION_BY_ZERO, CR_OP_APPROXIMATE, cr_saturate_i32(target.numerator), 0);
+        return 0.0L;
+    }
+    int64_t d;
+    __int128 td;
+    __int128 e = residual_parts(cr, target, &d, &td);
+    cr_report_success(error);
+    return (long double)e / ((long double)d * (long double)td);
+}
+
+// Sign of |a - target| - |b - target|, exactly
+int cr_cmp_distance(const CompactRational* a, const CompactRational* b, Rational target) {
+    int64_t da, db;
+    __int128 td;
+    __int128 ea = residual_parts(a, target, &da, &td);
+    __int128 eb = residual_parts(b, target, &db, &td);
+    unsigned __int128 ma = ea < 0 ? -(unsigned __int128)ea : (unsigned __int128)ea;
+    unsigned __int128 mb = eb < 0 ? -(unsigned __int128)eb : (unsigned __int128)eb;
+    return cmp_scaled(ma, (uint64_t)db, mb, (uint64_t)da);
+}
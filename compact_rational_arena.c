@@ -0,0 +1,179 @@
+#include "compact_rational_internal.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// ARENA BLOCKS
+// ============================================================================
+
+struct CRArenaBlock {
+    CRArenaBlock* next;               // Next block in allocation order
+    size_t capacity;                  // Payload bytes
+    uint8_t data[];
+};
+
+// Initialize an empty arena
+void cr_arena_init(CRArena* arena, size_t block_size) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->used = 0;
+    arena->block_size = block_size > 0 ? block_size : CR_ARENA_DEFAULT_BLOCK_SIZE;
+    arena->bytes = 0;
+    arena->reserved = 0;
+}
+
+// Release every block
+void cr_arena_free(CRArena* arena) {
+    CRArenaBlock* block = arena->first;
+    while (block != NULL) {
+        CRArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    cr_arena_init(arena, arena->block_size);
+}
+
+// Rewind to the first block; later blocks are reused in order
+void cr_arena_reset(CRArena* arena) {
+    arena->current = arena->first;
+    arena->used = 0;
+    arena->bytes = 0;
+}
+
+/**
+ * Move to the next block with room for bytes, allocating one after the
+ * current block if none of the blocks kept from before a reset fits.
+ * Blocks skipped over stay in the list for the next cycle.
+ */
+static void* take_slow(CRArena* arena, size_t bytes, CRError* error) {
+    CRArenaBlock* block = arena->current != NULL ? arena->current->next : arena->first;
+    while (block != NULL && block->capacity < bytes) {
+        block = block->next;
+    }
+
+    if (block == NULL) {
+        size_t capacity = bytes > arena->block_size ? bytes : arena->block_size;
+        block = malloc(sizeof(CRArenaBlock) + capacity);
+        if (block == NULL) {
+            cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_ARENA, cr_saturate_i32((int64_t)capacity), 0);
+            return NULL;
+        }
+        block->capacity = capacity;
+        if (arena->current != NULL) {
+            block->next = arena->current->next;
+            arena->current->next = block;
+        } else {
+            block->next = arena->first;
+            arena->first = block;
+        }
+        arena->reserved += capacity;
+    }
+
+    arena->current = block;
+    arena->used = bytes;
+    arena->bytes += bytes;
+    return block->data;
+}
+
+// Bump allocation; reports only failures, so callers keep their own status
+static inline void* take(CRArena* arena, size_t bytes, CRError* error) {
+    CRArenaBlock* block = arena->current;
+    if (block != NULL && block->capacity - arena->used >= bytes) {
+        void* p = block->data + arena->used;
+        arena->used += bytes;
+        arena->bytes += bytes;
+        return p;
+    }
+    return take_slow(arena, bytes, error);
+}
+
+// Allocate bytes from the arena
+void* cr_arena_alloc(CRArena* arena, size_t bytes, CRError* error) {
+    void* p = take(arena, bytes, error);
+    if (p != NULL) {
+        cr_report_success(error);
+    }
+    return p;
+}
+
+// Bytes of block memory held
+size_t cr_arena_footprint(const CRArena* arena) {
+    return arena->reserved;
+}
+
+// ============================================================================
+// PACKED VALUES
+// ============================================================================
+
+// Pack cr into exactly its 2+2n bytes of arena memory
+static const uint8_t* put(CRArena* arena, const CompactRational* cr, CRError* error) {
+    size_t size = cr_size(cr);
+    uint8_t* p = take(arena, size, error);
+    if (p != NULL) {
+        cr_pack(cr, p, size);
+    }
+    return p;
+}
+
+// Copy a value into the arena
+const uint8_t* cr_arena_store(CRArena* arena, const CompactRational* cr, CRError* error) {
+    cr_report_success(error);
+    return put(arena, cr, error);
+}
+
+// Decode a stored value; every stored value ends with an end flag
+CompactRational cr_arena_load(const uint8_t* value) {
+    CompactRational cr;
+    if (cr_unpack(value, CR_MAX_PACKED_SIZE, &cr) == 0) {
+        cr_init(&cr);  // Not a stored value
+    }
+    return cr;
+}
+
+// Sum of a and b, stored in the arena
+const uint8_t* cr_arena_add(CRArena* arena, const CompactRational* a, const CompactRational* b, CRError* error) {
+    CompactRational sum = cr_add(a, b, error);
+    return put(arena, &sum, error);
+}
+
+// Canonical form of cr, stored in the arena
+const uint8_t* cr_arena_canonicalize(CRArena* arena, const CompactRational* cr, CRError* error) {
+    CompactRational canonical = cr_canonicalize(cr, error);
+    return put(arena, &canonical, error);
+}
+
+// Optimal encoding of num/denom, stored in the arena
+const uint8_t* cr_arena_encode_optimal(CRArena* arena, int64_t num, int64_t denom, CRError* error) {
+    CompactRational encoded = cr_encode_optimal(num, denom, error);
+    return put(arena, &encoded, error);
+}
+
+// ============================================================================
+// PER-THREAD ARENAS
+// ============================================================================
+
+static pthread_key_t thread_arena_key;
+static pthread_once_t thread_arena_once = PTHREAD_ONCE_INIT;
+static __thread CRArena thread_arena;
+static __thread bool thread_arena_ready = false;
+
+// Thread-exit destructor registered for each thread that used its arena
+static void release_thread_arena(void* arena) {
+    cr_arena_free((CRArena*)arena);
+}
+
+static void create_thread_arena_key(void) {
+    pthread_key_create(&thread_arena_key, release_thread_arena);
+}
+
+// The calling thread's arena, created on first use
+CRArena* cr_arena_thread(void) {
+    if (!thread_arena_ready) {
+        cr_arena_init(&thread_arena, 0);
+        pthread_once(&thread_arena_once, create_thread_arena_key);
+        pthread_setspecific(thread_arena_key, &thread_arena);
+        thread_arena_ready = true;
+    }
+    return &thread_arena;
+}
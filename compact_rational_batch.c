@@ -0,0 +1,152 @@
+#include "compact_rational_internal.h"
+
+// Values checked together for the integer-only fast lane
+#define CR_BATCH_BLOCK 8
+
+// ============================================================================
+// BATCH DECODE: cr_to_double over arrays
+// ============================================================================
+
+/**
+ * Decode whole plus the first tuple without branching
+ * A value without tuples divides 0 by 1, so integer and single-tuple values
+ * share one straight-line path and the divisions pipeline.
+ */
+static inline double decode_first_tuple(const CompactRational* cr) {
+    uint32_t has_tuples = (uint16_t)cr->whole >> 15;
+    uint32_t tuple = cr->tuples[0];
+    uint32_t num = (tuple >> 8) & (0u - has_tuples);
+    uint32_t den = 1 + has_tuples * (MIN_DENOMINATOR - 1 + (tuple & 0x7F));
+
+    return (double)cr_whole_value(cr->whole) + (double)num / (double)den;
+}
+
+// Bit 15 set when tuples are present and the first one has no end flag
+static inline uint16_t second_tuple_flag(const CompactRational* cr) {
+    return (uint16_t)((uint16_t)cr->whole & ~(uint16_t)(cr->tuples[0] << 8));
+}
+
+// Full decode; returns false if the tuple sequence has no end flag
+static bool decode_all_tuples(const CompactRational* cr, double* out) {
+    double frac = 0.0;
+    bool terminated = true;
+    if (cr->whole & 0x8000) {
+        terminated = false;
+        for (int t = 0; t < MAX_TUPLES; t++) {
+            uint16_t tuple = cr->tuples[t];
+            frac += (double)(tuple >> 8) / (double)(MIN_DENOMINATOR + (tuple & 0x7F));
+            if (tuple & 0x80) {
+                terminated = true;
+                break;
+            }
+        }
+    }
+    *out = (double)cr_whole_value(cr->whole) + frac;
+    return terminated;
+}
+
+// Convert an array of compact rationals to doubles
+size_t cr_to_double_batch(const CompactRational* values, size_t n, double* out, CRError* error) {
+    size_t malformed = 0;
+    size_t first_malformed = 0;
+    size_t i = 0;
+
+    for (; i + CR_BATCH_BLOCK <= n; i += CR_BATCH_BLOCK) {
+        uint16_t flags = 0;
+        uint16_t deep = 0;
+        for (int k = 0; k < CR_BATCH_BLOCK; k++) {
+            flags |= (uint16_t)values[i + k].whole;
+            deep |= second_tuple_flag(&values[i + k]);
+        }
+
+        if (!(flags & 0x8000)) {
+            // Integer-only block: bit 15 clear everywhere, no tuples to visit
+            for (int k = 0; k < CR_BATCH_BLOCK; k++) {
+                out[i + k] = (double)cr_whole_value(values[i + k].whole);
+            }
+            continue;
+        }
+
+        for (int k = 0; k < CR_BATCH_BLOCK; k++) {
+            out[i + k] = decode_first_tuple(&values[i + k]);
+        }
+
+        // Rare: values with more than one tuple are redone in full
+        if (deep & 0x8000) {
+            for (int k = 0; k < CR_BATCH_BLOCK; k++) {
+                if ((second_tuple_flag(&values[i + k]) & 0x8000) &&
+                    !decode_all_tuples(&values[i + k], &out[i + k])) {
+                    if (malformed == 0) first_malformed = i + k;
+                    malformed++;
+                }
+            }
+        }
+    }
+
+    for (; i < n; i++) {
+        if (!decode_all_tuples(&values[i], &out[i])) {
+            if (malformed == 0) first_malformed = i;
+            malformed++;
+        }
+    }
+
+    if (malformed > 0) {
+        cr_report(error, CR_ERROR_TUPLE_BOUNDS, CR_OP_TO_DOUBLE_BATCH, cr_saturate_i32((int64_t)malformed),
+                  cr_saturate_i32((int64_t)first_malformed));
+    } else {
+        cr_report_success(error);
+    }
+    return malformed;
+}
+
+// ============================================================================
+// BATCH CANONICALIZATION
+// ============================================================================
+
+// Canonicalize an array of compact rationals
+size_t cr_canonicalize_array(const CompactRational* values, size_t n, CompactRational* out, CRError* error) {
+    size_t clamped = 0;
+    int64_t first_clamped = 0;
+
+    for (size_t i = 0; i < n; i += CR_BATCH_BLOCK) {
+        size_t block = n - i < CR_BATCH_BLOCK ? n - i : CR_BATCH_BLOCK;
+        uint16_t flags = 0;
+        for (size_t k = 0; k < block; k++) {
+            flags |= (uint16_t)values[i + k].whole;
+        }
+
+        if (!(flags & 0x8000)) {
+            // Integer-only block: already canonical, only the tuples are reset
+            for (size_t k = 0; k < block; k++) {
+                int16_t whole = values[i + k].whole;
+                int32_t value = cr_whole_value(whole);
+                cr_init(&out[i + k]);
+                out[i + k].whole = whole;
+                if (value < MIN_WHOLE_VALUE) {
+                    if (clamped++ == 0) first_clamped = value;
+                    out[i + k].whole = (int16_t)(MIN_WHOLE_VALUE & 0x7FFF);
+                }
+            }
+            continue;
+        }
+
+        for (size_t k = 0; k < block; k++) {
+            CompactRational result;  // out may alias values
+            int64_t whole = cr_canonical_parts(&values[i + k], &result);
+            if (whole > MAX_WHOLE_VALUE || whole < MIN_WHOLE_VALUE) {
+                if (clamped++ == 0) first_clamped = whole;
+                whole = whole > MAX_WHOLE_VALUE ? MAX_WHOLE_VALUE : MIN_WHOLE_VALUE;
+            }
+            result.whole = (int16_t)(result.whole | (whole & 0x7FFF));
+            out[i + k] = result;
+        }
+    }
+
+    if (clamped > 0) {
+        cr_report(error, CR_ERROR_VALUE_CLAMPED, CR_OP_CANONICALIZE, cr_saturate_i32(first_clamped),
+                  first_clamped > MAX_WHOLE_VALUE ? MAX_WHOLE_VALUE : MIN_WHOLE_VALUE);
+    } else {
+        cr_report_success(error);
+    }
+    return clamped;
+}
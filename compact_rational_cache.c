@@ -0,0 +1,184 @@
+#include "compact_rational_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Slots examined per lookup before giving up
+#define CR_CACHE_PROBE 4
+
+// Smallest table allocated
+#define CR_CACHE_MIN_CAPACITY 16
+
+// Entry kinds: which encoder produced the cached value
+#define CR_CACHE_KIND_FRACTION 1
+#define CR_CACHE_KIND_OPTIMAL 2
+
+// ============================================================================
+// ENCODING CACHE
+// ============================================================================
+
+// Counter stripe of the calling thread, assigned round robin on first use
+static uint32_t next_stripe = 0;
+static __thread uint32_t thread_stripe = UINT32_MAX;
+
+static CRCacheCounters* counters_for_thread(CRCache* cache) {
+    if (thread_stripe == UINT32_MAX) {
+        thread_stripe = __atomic_fetch_add(&next_stripe, 1, __ATOMIC_RELAXED) % CR_CACHE_STRIPES;
+    }
+    return &cache->counters[thread_stripe];
+}
+
+// Mix a reduced key into a slot index (splitmix64 finalizer)
+static uint64_t hash_key(int64_t num, int64_t denom, uint32_t kind) {
+    uint64_t h = (uint64_t)num * 0x9E3779B97F4A7C15ull ^ (uint64_t)denom ^ ((uint64_t)kind << 61);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+// Initialize an empty cache with room for at least capacity entries
+bool cr_cache_init(CRCache* cache, size_t capacity, CRError* error) {
+    size_t slots = CR_CACHE_MIN_CAPACITY;
+    while (slots < capacity) {
+        slots *= 2;
+    }
+
+    memset(cache->counters, 0, sizeof(cache->counters));
+    cache->entries = calloc(slots, sizeof(CRCacheEntry));
+    if (cache->entries == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_CACHE_INIT, cr_saturate_i32((int64_t)slots), 0);
+        cache->mask = 0;
+        return false;
+    }
+    cache->mask = slots - 1;
+    cr_report_success(error);
+    return true;
+}
+
+// Release the table; the cache must no longer be in use by other threads
+void cr_cache_free(CRCache* cache) {
+    free(cache->entries);
+    cache->entries = NULL;
+    cache->mask = 0;
+}
+
+/**
+ * Seqlock read of one slot
+ * An odd sequence means a writer is active; a changed sequence means the
+ * fields were torn. Either way the read is treated as a miss.
+ */
+static bool read_entry(const CRCacheEntry* e, int64_t num, int64_t denom, uint32_t kind, CompactRational* out) {
+    uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1) return false;
+
+    uint32_t e_kind = __atomic_load_n(&e->kind, __ATOMIC_RELAXED);
+    int64_t e_num = __atomic_load_n(&e->num, __ATOMIC_RELAXED);
+    int64_t e_denom = __atomic_load_n(&e->denom, __ATOMIC_RELAXED);
+    uint32_t value[3];
+    for (int i = 0; i < 3; i++) {
+        value[i] = __atomic_load_n(&e->value[i], __ATOMIC_RELAXED);
+    }
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&e->seq, __ATOMIC_RELAXED) != seq) return false;
+    if (e_kind != kind || e_num != num || e_denom != denom) return false;
+
+    memcpy(out, value, sizeof(*out));
+    return true;
+}
+
+/**
+ * Seqlock write of one slot
+ * Writers never wait: if another writer holds the slot the value is simply
+ * not cached this time.
+ */
+static void write_entry(CRCacheEntry* e, int64_t num, int64_t denom, uint32_t kind, const CompactRational* cr) {
+    uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_RELAXED);
+    if ((seq & 1) || !__atomic_compare_exchange_n(&e->seq, &seq, seq + 1, false,
+                                                  __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    uint32_t value[3];
+    memcpy(value, cr, sizeof(value));
+    __atomic_store_n(&e->kind, kind, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->num, num, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->denom, denom, __ATOMIC_RELAXED);
+    for (int i = 0; i < 3; i++) {
+        __atomic_store_n(&e->value[i], value[i], __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&e->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * Shared lookup-or-encode path
+ * Only results that encode with CR_SUCCESS are cached, so a hit always
+ * reports success without re-running the encoder. The slot replaced on a
+ * miss is the first empty one in the probe window, else the home slot.
+ */
+static CompactRational cached_encode(CRCache* cache, int64_t num, int64_t denom, uint32_t kind, CRError* error) {
+    Rational r = {num, denom};
+    reduce_rational(&r);
+
+    uint64_t home = hash_key(r.numerator, r.denominator, kind);
+    CRCacheEntry* victim = NULL;
+    for (size_t i = 0; i < CR_CACHE_PROBE; i++) {
+        CRCacheEntry* e = &cache->entries[(home + i) & cache->mask];
+        CompactRational cr;
+        if (read_entry(e, r.numerator, r.denominator, kind, &cr)) {
+            __atomic_fetch_add(&counters_for_thread(cache)->hits, 1, __ATOMIC_RELAXED);
+            cr_report_success(error);
+            return cr;
+        }
+        if (victim == NULL && __atomic_load_n(&e->kind, __ATOMIC_RELAXED) == 0) {
+            victim = e;  // Never written
+        }
+    }
+    if (victim == NULL) {
+        victim = &cache->entries[home & cache->mask];
+    }
+    __atomic_fetch_add(&counters_for_thread(cache)->misses, 1, __ATOMIC_RELAXED);
+
+    CRError local;
+    CompactRational cr = kind == CR_CACHE_KIND_FRACTION
+        ? cr_from_fraction((int32_t)r.numerator, (int32_t)r.denominator, &local)
+        : cr_encode_optimal(r.numerator, r.denominator, &local);
+    if (local.code == CR_SUCCESS) {
+        write_entry(victim, r.numerator, r.denominator, kind, &cr);
+    }
+    if (error != NULL) {
+        *error = local;
+    }
+    return cr;
+}
+
+// cr_from_fraction through the cache
+CompactRational cr_cache_from_fraction(CRCache* cache, int32_t num, int32_t denom, CRError* error) {
+    if (denom == 0) {
+        return cr_from_fraction(num, denom, error);
+    }
+    return cached_encode(cache, num, denom, CR_CACHE_KIND_FRACTION, error);
+}
+
+// cr_encode_optimal through the cache
+CompactRational cr_cache_encode_optimal(CRCache* cache, int64_t num, int64_t denom, CRError* error) {
+    if (denom == 0) {
+        return cr_encode_optimal(num, denom, error);
+    }
+    return cached_encode(cache, num, denom, CR_CACHE_KIND_OPTIMAL, error);
+}
+
+// Sum the striped counters
+void cr_cache_stats(const CRCache* cache, uint64_t* hits, uint64_t* misses) {
+    uint64_t h = 0, m = 0;
+    for (int i = 0; i < CR_CACHE_STRIPES; i++) {
+        h += __atomic_load_n(&cache->counters[i].hits, __ATOMIC_RELAXED);
+        m += __atomic_load_n(&cache->counters[i].misses, __ATOMIC_RELAXED);
+    }
+    if (hits != NULL) *hits = h;
+    if (misses != NULL) *misses = m;
+}
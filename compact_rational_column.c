@@ -0,0 +1,237 @@
+#include "compact_rational_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// COLUMNAR STORAGE
+// ============================================================================
+
+// Smallest pattern hash table; doubled to stay at most half full
+#define COLUMN_MIN_SLOTS 64
+
+// Initialize an empty column
+void cr_column_init(CRColumn* col) {
+    memset(col, 0, sizeof(*col));
+}
+
+// Release storage and reset to empty
+void cr_column_free(CRColumn* col) {
+    free(col->wholes);
+    free(col->refs);
+    free(col->rank);
+    free(col->patterns);
+    free(col->slots);
+    cr_column_init(col);
+}
+
+// Grow one array to hold at least needed elements (doubling, from 64)
+static bool grow_array(void** data, size_t* capacity, size_t needed, size_t element, CRError* error) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    size_t grown = *capacity > 0 ? *capacity : 64;
+    while (grown < needed) {
+        grown *= 2;
+    }
+    void* p = realloc(*data, grown * element);
+    if (p == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_COLUMN_APPEND, cr_saturate_i32((int64_t)(grown * element)), 0);
+        return false;
+    }
+    *data = p;
+    *capacity = grown;
+    return true;
+}
+
+// Room for extra more rows, their rank entries, and a pattern number each
+static bool reserve_rows(CRColumn* col, size_t extra, CRError* error) {
+    size_t rows = col->count + extra;
+    size_t ranks = (rows + CR_PACKED_INDEX_STRIDE - 1) / CR_PACKED_INDEX_STRIDE;
+    return grow_array((void**)&col->wholes, &col->capacity, rows, sizeof(cr16_t), error) &&
+           grow_array((void**)&col->rank, &col->rank_capacity, ranks, sizeof(uint64_t), error);
+}
+
+// Hash of a tuple sequence (splitmix64 finalizer over its 80 bits)
+static uint64_t hash_pattern(const uint16_t* tuples) {
+    uint64_t h = ((uint64_t)tuples[0] | (uint64_t)tuples[1] << 16 | (uint64_t)tuples[2] << 32 |
+                  (uint64_t)tuples[3] << 48) * 0x9E3779B97F4A7C15ull ^ tuples[4];
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+// Rebuild the hash table with the given number of slots
+static bool rehash(CRColumn* col, size_t slot_count, CRError* error) {
+    uint32_t* slots = calloc(slot_count, sizeof(uint32_t));
+    if (slots == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_COLUMN_APPEND,
+                  cr_saturate_i32((int64_t)(slot_count * sizeof(uint32_t))), 0);
+        return false;
+    }
+    for (size_t p = 0; p < col->pattern_count; p++) {
+        size_t slot = hash_pattern(&col->patterns[p * MAX_TUPLES]) & (slot_count - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        slots[slot] = (uint32_t)p + 1;
+    }
+    free(col->slots);
+    col->slots = slots;
+    col->slot_count = slot_count;
+    return true;
+}
+
+// Pattern number of a tuple sequence, added to the dictionary if new; -1 on failure
+static int32_t find_pattern(CRColumn* col, const uint16_t* tuples, CRError* error) {
+    if (col->slot_count > 0) {
+        size_t slot = hash_pattern(tuples) & (col->slot_count - 1);
+        for (; col->slots[slot] != 0; slot = (slot + 1) & (col->slot_count - 1)) {
+            const uint16_t* known = &col->patterns[(col->slots[slot] - 1) * MAX_TUPLES];
+            if (memcmp(known, tuples, MAX_TUPLES * sizeof(uint16_t)) == 0) {
+                return (int32_t)col->slots[slot] - 1;
+            }
+        }
+    }
+
+    if (col->pattern_count == CR_COLUMN_MAX_PATTERNS) {
+        cr_report(error, CR_ERROR_OUT_OF_BOUNDS, CR_OP_COLUMN_APPEND, cr_saturate_i32((int64_t)col->count),
+                  CR_COLUMN_MAX_PATTERNS);
+        return -1;
+    }
+    if (2 * (col->pattern_count + 1) > col->slot_count &&
+        !rehash(col, col->slot_count > 0 ? 2 * col->slot_count : COLUMN_MIN_SLOTS, error)) {
+        return -1;
+    }
+    if (!grow_array((void**)&col->patterns, &col->pattern_capacity, col->pattern_count + 1,
+                    MAX_TUPLES * sizeof(uint16_t), error)) {
+        return -1;
+    }
+
+    size_t p = col->pattern_count++;
+    memcpy(&col->patterns[p * MAX_TUPLES], tuples, MAX_TUPLES * sizeof(uint16_t));
+    size_t slot = hash_pattern(tuples) & (col->slot_count - 1);
+    while (col->slots[slot] != 0) {
+        slot = (slot + 1) & (col->slot_count - 1);
+    }
+    col->slots[slot] = (uint32_t)p + 1;
+    return (int32_t)p;
+}
+
+// Append a value whose row storage has already been reserved
+static bool append_reserved(CRColumn* col, const CompactRational* cr, CRError* error) {
+    if (cr->whole & 0x8000) {
+        // The tuples as cr_pack writes them: only up to the end flag, which is forced on the last
+        uint16_t tuples[MAX_TUPLES] = {0};
+        size_t tuple_count = (cr_size(cr) - 2) / 2;
+        memcpy(tuples, cr->tuples, tuple_count * sizeof(uint16_t));
+        tuples[tuple_count - 1] |= 0x80;
+
+        if (!grow_array((void**)&col->refs, &col->refs_capacity, col->tagged + 1, sizeof(uint16_t), error)) {
+            return false;
+        }
+        int32_t pattern = find_pattern(col, tuples, error);
+        if (pattern < 0) {
+            return false;
+        }
+        col->refs[col->tagged] = (uint16_t)pattern;
+    }
+
+    if (col->count % CR_PACKED_INDEX_STRIDE == 0) {
+        col->rank[col->count / CR_PACKED_INDEX_STRIDE] = col->tagged;
+    }
+    col->wholes[col->count++] = cr16_from_cr(cr);
+    col->tagged += cr->whole & 0x8000 ? 1 : 0;
+    return true;
+}
+
+// Append one value
+bool cr_column_append(CRColumn* col, const CompactRational* cr, CRError* error) {
+    if (!reserve_rows(col, 1, error) || !append_reserved(col, cr, error)) {
+        return false;
+    }
+    cr_report_success(error);
+    return true;
+}
+
+// Append an array of values, sizing row storage once
+size_t cr_column_append_array(CRColumn* col, const CompactRational* values, size_t n, CRError* error) {
+    if (!reserve_rows(col, n, error)) {
+        return 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!append_reserved(col, &values[i], error)) {
+            return i;
+        }
+    }
+    cr_report_success(error);
+    return n;
+}
+
+// Number of the first pattern reference at or after row i
+static size_t ref_position(const CRColumn* col, size_t i) {
+    size_t base = i - i % CR_PACKED_INDEX_STRIDE;
+    size_t ref = (size_t)col->rank[base / CR_PACKED_INDEX_STRIDE];
+    for (size_t row = base; row < i; row++) {
+        ref += col->wholes[row] >> 15;
+    }
+    return ref;
+}
+
+// Value of a lane, with its dictionary entry if it is tagged
+static CompactRational decode_row(cr16_t lane, const uint16_t* patterns, const uint16_t* ref) {
+    CompactRational cr = {(int16_t)lane, {0}};
+    if (!cr16_is_integer(lane)) {
+        memcpy(cr.tuples, &patterns[(size_t)*ref * MAX_TUPLES], sizeof(cr.tuples));
+    }
+    return cr;
+}
+
+// Random access into a column
+CompactRational cr_column_get(const CRColumn* col, size_t i, CRError* error) {
+    if (i >= col->count) {
+        cr_report(error, CR_ERROR_OUT_OF_BOUNDS, CR_OP_COLUMN_GET, cr_saturate_i32((int64_t)i),
+                  cr_saturate_i32((int64_t)col->count));
+        CompactRational zero;
+        cr_init(&zero);
+        return zero;
+    }
+    cr_report_success(error);
+    return decode_row(col->wholes[i], col->patterns, &col->refs[ref_position(col, i)]);
+}
+
+// Decode a contiguous range after a single rank lookup
+size_t cr_column_unpack(const CRColumn* col, size_t start, size_t n, CompactRational* out, CRError* error) {
+    if (start >= col->count) {
+        if (n == 0) {
+            cr_report_success(error);
+            return 0;
+        }
+        cr_report(error, CR_ERROR_OUT_OF_BOUNDS, CR_OP_COLUMN_GET, cr_saturate_i32((int64_t)start),
+                  cr_saturate_i32((int64_t)col->count));
+        return 0;
+    }
+
+    if (n > col->count - start) {
+        n = col->count - start;
+    }
+    // Locals, so stores to out need not reload the column's pointers
+    const cr16_t* wholes = col->wholes + start;
+    const uint16_t* patterns = col->patterns;
+    const uint16_t* ref = col->refs + ref_position(col, start);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = decode_row(wholes[i], patterns, ref);
+        ref += wholes[i] >> 15;
+    }
+    cr_report_success(error);
+    return n;
+}
+
+// Bytes in use, without the hash table
+size_t cr_column_footprint(const CRColumn* col) {
+    size_t ranks = (col->count + CR_PACKED_INDEX_STRIDE - 1) / CR_PACKED_INDEX_STRIDE;
+    return col->count * sizeof(cr16_t) + col->tagged * sizeof(uint16_t) + ranks * sizeof(uint64_t) +
+           col->pattern_count * MAX_TUPLES * sizeof(uint16_t);
+}
@@ -0,0 +1,293 @@
+#include "compact_rational_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// DELTA CODEC
+// ============================================================================
+
+// Interleaved lanes of the bit-packed deltas, and values per lane
+#define DELTA_LANES 4
+#define DELTA_LANE_VALUES (CR_DELTA_BLOCK / DELTA_LANES)
+
+// Header bytes of a block, and the largest block (16-bit deltas, a run per value)
+#define DELTA_HEADER 4
+#define DELTA_MAX_BLOCK (DELTA_HEADER + 16 * 16 + CR_DELTA_BLOCK * (2 + 2 * MAX_TUPLES))
+
+static uint32_t zigzag(int32_t d) {
+    return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+
+static int32_t unzigzag(uint32_t z) {
+    return (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+}
+
+static uint32_t load_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Tuples of a value as cr_pack stores them; returns the tuple count
+static int packed_tuples(const CompactRational* cr, uint16_t* tuples) {
+    if (!(cr->whole & 0x8000)) {
+        return 0;
+    }
+    int count = (int)(cr_size(cr) - 2) / 2;
+    memcpy(tuples, cr->tuples, (size_t)count * sizeof(uint16_t));
+    tuples[count - 1] |= 0x80;
+    return count;
+}
+
+// Initialize an empty encoder
+void cr_delta_encoder_init(CRDeltaEncoder* enc) {
+    enc->data = NULL;
+    enc->size = 0;
+    enc->capacity = 0;
+    enc->count = 0;
+    enc->pending_count = 0;
+    enc->last_whole = 0;
+}
+
+// Release the stream
+void cr_delta_encoder_free(CRDeltaEncoder* enc) {
+    free(enc->data);
+    cr_delta_encoder_init(enc);
+}
+
+// Room for one more block of any shape
+static bool reserve_block(CRDeltaEncoder* enc, CRError* error) {
+    if (enc->size + DELTA_MAX_BLOCK <= enc->capacity) {
+        return true;
+    }
+    size_t capacity = enc->capacity > 0 ? enc->capacity : 4096;
+    while (capacity < enc->size + DELTA_MAX_BLOCK) {
+        capacity *= 2;
+    }
+    uint8_t* data = realloc(enc->data, capacity);
+    if (data == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_DELTA, cr_saturate_i32((int64_t)capacity), 0);
+        return false;
+    }
+    enc->data = data;
+    enc->capacity = capacity;
+    return true;
+}
+
+// Encode the pending values as one block
+static bool encode_block(CRDeltaEncoder* enc, CRError* error) {
+    size_t n = enc->pending_count;
+    if (n == 0) {
+        return true;
+    }
+    if (!reserve_block(enc, error)) {
+        return false;
+    }
+
+    // Zigzag deltas; padding past n stays zero
+    uint32_t deltas[CR_DELTA_BLOCK] = {0};
+    uint32_t all = 0;
+    int32_t prev = enc->last_whole;
+    for (size_t i = 0; i < n; i++) {
+        int32_t w = cr_whole_value(enc->pending[i].whole);
+        deltas[i] = zigzag(w - prev);
+        all |= deltas[i];
+        prev = w;
+    }
+    int width = all != 0 ? 32 - __builtin_clz(all) : 0;
+
+    // Lane j holds values j, j + 4, ...; its k-th value starts at bit k * width
+    uint32_t words[DELTA_LANES * 16 + DELTA_LANES] = {0};
+    for (int k = 0; k < DELTA_LANE_VALUES; k++) {
+        int bit = k * width;
+        for (int j = 0; j < DELTA_LANES; j++) {
+            uint64_t v = (uint64_t)deltas[k * DELTA_LANES + j] << (bit % 32);
+            words[DELTA_LANES * (bit / 32) + j] |= (uint32_t)v;
+            words[DELTA_LANES * (bit / 32 + 1) + j] |= (uint32_t)(v >> 32);
+        }
+    }
+
+    uint8_t* out = enc->data + enc->size;
+    uint8_t* p = out + DELTA_HEADER;
+    for (int i = 0; i < DELTA_LANES * width; i++) {
+        p[0] = (uint8_t)words[i];
+        p[1] = (uint8_t)(words[i] >> 8);
+        p[2] = (uint8_t)(words[i] >> 16);
+        p[3] = (uint8_t)(words[i] >> 24);
+        p += 4;
+    }
+
+    // Runs of identical tuple sequences
+    int runs = 0;
+    size_t i = 0;
+    while (i < n) {
+        uint16_t tuples[MAX_TUPLES], next[MAX_TUPLES];
+        int count = packed_tuples(&enc->pending[i], tuples);
+        size_t len = 1;
+        while (i + len < n && packed_tuples(&enc->pending[i + len], next) == count &&
+               memcmp(next, tuples, (size_t)count * sizeof(uint16_t)) == 0) {
+            len++;
+        }
+        *p++ = (uint8_t)(len - 1);
+        *p++ = (uint8_t)count;
+        for (int t = 0; t < count; t++) {
+            *p++ = (uint8_t)tuples[t];
+            *p++ = (uint8_t)(tuples[t] >> 8);
+        }
+        runs++;
+        i += len;
+    }
+
+    out[0] = (uint8_t)(n - 1);
+    out[1] = (uint8_t)width;
+    out[2] = (uint8_t)(runs - 1);
+    out[3] = 0;
+    enc->size = (size_t)(p - enc->data);
+    enc->last_whole = prev;
+    enc->pending_count = 0;
+    return true;
+}
+
+// Append values, encoding each block as it fills
+bool cr_delta_encode(CRDeltaEncoder* enc, const CompactRational* values, size_t n, CRError* error) {
+    for (size_t i = 0; i < n; i++) {
+        enc->pending[enc->pending_count++] = values[i];
+        enc->count++;
+        if (enc->pending_count == CR_DELTA_BLOCK && !encode_block(enc, error)) {
+            enc->pending_count--;
+            enc->count--;
+            return false;
+        }
+    }
+    cr_report_success(error);
+    return true;
+}
+
+// Encode the partly filled last block
+bool cr_delta_encoder_flush(CRDeltaEncoder* enc, CRError* error) {
+    if (!encode_block(enc, error)) {
+        return false;
+    }
+    cr_report_success(error);
+    return true;
+}
+
+// Start decoding a stream
+void cr_delta_decoder_init(CRDeltaDecoder* dec, const uint8_t* data, size_t size) {
+    dec->data = data;
+    dec->size = size;
+    dec->pos = 0;
+    dec->last_whole = 0;
+    dec->block_len = 0;
+    dec->block_pos = 0;
+}
+
+/**
+ * Decode the block at dec->pos into out (room for CR_DELTA_BLOCK values)
+ * Returns the value count, or 0 for a malformed block
+ */
+static size_t decode_block(CRDeltaDecoder* dec, CompactRational* out) {
+    const uint8_t* p = dec->data + dec->pos;
+    const uint8_t* end = dec->data + dec->size;
+    if (end - p < DELTA_HEADER || p[1] > 16 || p[3] != 0) {
+        return 0;
+    }
+    size_t n = (size_t)p[0] + 1;
+    int width = p[1];
+    int runs = p[2] + 1;
+    if (end - p < DELTA_HEADER + 16 * width) {
+        return 0;
+    }
+
+    // Unpack the four lanes side by side
+    uint32_t words[DELTA_LANES * 16 + DELTA_LANES] = {0};
+    for (int i = 0; i < DELTA_LANES * width; i++) {
+        words[i] = load_le32(p + DELTA_HEADER + 4 * i);
+    }
+    uint32_t mask = width < 32 ? (1u << width) - 1 : ~0u;
+    uint32_t deltas[CR_DELTA_BLOCK];
+    for (int k = 0; k < DELTA_LANE_VALUES; k++) {
+        int bit = k * width;
+        for (int j = 0; j < DELTA_LANES; j++) {
+            uint64_t pair = (uint64_t)words[DELTA_LANES * (bit / 32) + j] |
+                            (uint64_t)words[DELTA_LANES * (bit / 32 + 1) + j] << 32;
+            deltas[k * DELTA_LANES + j] = (uint32_t)(pair >> (bit % 32)) & mask;
+        }
+    }
+
+    // Prefix sum; the range check is accumulated so the loop has no branch.
+    // The bound is the 15-bit field's, not MIN_WHOLE_VALUE: raw 0x4000
+    // (-16384) is a whole part cr_unpack and cr_to_rational accept
+    int32_t whole = dec->last_whole;
+    int32_t wholes[CR_DELTA_BLOCK];
+    bool out_of_range = false;
+    for (size_t i = 0; i < n; i++) {
+        whole += unzigzag(deltas[i]);
+        out_of_range |= (whole > MAX_WHOLE_VALUE) | (whole < MIN_WHOLE_VALUE - 1);
+        wholes[i] = whole;
+    }
+    if (out_of_range) {
+        return 0;
+    }
+
+    // Runs: lengths must cover the block and every sequence end at its last tuple
+    p += DELTA_HEADER + 16 * width;
+    size_t i = 0;
+    for (int r = 0; r < runs; r++) {
+        if (end - p < 2) return 0;
+        size_t len = (size_t)p[0] + 1;
+        int count = p[1];
+        p += 2;
+        if (count > MAX_TUPLES || len > n - i || end - p < 2 * count) return 0;
+        uint16_t tuples[MAX_TUPLES] = {0};
+        for (int t = 0; t < count; t++) {
+            tuples[t] = (uint16_t)(p[0] | p[1] << 8);
+            if (((tuples[t] & 0x80) != 0) != (t == count - 1)) return 0;
+            p += 2;
+        }
+        int32_t tag = count > 0 ? 0x8000 : 0;
+        for (size_t stop = i + len; i < stop; i++) {
+            out[i].whole = (int16_t)(tag | (wholes[i] & 0x7FFF));
+            memcpy(out[i].tuples, tuples, sizeof(tuples));
+        }
+    }
+    if (i != n) {
+        return 0;
+    }
+
+    dec->last_whole = whole;
+    dec->pos = (size_t)(p - dec->data);
+    return n;
+}
+
+// Decode up to n values, whole blocks straight into out where they fit
+size_t cr_delta_decode(CRDeltaDecoder* dec, CompactRational* out, size_t n, CRError* error) {
+    size_t done = 0;
+    while (done < n) {
+        if (dec->block_pos < dec->block_len) {
+            size_t take = dec->block_len - dec->block_pos;
+            if (take > n - done) take = n - done;
+            memcpy(out + done, dec->block + dec->block_pos, take * sizeof(CompactRational));
+            dec->block_pos += take;
+            done += take;
+            continue;
+        }
+        if (dec->pos == dec->size) {
+            break;
+        }
+
+        bool direct = n - done >= CR_DELTA_BLOCK;
+        size_t pos = dec->pos;
+        size_t len = decode_block(dec, direct ? out + done : dec->block);
+        if (len == 0) {
+            cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_DELTA, cr_saturate_i32((int64_t)pos), 0);
+            return done;
+        }
+        if (direct) {
+            done += len;
+        } else {
+            dec->block_len = len;
+            dec->block_pos = 0;
+        }
+    }
+    cr_report_success(error);
+    return done;
+}
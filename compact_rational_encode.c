@@ -0,0 +1,484 @@
+#include "compact_rational_internal.h"
+#include "antichain_table.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Largest number of distinct primes <= MAX_DENOMINATOR in an int64_t
+#define CR_MAX_PRIME_POWERS 16
+
+// Largest lcm of MAX_TUPLES distinct antichain denominators is at most
+// their product; no larger reduced denominator can be encoded exactly
+#define CR_MAX_COVER_LCM (255LL * 254 * 253 * 252 * 251)
+
+// Covers evaluated at the minimal tuple count when looking for one that
+// keeps the whole part at floor(value)
+#define CR_MAX_COVER_CANDIDATES 64
+
+// Product of the pairwise coprime antichain denominators below: every
+// fraction over it has an exact five-tuple encoding, so rounding to it is
+// the fallback for inexact inputs (error <= 4.9e-13)
+#define CR_APPROX_DENOMINATOR 1015933059570LL
+
+static const uint8_t approx_denominators[MAX_TUPLES] = {247, 251, 253, 254, 255};
+
+// Primes up to MAX_DENOMINATOR: the only ones an antichain denominator has
+static const uint8_t small_primes[] = {
+      2,   3,   5,   7,  11,  13,  17,  19,  23,  29,  31,  37,  41,  43,  47,  53,
+     59,  61,  67,  71,  73,  79,  83,  89,  97, 101, 103, 107, 109, 113, 127, 131,
+    137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+    227, 229, 233, 239, 241, 251,
+};
+
+// ============================================================================
+// OPTIMAL ENCODING
+// ============================================================================
+
+/**
+ * Search state for one fraction p/q, 0 < p < q
+ *
+ * q is split into prime powers f_j. A set of denominators can hold p/q
+ * exactly only if every f_j divides one of them, and conversely any such
+ * cover works: p/q splits by partial fractions into a_j/f_j (mod 1) and
+ * each part is carried by a denominator that f_j divides. The minimal tuple
+ * count is therefore the smallest cover, found over bitmasks of the f_j.
+ */
+typedef struct {
+    int count;                                  // Number of prime powers
+    uint32_t factors[CR_MAX_PRIME_POWERS];      // f_j
+    uint32_t partials[CR_MAX_PRIME_POWERS];     // a_j with p/q = sum a_j/f_j (mod 1)
+    uint16_t full;                              // Mask with every f_j
+    int min_cover;                              // Lower bound on the cover size
+
+    int mask_count;                             // Distinct maximal masks
+    uint16_t masks[CR_DENOM_RANGE];
+    uint8_t mask_denoms[CR_DENOM_RANGE];        // Smallest denominator with each mask
+    int max_bits;                               // Largest popcount among masks
+    uint16_t compatible[CR_MAX_PRIME_POWERS];   // f_i that share some denominator with f_j
+
+    // Best cover found so far
+    int candidates;
+    int best_count;
+    int64_t best_excess;                        // Integer by which the tuples exceed p/q
+    uint8_t best_denoms[MAX_TUPLES];
+    uint8_t best_nums[MAX_TUPLES];
+} CoverSearch;
+
+static int popcount16(uint16_t x) {
+    int n = 0;
+    for (; x; x &= (uint16_t)(x - 1)) n++;
+    return n;
+}
+
+// Modular inverse of a mod m (gcd(a, m) = 1, m <= 255)
+static uint32_t inverse_mod(uint32_t a, uint32_t m) {
+    int32_t t = 0, new_t = 1;
+    int32_t r = (int32_t)m, new_r = (int32_t)(a % m);
+    while (new_r != 0) {
+        int32_t q = r / new_r;
+        int32_t tmp = t - q * new_t;
+        t = new_t;
+        new_t = tmp;
+        tmp = r - q * new_r;
+        r = new_r;
+        new_r = tmp;
+    }
+    return (uint32_t)(t < 0 ? t + (int32_t)m : t);
+}
+
+/**
+ * Split q into prime powers and p/q into partial fractions
+ * Returns false if q has a prime above MAX_DENOMINATOR, a prime power
+ * that no antichain denominator holds, or more primes above 15 than
+ * MAX_TUPLES: 17 * 17 > 255, so each denominator holds at most one.
+ */
+static bool factor_denominator(uint64_t p, uint64_t q, CoverSearch* s) {
+    uint64_t rest = q;
+    s->count = 0;
+    s->min_cover = 0;
+    for (size_t i = 0; i < sizeof(small_primes) && rest > 1; i++) {
+        uint32_t prime = small_primes[i];
+        if (rest % prime != 0) continue;
+        uint64_t f = 1;
+        while (rest % prime == 0) {
+            rest /= prime;
+            f *= prime;
+        }
+        if (f > MAX_DENOMINATOR) return false;
+        if (prime * prime > MAX_DENOMINATOR && ++s->min_cover > MAX_TUPLES) return false;
+        s->factors[s->count++] = (uint32_t)f;
+    }
+    if (rest != 1) return false;
+
+    for (int j = 0; j < s->count; j++) {
+        uint32_t f = s->factors[j];
+        uint32_t cofactor = (uint32_t)((q / f) % f);
+        s->partials[j] = (uint32_t)((p % f) * inverse_mod(cofactor, f) % f);
+    }
+    s->full = (uint16_t)((1u << s->count) - 1);
+    return true;
+}
+
+// Collect one mask per covering pattern, keeping only maximal ones
+static void collect_masks(CoverSearch* s) {
+    // Mark the multiples of each prime power instead of dividing every denominator
+    uint16_t by_denom[CR_DENOM_RANGE] = {0};
+    for (int j = 0; j < s->count; j++) {
+        uint32_t f = s->factors[j];
+        for (uint32_t d = (MIN_DENOMINATOR + f - 1) / f * f; d <= MAX_DENOMINATOR; d += f) {
+            by_denom[d - MIN_DENOMINATOR] |= (uint16_t)(1u << j);
+        }
+    }
+
+    // Distinct masks, each with the smallest denominator that has it
+    uint16_t slots[2 * CR_DENOM_RANGE] = {0};
+    uint16_t seen[CR_DENOM_RANGE];
+    uint8_t denoms[CR_DENOM_RANGE];
+    uint8_t bits[CR_DENOM_RANGE];
+    int n = 0;
+    for (int d = MIN_DENOMINATOR; d <= MAX_DENOMINATOR; d++) {
+        uint16_t mask = by_denom[d - MIN_DENOMINATOR];
+        if (mask == 0) continue;
+        size_t h = (mask * 40503u >> 8) % (2 * CR_DENOM_RANGE);
+        while (slots[h] != 0 && slots[h] != mask) {
+            h = (h + 1) % (2 * CR_DENOM_RANGE);
+        }
+        if (slots[h] == mask) continue;
+        slots[h] = mask;
+        seen[n] = mask;
+        denoms[n] = (uint8_t)d;
+        bits[n] = (uint8_t)popcount16(mask);
+        n++;
+    }
+
+    // Largest masks first: a mask is dominated only by a larger one, and
+    // then also by a maximal one already kept
+    s->mask_count = 0;
+    s->max_bits = 0;
+    for (int b = s->count; b > 0; b--) {
+        for (int i = 0; i < n; i++) {
+            if (bits[i] != b) continue;
+            bool dominated = false;
+            for (int k = 0; k < s->mask_count && !dominated; k++) {
+                dominated = (seen[i] & s->masks[k]) == seen[i];
+            }
+            if (dominated) continue;
+            s->masks[s->mask_count] = seen[i];
+            s->mask_denoms[s->mask_count] = denoms[i];
+            s->mask_count++;
+            if (b > s->max_bits) s->max_bits = b;
+        }
+    }
+
+    // Search order is by denominator, which decides ties between covers
+    for (int i = 1; i < s->mask_count; i++) {
+        for (int k = i; k > 0 && s->mask_denoms[k - 1] > s->mask_denoms[k]; k--) {
+            uint16_t m = s->masks[k]; s->masks[k] = s->masks[k - 1]; s->masks[k - 1] = m;
+            uint8_t d = s->mask_denoms[k]; s->mask_denoms[k] = s->mask_denoms[k - 1]; s->mask_denoms[k - 1] = d;
+        }
+    }
+
+    for (int j = 0; j < s->count; j++) {
+        s->compatible[j] = 0;
+        for (int i = 0; i < s->mask_count; i++) {
+            if (s->masks[i] & (1u << j)) s->compatible[j] |= s->masks[i];
+        }
+    }
+}
+
+/**
+ * Lower bound on the denominators still needed for the missing prime
+ * powers: greedily pick pairwise incompatible ones, which need one
+ * denominator each
+ */
+static int cover_lower_bound(const CoverSearch* s, uint16_t missing) {
+    int bound = 0;
+    for (int j = 0; j < s->count && missing; j++) {
+        if (missing & (1u << j)) {
+            missing &= (uint16_t)~s->compatible[j];
+            bound++;
+        }
+    }
+    return bound;
+}
+
+// Numerators for a chosen cover; records it if it beats the best so far
+static void evaluate_cover(CoverSearch* s, const int* chosen, int k, long double target) {
+    uint8_t denoms[MAX_TUPLES];
+    uint32_t nums[MAX_TUPLES] = {0};
+    uint16_t assigned = 0;
+    long double total = 0.0L;
+
+    for (int i = 0; i < k; i++) {
+        uint32_t d = s->mask_denoms[chosen[i]];
+        uint16_t mask = (uint16_t)(s->masks[chosen[i]] & ~assigned);
+        assigned |= mask;
+        for (int j = 0; j < s->count; j++) {
+            if (mask & (1u << j)) {
+                nums[i] = (nums[i] + s->partials[j] * (d / s->factors[j])) % d;
+            }
+        }
+        denoms[i] = (uint8_t)d;
+        total += (long double)nums[i] / d;
+    }
+
+    // The tuples equal p/q plus a whole number; that excess leaves the whole part
+    int64_t excess = llroundl(total - target);
+    s->candidates++;
+    if (s->best_count == 0 || excess < s->best_excess) {
+        s->best_count = k;
+        s->best_excess = excess;
+        for (int i = 0; i < k; i++) {
+            s->best_denoms[i] = denoms[i];
+            s->best_nums[i] = (uint8_t)nums[i];
+        }
+    }
+}
+
+/**
+ * Depth-first search for covers of exactly k denominators
+ * Every cover contains a denominator holding the lowest uncovered prime
+ * power, so only those are tried at each level. Returns true to stop.
+ */
+static bool search_covers(CoverSearch* s, uint16_t covered, int* chosen, int depth, int k, long double target) {
+    if (covered == s->full) {
+        evaluate_cover(s, chosen, depth, target);
+        return s->best_excess == 0 || s->candidates >= CR_MAX_COVER_CANDIDATES;
+    }
+    uint16_t missing = (uint16_t)(s->full & ~covered);
+    int by_size = (popcount16(missing) + s->max_bits - 1) / s->max_bits;
+    if (depth + by_size > k || depth + cover_lower_bound(s, missing) > k) {
+        return false;
+    }
+
+    uint16_t lowest = (uint16_t)(~covered & (covered + 1));
+    for (int i = 0; i < s->mask_count; i++) {
+        if (!(s->masks[i] & lowest)) continue;
+        chosen[depth] = i;
+        if (search_covers(s, (uint16_t)(covered | s->masks[i]), chosen, depth + 1, k, target)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Split n / CR_APPROX_DENOMINATOR over approx_denominators
+ * The denominators are pairwise coprime, so each numerator is one CRT
+ * coefficient; zero numerators are dropped. Returns the tuple count.
+ */
+static int split_approximation(int64_t n, uint8_t* denoms, uint8_t* nums, int64_t* excess) {
+    int count = 0;
+    long double total = 0.0L;
+    for (int i = 0; i < MAX_TUPLES; i++) {
+        uint32_t d = approx_denominators[i];
+        uint32_t cofactor = (uint32_t)((CR_APPROX_DENOMINATOR / d) % d);
+        uint32_t num = (uint32_t)((uint64_t)(n % d) * inverse_mod(cofactor, d) % d);
+        if (num == 0) continue;
+        denoms[count] = (uint8_t)d;
+        nums[count] = (uint8_t)num;
+        count++;
+        total += (long double)num / d;
+    }
+    *excess = llroundl(total - (long double)n / CR_APPROX_DENOMINATOR);
+    return count;
+}
+
+// Sort tuples by denominator and write them with the end flag
+static void store_tuples(CompactRational* cr, int32_t whole, const uint8_t* denoms, const uint8_t* nums, int count) {
+    uint8_t d[MAX_TUPLES];
+    uint8_t n[MAX_TUPLES];
+    memcpy(d, denoms, (size_t)count);
+    memcpy(n, nums, (size_t)count);
+    for (int i = 1; i < count; i++) {
+        for (int k = i; k > 0 && d[k - 1] > d[k]; k--) {
+            uint8_t t = d[k]; d[k] = d[k - 1]; d[k - 1] = t;
+            t = n[k]; n[k] = n[k - 1]; n[k - 1] = t;
+        }
+    }
+
+    cr_init(cr);
+    if (count == 0) {
+        cr->whole = (int16_t)(whole & 0x7FFF);  // Bit 15 = 0 (no tuples)
+        return;
+    }
+    cr->whole = (int16_t)((whole & 0x7FFF) | 0x8000);
+    for (int i = 0; i < count; i++) {
+        uint8_t denom_byte = (uint8_t)((d[i] - MIN_DENOMINATOR) | (i == count - 1 ? 0x80 : 0x00));
+        cr->tuples[i] = (uint16_t)(((uint16_t)n[i] << 8) | denom_byte);
+    }
+}
+
+/**
+ * Exact encoding of the fraction p/q, 0 < p < q, reduced
+ * Returns false if it needs more than MAX_TUPLES tuples; otherwise the
+ * tuples sum to p/q + excess.
+ */
+static bool encode_fraction(uint64_t p, uint64_t q, uint8_t* denoms, uint8_t* nums, int* count, int64_t* excess) {
+    if (q <= MAX_DENOMINATOR) {
+        // One tuple, straight from the table
+        denoms[0] = cr_antichain_denominator_table[q];
+        nums[0] = (uint8_t)(p * cr_antichain_scale_table[q]);
+        *count = 1;
+        *excess = 0;
+        return true;
+    }
+
+    if (q > (uint64_t)CR_MAX_COVER_LCM) {
+        return false;
+    }
+
+    CoverSearch s;
+    s.best_count = 0;
+    s.best_excess = 0;
+    s.candidates = 0;
+    if (!factor_denominator(p, q, &s)) {
+        return false;
+    }
+
+    collect_masks(&s);
+    int first_k = cover_lower_bound(&s, s.full);
+    if (first_k < s.min_cover) first_k = s.min_cover;
+    if (first_k < 2) first_k = 2;
+    if (first_k > MAX_TUPLES) {
+        return false;
+    }
+
+    long double target = (long double)p / (long double)q;
+    int chosen[MAX_TUPLES];
+    for (int k = first_k; k <= MAX_TUPLES && s.best_count == 0; k++) {
+        search_covers(&s, 0, chosen, 0, k, target);
+    }
+    if (s.best_count == 0) {
+        return false;
+    }
+
+    *count = s.best_count;
+    *excess = s.best_excess;
+    memcpy(denoms, s.best_denoms, (size_t)s.best_count);
+    memcpy(nums, s.best_nums, (size_t)s.best_count);
+    return true;
+}
+
+// Tuples an exact encoding of p/q (0 < p < q, reduced) needs, or -1
+int cr_exact_tuple_count(uint64_t p, uint64_t q) {
+    uint8_t denoms[MAX_TUPLES];
+    uint8_t nums[MAX_TUPLES];
+    int count;
+    int64_t excess;
+    return encode_fraction(p, q, denoms, nums, &count, &excess) ? count : -1;
+}
+
+/**
+ * Build whole + rem/denom (0 <= rem < denom, reduced); with try_exact false
+ * the fraction goes straight to the rounded CRT split. Clamping and
+ * inexactness are reported for op.
+ */
+static CompactRational encode_parts(int64_t whole, uint64_t rem, uint64_t denom, bool try_exact,
+                                    CROperation op, CRError* error) {
+    CompactRational cr;
+    uint8_t denoms[MAX_TUPLES];
+    uint8_t nums[MAX_TUPLES];
+    int count = 0;
+    int64_t excess = 0;
+    bool exact = try_exact;
+
+    if (rem != 0 && !(try_exact && encode_fraction(rem, denom, denoms, nums, &count, &excess))) {
+        // Round to the nearest fraction over CR_APPROX_DENOMINATOR, which always fits
+        exact = false;
+        int64_t n = llroundl((long double)rem / denom * CR_APPROX_DENOMINATOR);
+        count = split_approximation(n, denoms, nums, &excess);
+    }
+    whole -= excess;
+
+    // A value both rounded and clamped reports the clamp, the larger error;
+    // the inexact flag is still set
+    int32_t clamped = cr_clamp_whole(whole, op, error);
+    if (!exact && clamped == whole) {
+        cr_report(error, CR_ERROR_INEXACT, op, count, MAX_TUPLES);
+    } else if (!exact) {
+        cr_report_flag(CR_ERROR_INEXACT);
+    }
+
+    store_tuples(&cr, clamped, denoms, nums, count);
+    return cr;
+}
+
+// Encode num/denom with the fewest tuples that represent it exactly
+CompactRational cr_encode_optimal(int64_t num, int64_t denom, CRError* error) {
+    if (denom == 0) {
+        CompactRational cr;
+        cr_init(&cr);
+        cr_report(error, CR_ERROR_DIVISION_BY_ZERO, CR_OP_ENCODE_OPTIMAL, cr_saturate_i32(num), 0);
+        return cr;
+    }
+
+    // Negating INT64_MIN overflows int64: normalize and reduce in 128 bits
+    if (num == INT64_MIN || denom == INT64_MIN) {
+        return cr_encode_wide(num, denom, CR_OP_ENCODE_OPTIMAL, error);
+    }
+
+    Rational r = {num, denom};
+    reduce_rational(&r);
+
+    // Floor semantics: whole part plus a fraction in [0, 1)
+    int64_t whole = r.numerator / r.denominator;
+    int64_t rem = r.numerator % r.denominator;
+    if (rem < 0) {
+        rem += r.denominator;
+        whole -= 1;
+    }
+    return encode_parts(whole, (uint64_t)rem, (uint64_t)r.denominator, true, CR_OP_ENCODE_OPTIMAL, error);
+}
+
+// Trailing zero bits of a nonzero 128-bit value
+static int ctz_wide(unsigned __int128 x) {
+    uint64_t lo = (uint64_t)x;
+    return lo != 0 ? __builtin_ctzll(lo) : 64 + __builtin_ctzll((uint64_t)(x >> 64));
+}
+
+// Binary gcd on 128-bit magnitudes: shifts and subtractions, no 128-bit division
+static unsigned __int128 gcd_wide(unsigned __int128 a, unsigned __int128 b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    int shift = ctz_wide(a | b);
+    a >>= ctz_wide(a);
+    while (b != 0) {
+        b >>= ctz_wide(b);
+        if (a > b) {
+            unsigned __int128 t = a;
+            a = b;
+            b = t;
+        }
+        b -= a;
+    }
+    return a << shift;
+}
+
+// cr_encode_optimal for 128-bit intermediates; denom must not be zero
+CompactRational cr_encode_wide(__int128 num, __int128 denom, CROperation op, CRError* error) {
+    if (denom < 0) {
+        num = -num;
+        denom = -denom;
+    }
+    unsigned __int128 g = gcd_wide(num < 0 ? -(unsigned __int128)num : (unsigned __int128)num,
+                                   (unsigned __int128)denom);
+    num /= (__int128)g;
+    denom /= (__int128)g;
+
+    __int128 whole = num / denom;
+    __int128 rem = num % denom;
+    if (rem < 0) {
+        rem += denom;
+        whole -= 1;
+    }
+    int64_t whole64 = whole > INT64_MAX ? INT64_MAX : whole < INT64_MIN ? INT64_MIN : (int64_t)whole;
+
+    if (denom <= (__int128)UINT64_MAX) {
+        return encode_parts(whole64, (uint64_t)rem, (uint64_t)denom, true, op, error);
+    }
+
+    // No antichain set divides a denominator this large: round it first
+    int64_t n = llroundl((long double)rem / (long double)denom * CR_APPROX_DENOMINATOR);
+    return encode_parts(whole64, (uint64_t)n, (uint64_t)CR_APPROX_DENOMINATOR, false, op, error);
+}
@@ -0,0 +1,189 @@
+#include "compact_rational_internal.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// ERROR REPORTING
+// ============================================================================
+
+// Per-thread sticky flags and the most recent failure
+static __thread uint32_t thread_error_flags = 0;
+static __thread CRStatus thread_last_error = {CR_SUCCESS, CR_OP_NONE, 0, 0, 0};
+
+// Set a failure's sticky flag without making it the last one
+void cr_report_flag(CRErrorCode code) {
+    thread_error_flags |= CR_ERROR_FLAG(code);
+    if (code == CR_ERROR_VALUE_CLAMPED) {
+        CR_STAT_INC(CR_STAT_CLAMPED);
+    } else if (code == CR_ERROR_INEXACT) {
+        CR_STAT_INC(CR_STAT_INEXACT);
+    }
+}
+
+// Record a failure; the message is only formatted if a CRError wants it
+void cr_report(CRError* error, CRErrorCode code, CROperation op, int32_t value1, int32_t value2) {
+    CRStatus status = {code, (uint16_t)op, 0, value1, value2};
+    thread_last_error = status;
+    cr_report_flag(code);
+    if (code == CR_ERROR_VALUE_CLAMPED && (op == CR_OP_ADD || op == CR_OP_SUB)) {
+        CR_STAT_INC(CR_STAT_ADD_CLAMPED);
+    }
+
+    if (error != NULL) {
+        error->code = code;
+        error->value1 = value1;
+        error->value2 = value2;
+        cr_error_format(error->message, sizeof(error->message), &status);
+    }
+}
+
+// Short name of an error code
+static const char* code_description(CRErrorCode code) {
+    switch (code) {
+        case CR_SUCCESS: return "Success";
+        case CR_ERROR_DIVISION_BY_ZERO: return "Division by zero";
+        case CR_ERROR_VALUE_CLAMPED: return "Value clamped";
+        case CR_ERROR_OVERFLOW: return "Arithmetic overflow";
+        case CR_ERROR_INVALID_DENOMINATOR: return "Invalid denominator";
+        case CR_ERROR_TUPLE_BOUNDS: return "Tuple bounds exceeded";
+        case CR_ERROR_OUT_OF_MEMORY: return "Out of memory";
+        case CR_ERROR_OUT_OF_BOUNDS: return "Index out of bounds";
+        case CR_ERROR_INVALID_ENCODING: return "Invalid encoding";
+        case CR_ERROR_INEXACT: return "Inexact encoding";
+        case CR_ERROR_IO: return "I/O error";
+        case CR_ERROR_SYNTAX: return "Syntax error";
+    }
+    return "Unknown error";
+}
+
+// Description of a malformed column file
+static const char* file_fault_description(int32_t fault) {
+    switch (fault) {
+        case CR_FILE_BAD_MAGIC: return "not a column file";
+        case CR_FILE_BAD_VERSION: return "unsupported format version";
+        case CR_FILE_BAD_LAYOUT: return "sections do not fit the file";
+        case CR_FILE_BAD_STRIDE: return "offset index stride differs from CR_PACKED_INDEX_STRIDE";
+        case CR_FILE_BAD_STREAM: return "stream does not match its tables";
+        case CR_FILE_BIG_ENDIAN: return "little-endian host required";
+    }
+    return "unknown fault";
+}
+
+// Format the message for a status record
+size_t cr_error_format(char* buf, size_t cap, const CRStatus* status) {
+    int32_t v1 = status->value1;
+    int32_t v2 = status->value2;
+    int n;
+
+    switch (status->code) {
+        case CR_ERROR_VALUE_CLAMPED:
+            n = snprintf(buf, cap, "%s %d %s (%d), clamping to %d",
+                         status->op == CR_OP_FROM_INT ? "Value" : "Whole part", v1,
+                         v2 > 0 ? "exceeds MAX_WHOLE_VALUE" : "below MIN_WHOLE_VALUE", v2, v2);
+            break;
+        case CR_ERROR_DIVISION_BY_ZERO:
+            n = snprintf(buf, cap, "Division by zero (numerator=%d, denominator=%d)", v1, v2);
+            break;
+        case CR_ERROR_INVALID_DENOMINATOR:
+            n = snprintf(buf, cap, "Invalid denominator (zero) in rational conversion");
+            break;
+        case CR_ERROR_OVERFLOW:
+            n = snprintf(buf, cap, "Overflow in %s - result exceeds int32_t range",
+                         status->op == CR_OP_ADD ? "addition" : "arithmetic");
+            break;
+        case CR_ERROR_OUT_OF_MEMORY:
+            if (status->op == CR_OP_CACHE_INIT) {
+                n = snprintf(buf, cap, "Failed to allocate %d cache entries", v1);
+            } else if (status->op == CR_OP_FILE_WRITE) {
+                n = snprintf(buf, cap, "Failed to allocate %d bytes for column file writer", v1);
+            } else if (status->op == CR_OP_COLUMN_APPEND || status->op == CR_OP_ZONE_MAP || status->op == CR_OP_DELTA ||
+                       status->op == CR_OP_COUNT_MAP) {
+                n = snprintf(buf, cap, "Failed to allocate %d bytes for %s", v1,
+                             status->op == CR_OP_ZONE_MAP ? "zone map" : status->op == CR_OP_DELTA ? "delta stream"
+                             : status->op == CR_OP_COUNT_MAP ? "count map" : "column");
+            } else if (status->op == CR_OP_PIPELINE) {
+                n = snprintf(buf, cap, "Failed to allocate %d bytes of pipeline buffers", v1);
+            } else if (status->op == CR_OP_ARENA) {
+                n = snprintf(buf, cap, "Failed to allocate %d-byte arena block", v1);
+            } else if (status->op == CR_OP_SORT || status->op == CR_OP_TOPK || status->op == CR_OP_HISTOGRAM) {
+                n = snprintf(buf, cap, "Failed to allocate %d bytes of %s scratch", v1,
+                             status->op == CR_OP_SORT ? "sort" : status->op == CR_OP_TOPK ? "top-k" : "histogram");
+            } else {
+                n = snprintf(buf, cap, "Failed to allocate %d %s for packed array", v1,
+                             v2 ? "index entries" : "bytes");
+            }
+            break;
+        case CR_ERROR_OUT_OF_BOUNDS:
+            if (status->op == CR_OP_COLUMN_APPEND) {
+                n = snprintf(buf, cap, "Column dictionary full (%d patterns); row %d not appended", v2, v1);
+            } else if (status->op == CR_OP_COUNT_MAP) {
+                n = snprintf(buf, cap, "Count map full (%d slots)", v1);
+            } else if (status->op == CR_OP_FILTER) {
+                n = snprintf(buf, cap, "Zone map covers %d values, packed array has %d", v1, v2);
+            } else {
+                n = snprintf(buf, cap, "%s %d out of range for %s of %d values",
+                             status->op == CR_OP_UNPACK_ARRAY ? "Start index" : "Index", v1,
+                             status->op == CR_OP_COLUMN_GET ? "column" : "packed array", v2);
+            }
+            break;
+        case CR_ERROR_INVALID_ENCODING:
+            if (status->op == CR_OP_FILE_OPEN) {
+                n = v1 == CR_FILE_BAD_STREAM
+                    ? snprintf(buf, cap, "Malformed column file: %s (value %d)", file_fault_description(v1), v2)
+                    : snprintf(buf, cap, "Malformed column file: %s", file_fault_description(v1));
+            } else if (status->op == CR_OP_DELTA) {
+                n = snprintf(buf, cap, "Malformed delta block at byte %d", v1);
+            } else if (status->op == CR_OP_VIEW) {
+                n = snprintf(buf, cap, "Malformed packed value at index %d (byte %d)", v1, v2);
+            } else {
+                n = snprintf(buf, cap, "Malformed packed value at index %d", v1);
+            }
+            break;
+        case CR_ERROR_TUPLE_BOUNDS:
+            if (status->op == CR_OP_SUM) {
+                n = snprintf(buf, cap, "Sum needs %d tuples, exceeds MAX_TUPLES (%d); fraction approximated", v1, v2);
+            } else {
+                n = snprintf(buf, cap, "%d values have no end flag within MAX_TUPLES (first at index %d)", v1, v2);
+            }
+            break;
+        case CR_ERROR_INEXACT:
+            n = status->op == CR_OP_APPROXIMATE
+                ? snprintf(buf, cap, "Target not exact within %d tuples; approximated with %d", v2, v1)
+                : snprintf(buf, cap, "No exact encoding within MAX_TUPLES (%d); approximated with %d tuples", v2, v1);
+            break;
+        case CR_ERROR_IO:
+            n = snprintf(buf, cap, "Could not %s column file (errno %d)",
+                         status->op == CR_OP_FILE_WRITE ? "write" : "open", v1);
+            break;
+        case CR_ERROR_SYNTAX:
+            n = snprintf(buf, cap, "Not a number in field %d (byte %d)", v1, v2);
+            break;
+        default:
+            n = snprintf(buf, cap, "%s", code_description(status->code));
+            break;
+    }
+    return n < 0 ? 0 : (size_t)n;
+}
+
+// Error codes seen by this thread since the last clear
+uint32_t cr_error_flags(void) {
+    return thread_error_flags;
+}
+
+// Most recent failure on this thread
+CRStatus cr_last_error(void) {
+    return thread_last_error;
+}
+
+// Put back flags and a last failure saved before a cr_error_clear()
+void cr_error_restore(uint32_t flags, CRStatus last) {
+    thread_error_flags = flags;
+    thread_last_error = last;
+}
+
+// Reset this thread's sticky flags and last failure
+void cr_error_clear(void) {
+    CRStatus none = {CR_SUCCESS, CR_OP_NONE, 0, 0, 0};
+    thread_error_flags = 0;
+    thread_last_error = none;
+}
@@ -0,0 +1,426 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "compact_rational_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Every section starts on this boundary
+#define CR_FILE_ALIGN 64
+
+static const char file_magic[8] = {'C', 'R', 'C', 'O', 'L', 'U', 'M', 'N'};
+
+// ============================================================================
+// SHARED HELPERS
+// ============================================================================
+
+// Sections are used in place, so the host must match the file's byte order
+static bool host_is_little_endian(void) {
+    uint16_t probe = 1;
+    uint8_t first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+static uint64_t align_up(uint64_t offset) {
+    return (offset + CR_FILE_ALIGN - 1) / CR_FILE_ALIGN * CR_FILE_ALIGN;
+}
+
+static size_t index_entries(uint64_t count) {
+    return (size_t)((count + CR_PACKED_INDEX_STRIDE - 1) / CR_PACKED_INDEX_STRIDE);
+}
+
+static size_t bitmap_words(uint64_t count) {
+    return (size_t)((count + 63) / 64);
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+// Grow a table to hold at least needed elements, zeroing the new tail;
+// returns the (possibly moved) table, or NULL if allocation failed
+static void* grow_table(void* table, size_t* capacity, size_t needed, size_t elem_size) {
+    if (needed <= *capacity) {
+        return table;
+    }
+    size_t grown = *capacity > 0 ? *capacity : 16;
+    while (grown < needed) {
+        grown *= 2;
+    }
+    uint8_t* p = realloc(table, grown * elem_size);
+    if (p == NULL) {
+        return NULL;
+    }
+    memset(p + *capacity * elem_size, 0, (grown - *capacity) * elem_size);
+    *capacity = grown;
+    return p;
+}
+
+static bool write_bytes(CRFileWriter* w, const void* buf, size_t n, CRError* error) {
+    if (n > 0 && fwrite(buf, 1, n, (FILE*)w->stream) != n) {
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_WRITE, errno, 0);
+        w->failed = true;
+        return false;
+    }
+    return true;
+}
+
+// Pad the file with zeros from offset up to the next section boundary
+static bool write_padding(CRFileWriter* w, uint64_t offset, CRError* error) {
+    static const uint8_t zeros[CR_FILE_ALIGN];
+    return write_bytes(w, zeros, (size_t)(align_up(offset) - offset), error);
+}
+
+static void release_writer(CRFileWriter* w) {
+    free(w->pending);
+    free(w->packed);
+    free(w->blocks);
+    free(w->index);
+    free(w->bitmap);
+    w->pending = NULL;
+    w->packed = NULL;
+    w->blocks = NULL;
+    w->index = NULL;
+    w->bitmap = NULL;
+}
+
+// Create a column file and stage an empty first block
+bool cr_file_writer_open(CRFileWriter* w, const char* path, uint32_t block_size, CRError* error) {
+    memset(w, 0, sizeof(*w));
+    w->block_size = block_size > 0 ? block_size : CR_FILE_DEFAULT_BLOCK_SIZE;
+
+    if (!host_is_little_endian()) {
+        cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_FILE_OPEN, CR_FILE_BIG_ENDIAN, 0);
+        return false;
+    }
+
+    w->pending = malloc((size_t)w->block_size * sizeof(CompactRational));
+    w->packed = malloc((size_t)w->block_size * CR_MAX_PACKED_SIZE);
+    if (w->pending == NULL || w->packed == NULL) {
+        release_writer(w);
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_FILE_WRITE,
+                  cr_saturate_i32((int64_t)w->block_size * CR_MAX_PACKED_SIZE), 0);
+        return false;
+    }
+
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL) {
+        release_writer(w);
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_WRITE, errno, 0);
+        return false;
+    }
+    w->stream = fp;
+
+    // Placeholder header; the real one is written by cr_file_writer_close
+    CRFileHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!write_bytes(w, &header, sizeof(header), error)) {
+        fclose(fp);
+        release_writer(w);
+        return false;
+    }
+
+    cr_report_success(error);
+    return true;
+}
+
+/**
+ * Write the staged block: statistics, bitmap bits and index entries are
+ * recorded in memory, the packed bytes go straight to the file
+ */
+static bool flush_block(CRFileWriter* w, CRError* error) {
+    size_t n = w->pending_count;
+    if (n == 0) {
+        return true;
+    }
+
+    uint64_t end = w->count + n;
+    CRFileBlock* blocks = grow_table(w->blocks, &w->block_capacity, w->block_count + 1, sizeof(CRFileBlock));
+    if (blocks != NULL) w->blocks = blocks;
+    uint64_t* index = grow_table(w->index, &w->index_capacity, index_entries(end), sizeof(uint64_t));
+    if (index != NULL) w->index = index;
+    uint64_t* bitmap = grow_table(w->bitmap, &w->bitmap_capacity, bitmap_words(end), sizeof(uint64_t));
+    if (bitmap != NULL) w->bitmap = bitmap;
+    if (blocks == NULL || index == NULL || bitmap == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_FILE_WRITE,
+                  cr_saturate_i32((int64_t)(bitmap_words(end) * sizeof(uint64_t))), 0);
+        w->failed = true;
+        return false;
+    }
+
+    CRFileBlock* block = &w->blocks[w->block_count];
+    cr_block_stats(block, w->pending, n);
+    block->offset = w->data_size;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+        const CompactRational* cr = &w->pending[i];
+        uint64_t global = w->count + i;
+        if (global % CR_PACKED_INDEX_STRIDE == 0) {
+            w->index[global / CR_PACKED_INDEX_STRIDE] = w->data_size + pos;
+        }
+        if (!(cr->whole & 0x8000)) {
+            w->bitmap[global / 64] |= (uint64_t)1 << (global % 64);
+        }
+        pos += cr_pack(cr, w->packed + pos, (size_t)w->block_size * CR_MAX_PACKED_SIZE - pos);
+    }
+
+    if (!write_bytes(w, w->packed, pos, error)) {
+        return false;
+    }
+    w->data_size += pos;
+    w->count = end;
+    w->block_count++;
+    w->pending_count = 0;
+    return true;
+}
+
+// Stage values, writing each block as it fills
+bool cr_file_writer_append(CRFileWriter* w, const CompactRational* values, size_t n, CRError* error) {
+    if (w->failed) {
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_WRITE, 0, 0);
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        w->pending[w->pending_count++] = values[i];
+        if (w->pending_count == w->block_size && !flush_block(w, error)) {
+            return false;
+        }
+    }
+
+    cr_report_success(error);
+    return true;
+}
+
+// Write the last block, the tables and the final header
+bool cr_file_writer_close(CRFileWriter* w, CRError* error) {
+    FILE* fp = (FILE*)w->stream;
+    bool ok;
+    if (w->failed) {
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_WRITE, 0, 0);  // Failed in an earlier call
+        ok = false;
+    } else {
+        ok = flush_block(w, error);
+    }
+
+    CRFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, file_magic, sizeof(file_magic));
+    header.version = CR_FILE_VERSION;
+    header.header_size = sizeof(CRFileHeader);
+    header.count = w->count;
+    header.block_size = w->block_size;
+    header.index_stride = CR_PACKED_INDEX_STRIDE;
+    header.block_count = w->block_count;
+    header.data_offset = sizeof(CRFileHeader);
+    header.data_size = w->data_size;
+    header.blocks_offset = align_up(header.data_offset + header.data_size);
+    header.index_offset = align_up(header.blocks_offset + w->block_count * sizeof(CRFileBlock));
+    header.bitmap_offset = align_up(header.index_offset + index_entries(w->count) * sizeof(uint64_t));
+    header.file_size = header.bitmap_offset + bitmap_words(w->count) * sizeof(uint64_t);
+
+    ok = ok && write_padding(w, header.data_offset + header.data_size, error)
+            && write_bytes(w, w->blocks, w->block_count * sizeof(CRFileBlock), error)
+            && write_padding(w, header.blocks_offset + w->block_count * sizeof(CRFileBlock), error)
+            && write_bytes(w, w->index, index_entries(w->count) * sizeof(uint64_t), error)
+            && write_padding(w, header.index_offset + index_entries(w->count) * sizeof(uint64_t), error)
+            && write_bytes(w, w->bitmap, bitmap_words(w->count) * sizeof(uint64_t), error);
+
+    if (ok && fseek(fp, 0, SEEK_SET) != 0) {
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_WRITE, errno, 0);
+        ok = false;
+    }
+    ok = ok && write_bytes(w, &header, sizeof(header), error);
+
+    if (fclose(fp) != 0 && ok) {
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_WRITE, errno, 0);
+        ok = false;
+    }
+    w->stream = NULL;
+    release_writer(w);
+
+    if (ok) {
+        cr_report_success(error);
+    }
+    return ok;
+}
+
+// Stream a packed array through a writer, one decoded chunk at a time
+bool cr_file_write_packed(const char* path, const CRPackedArray* pa, uint32_t block_size, CRError* error) {
+    CRFileWriter w;
+    if (!cr_file_writer_open(&w, path, block_size, error)) {
+        return false;
+    }
+
+    CompactRational chunk[1024];
+    bool ok = true;
+    for (size_t start = 0; ok && start < pa->count; start += 1024) {
+        size_t n = cr_unpack_array(pa, start, 1024, chunk, error);
+        ok = n > 0 && cr_file_writer_append(&w, chunk, n, error);
+    }
+
+    if (!ok) {
+        CRError ignored;
+        cr_file_writer_close(&w, &ignored);  // Keep the first error
+        return false;
+    }
+    return cr_file_writer_close(&w, error);
+}
+
+// ============================================================================
+// READER
+// ============================================================================
+
+// A section of bytes at offset lies inside the mapping (8-byte aligned if asked)
+static bool section_fits(uint64_t offset, uint64_t bytes, size_t map_size, bool aligned) {
+    if (aligned && offset % sizeof(uint64_t) != 0) return false;
+    return offset <= map_size && bytes <= map_size - offset;
+}
+
+// Header and section checks: constant time, independent of file size
+static CRFileFault check_layout(const CRFileHeader* h, size_t map_size) {
+    if (memcmp(h->magic, file_magic, sizeof(file_magic)) != 0) return CR_FILE_BAD_MAGIC;
+    if (h->version != CR_FILE_VERSION || h->header_size != sizeof(CRFileHeader)) return CR_FILE_BAD_VERSION;
+    if (h->index_stride != CR_PACKED_INDEX_STRIDE) return CR_FILE_BAD_STRIDE;
+
+    if (h->file_size != map_size || h->block_size == 0) return CR_FILE_BAD_LAYOUT;
+    if (h->count > map_size / 2) return CR_FILE_BAD_LAYOUT;  // Every value takes at least 2 bytes
+    if (h->block_count != (h->count + h->block_size - 1) / h->block_size) return CR_FILE_BAD_LAYOUT;
+    if (h->data_size < 2 * h->count || h->data_size > CR_MAX_PACKED_SIZE * h->count) return CR_FILE_BAD_LAYOUT;
+
+    if (!section_fits(h->data_offset, h->data_size, map_size, false) ||
+        !section_fits(h->blocks_offset, h->block_count * sizeof(CRFileBlock), map_size, true) ||
+        !section_fits(h->index_offset, index_entries(h->count) * sizeof(uint64_t), map_size, true) ||
+        !section_fits(h->bitmap_offset, bitmap_words(h->count) * sizeof(uint64_t), map_size, true)) {
+        return CR_FILE_BAD_LAYOUT;
+    }
+    return 0;
+}
+
+/**
+ * Full check for CR_FILE_VERIFY: walk the stream once and compare every
+ * value with its index entry, bitmap bit and block. On failure *bad is the
+ * index of the first inconsistent value (count if the stream has bytes
+ * left over).
+ */
+static bool verify_stream(const CRFile* f, size_t* bad) {
+    const CRPackedArray* pa = &f->values;
+    uint32_t block_size = f->header->block_size;
+    size_t pos = 0;
+
+    for (size_t i = 0; i < pa->count; i++) {
+        *bad = i;
+        if (i % CR_PACKED_INDEX_STRIDE == 0 && pa->index[i / CR_PACKED_INDEX_STRIDE] != pos) return false;
+        if (i % block_size == 0) {
+            const CRFileBlock* b = &f->blocks[i / block_size];
+            size_t expected = pa->count - i < block_size ? pa->count - i : block_size;
+            if (b->offset != pos || b->count != expected) return false;
+        }
+
+        size_t len = cr_packed_length(pa->data + pos, pa->size - pos);
+        if (len == 0) return false;
+        if (cr_file_is_integer(f, i) != (len == 2)) return false;
+        pos += len;
+    }
+
+    *bad = pa->count;
+    return pos == pa->size;
+}
+
+// Map a column file and point the view and tables into the mapping
+bool cr_file_open(CRFile* f, const char* path, uint32_t flags, CRError* error) {
+    memset(f, 0, sizeof(*f));
+    cr_packed_init(&f->values);
+
+    if (!host_is_little_endian()) {
+        cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_FILE_OPEN, CR_FILE_BIG_ENDIAN, 0);
+        return false;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_OPEN, errno, 0);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_OPEN, errno, 0);
+        close(fd);
+        return false;
+    }
+    if ((uint64_t)st.st_size < sizeof(CRFileHeader)) {
+        close(fd);
+        cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_FILE_OPEN,
+                  st.st_size >= (off_t)sizeof(file_magic) ? CR_FILE_BAD_LAYOUT : CR_FILE_BAD_MAGIC, 0);
+        return false;
+    }
+
+    size_t map_size = (size_t)st.st_size;
+    void* map = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    int map_errno = errno;
+    close(fd);  // The mapping keeps the file alive
+    if (map == MAP_FAILED) {
+        cr_report(error, CR_ERROR_IO, CR_OP_FILE_OPEN, map_errno, 0);
+        return false;
+    }
+
+    const uint8_t* base = (const uint8_t*)map;
+    const CRFileHeader* header = (const CRFileHeader*)map;
+    CRFileFault fault = check_layout(header, map_size);
+    if (fault != 0) {
+        munmap(map, map_size);
+        cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_FILE_OPEN, fault, 0);
+        return false;
+    }
+
+    f->map = base;
+    f->map_size = map_size;
+    f->header = header;
+    f->blocks = (const CRFileBlock*)(base + header->blocks_offset);
+    f->integer_bitmap = (const uint64_t*)(base + header->bitmap_offset);
+    f->block_count = (size_t)header->block_count;
+
+    // The view is never written: cr_packed_reserve copies before growing it
+    f->values.data = (uint8_t*)(base + header->data_offset);
+    f->values.size = (size_t)header->data_size;
+    f->values.capacity = (size_t)header->data_size;
+    f->values.count = (size_t)header->count;
+    f->values.index = (uint64_t*)(base + header->index_offset);
+    f->values.index_capacity = index_entries(header->count);
+    f->values.view = true;
+
+    if (flags & CR_FILE_VERIFY) {
+        size_t bad;
+        if (!verify_stream(f, &bad)) {
+            cr_file_close(f);
+            cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_FILE_OPEN, CR_FILE_BAD_STREAM,
+                      cr_saturate_i32((int64_t)bad));
+            return false;
+        }
+    }
+
+    cr_report_success(error);
+    return true;
+}
+
+// Unmap and reset
+void cr_file_close(CRFile* f) {
+    if (f->map != NULL) {
+        munmap((void*)f->map, f->map_size);
+    }
+    memset(f, 0, sizeof(*f));
+    cr_packed_init(&f->values);
+}
+
+// Random access through the view
+CompactRational cr_file_get(const CRFile* f, size_t i, CRError* error) {
+    return cr_packed_get(&f->values, i, error);
+}
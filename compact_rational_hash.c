@@ -0,0 +1,381 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "compact_rational_internal.h"
+#include "antichain_table.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// The prime 2^61 - 1 that cr_hash evaluates values modulo
+#define HASH_PRIME (((uint64_t)1 << 61) - 1)
+
+// Slot states of a CRCountSlot
+#define SLOT_EMPTY 0
+#define SLOT_WRITING 1
+#define SLOT_READY 2
+
+// Smallest count map table
+#define COUNT_MIN_SLOTS 16
+
+// Values decoded per block by a counting thread
+#define COUNT_BLOCK 256
+
+// Private table of a counting thread, flushed when half full
+#define COUNT_LOCAL_SLOTS 1024
+
+// Smallest slice worth handing to a thread of its own
+#define COUNT_MIN_CHUNK 16384
+
+// ============================================================================
+// HASHING AND EQUALITY
+// ============================================================================
+
+// a * b mod 2^61 - 1, for a, b below the prime
+static inline uint64_t mul_mod(uint64_t a, uint64_t b) {
+    unsigned __int128 product = (unsigned __int128)a * b;
+    uint64_t r = ((uint64_t)product & HASH_PRIME) + (uint64_t)(product >> 61);
+    return r >= HASH_PRIME ? r - HASH_PRIME : r;
+}
+
+// splitmix64 finalizer
+static inline uint64_t mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+// Value equality: same integer, else an exact comparison
+bool cr_equal(const CompactRational* a, const CompactRational* b) {
+    if (!((a->whole | b->whole) & 0x8000)) {
+        return ((a->whole ^ b->whole) & 0x7FFF) == 0;
+    }
+    return cr_cmp(a, b) == 0;
+}
+
+// Hash of the value modulo 2^61 - 1
+uint64_t cr_hash(const CompactRational* cr) {
+    int32_t whole = cr_whole_value(cr->whole);
+    uint64_t h = whole < 0 ? HASH_PRIME - (uint64_t)-whole : (uint64_t)whole;
+    if (cr->whole & 0x8000) {
+        // Same walk as cr_to_rational: stop at the end flag or MAX_TUPLES
+        for (int t = 0; t < MAX_TUPLES; t++) {
+            uint16_t tuple = cr->tuples[t];
+            h += mul_mod(tuple >> 8, cr_hash_inverse_table[tuple & 0x7F]);
+            h = h >= HASH_PRIME ? h - HASH_PRIME : h;
+            if (tuple & 0x80) {
+                break;
+            }
+        }
+    }
+    return mix(h);
+}
+
+// The encoding as two words, tuples after the end flag cleared
+static inline void encoding_words(const CompactRational* cr, uint64_t words[2]) {
+    uint16_t t[MAX_TUPLES] = {0};
+    if (cr->whole & 0x8000) {
+        for (int i = 0; i < MAX_TUPLES; i++) {
+            t[i] = cr->tuples[i];
+            if (t[i] & 0x80) {
+                break;
+            }
+        }
+    }
+    words[0] = (uint64_t)(uint16_t)cr->whole | (uint64_t)t[0] << 16 | (uint64_t)t[1] << 32 | (uint64_t)t[2] << 48;
+    words[1] = (uint64_t)t[3] | (uint64_t)t[4] << 16;
+}
+
+// Hash of the encoding
+uint64_t cr_hash_bits(const CompactRational* cr) {
+    uint64_t words[2];
+    encoding_words(cr, words);
+    return mix(words[0] ^ mix(words[1] + 0x9E3779B97F4A7C15ull));
+}
+
+// ============================================================================
+// COUNT MAP
+// ============================================================================
+
+static inline uint64_t key_hash(uint32_t flags, const CompactRational* cr) {
+    return flags & CR_COUNT_CANONICAL ? cr_hash_bits(cr) : cr_hash(cr);
+}
+
+static inline bool keys_equal(uint32_t flags, const CompactRational* a, const CompactRational* b) {
+    if (flags & CR_COUNT_CANONICAL) {
+        uint64_t wa[2], wb[2];
+        encoding_words(a, wa);
+        encoding_words(b, wb);
+        return wa[0] == wb[0] && wa[1] == wb[1];
+    }
+    return cr_equal(a, b);
+}
+
+// Initialize an empty map of at least twice capacity slots
+bool cr_count_map_init(CRCountMap* map, size_t capacity, uint32_t flags, CRError* error) {
+    size_t slots = COUNT_MIN_SLOTS;
+    while (slots < 2 * capacity) {
+        slots *= 2;
+    }
+
+    map->flags = flags;
+    map->size = 0;
+    map->slots = calloc(slots, sizeof(CRCountSlot));
+    if (map->slots == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_COUNT_MAP, cr_saturate_i32((int64_t)(slots * sizeof(CRCountSlot))), 0);
+        map->mask = 0;
+        return false;
+    }
+    map->mask = slots - 1;
+    cr_report_success(error);
+    return true;
+}
+
+// Release the table
+void cr_count_map_free(CRCountMap* map) {
+    free(map->slots);
+    map->slots = NULL;
+    map->mask = 0;
+    map->size = 0;
+}
+
+/**
+ * Slot holding cr's value, claiming an empty one if it is new; NULL if
+ * the table is full. A slot whose key is being written is waited for: the
+ * writer only copies a 12-byte key before publishing it.
+ */
+static CRCountSlot* find_or_claim(CRCountMap* map, const CompactRational* cr, uint64_t h) {
+    if (map->slots == NULL) {
+        return NULL;
+    }
+    for (size_t probe = 0; probe <= map->mask; probe++) {
+        CRCountSlot* s = &map->slots[(h + probe) & map->mask];
+        uint32_t state = __atomic_load_n(&s->state, __ATOMIC_ACQUIRE);
+        if (state == SLOT_EMPTY) {
+            if (__atomic_compare_exchange_n(&s->state, &state, SLOT_WRITING, false, __ATOMIC_ACQUIRE,
+                                            __ATOMIC_ACQUIRE)) {
+                s->hash = h;
+                s->key = *cr;
+                __atomic_store_n(&s->state, SLOT_READY, __ATOMIC_RELEASE);
+                __atomic_fetch_add(&map->size, 1, __ATOMIC_RELAXED);
+                return s;
+            }
+            // Lost the race: state now holds what the winner stored
+        }
+        while (state == SLOT_WRITING) {
+            state = __atomic_load_n(&s->state, __ATOMIC_ACQUIRE);
+        }
+        if (s->hash == h && keys_equal(map->flags, &s->key, cr)) {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static bool add_hashed(CRCountMap* map, const CompactRational* cr, uint64_t h, uint64_t n, CRError* error) {
+    CRCountSlot* s = find_or_claim(map, cr, h);
+    if (s == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_BOUNDS, CR_OP_COUNT_MAP, cr_saturate_i32((int64_t)(map->mask + 1)), 0);
+        return false;
+    }
+    __atomic_fetch_add(&s->count, n, __ATOMIC_RELAXED);
+    return true;
+}
+
+// Add n to a value's count
+bool cr_count_map_add(CRCountMap* map, const CompactRational* cr, uint64_t n, CRError* error) {
+    if (!add_hashed(map, cr, key_hash(map->flags, cr), n, error)) {
+        return false;
+    }
+    cr_report_success(error);
+    return true;
+}
+
+// Count of a value; probing stops at the first empty slot
+uint64_t cr_count_map_get(const CRCountMap* map, const CompactRational* cr) {
+    if (map->slots == NULL) {
+        return 0;
+    }
+    uint64_t h = key_hash(map->flags, cr);
+    for (size_t probe = 0; probe <= map->mask; probe++) {
+        const CRCountSlot* s = &map->slots[(h + probe) & map->mask];
+        uint32_t state = __atomic_load_n(&s->state, __ATOMIC_ACQUIRE);
+        if (state == SLOT_EMPTY) {
+            return 0;
+        }
+        if (state == SLOT_READY && s->hash == h && keys_equal(map->flags, &s->key, cr)) {
+            return __atomic_load_n(&s->count, __ATOMIC_RELAXED);
+        }
+    }
+    return 0;
+}
+
+// Copy out the ready slots
+size_t cr_count_map_entries(const CRCountMap* map, CompactRational* keys, uint64_t* counts, size_t max) {
+    size_t copied = 0;
+    for (size_t i = 0; map->slots != NULL && i <= map->mask && copied < max; i++) {
+        const CRCountSlot* s = &map->slots[i];
+        if (__atomic_load_n(&s->state, __ATOMIC_ACQUIRE) != SLOT_READY) {
+            continue;
+        }
+        if (keys != NULL) keys[copied] = s->key;
+        if (counts != NULL) counts[copied] = __atomic_load_n(&s->count, __ATOMIC_RELAXED);
+        copied++;
+    }
+    return copied;
+}
+
+// ============================================================================
+// PARALLEL COUNTING
+// ============================================================================
+
+// Private pre-aggregation table of one counting thread
+typedef struct {
+    uint64_t hash[COUNT_LOCAL_SLOTS];
+    uint64_t count[COUNT_LOCAL_SLOTS];  // 0 = empty
+    CompactRational key[COUNT_LOCAL_SLOTS];
+    size_t used;
+} LocalCounts;
+
+typedef struct {
+    CRCountMap* map;
+    const CRPackedArray* pa;
+    size_t start;
+    size_t n;
+    bool ok;
+    CRStatus status;                  // The failure, when ok is false
+} CountWorker;
+
+// Move a thread's private counts into the shared map
+static bool flush_local(CRCountMap* map, LocalCounts* local) {
+    bool ok = true;
+    for (size_t i = 0; i < COUNT_LOCAL_SLOTS; i++) {
+        if (local->count[i] != 0) {
+            ok = ok && add_hashed(map, &local->key[i], local->hash[i], local->count[i], NULL);
+            local->count[i] = 0;
+        }
+    }
+    local->used = 0;
+    return ok;
+}
+
+static void* count_worker(void* arg) {
+    CountWorker* w = (CountWorker*)arg;
+    uint32_t flags = w->map->flags;
+    LocalCounts* local = calloc(1, sizeof(LocalCounts));
+    CompactRational block[COUNT_BLOCK];
+    w->ok = true;
+
+    for (size_t done = 0; w->ok && done < w->n; done += COUNT_BLOCK) {
+        size_t len = w->n - done < COUNT_BLOCK ? w->n - done : COUNT_BLOCK;
+        if (cr_unpack_array(w->pa, w->start + done, len, block, NULL) != len) {
+            w->ok = false;
+            break;
+        }
+        for (size_t i = 0; i < len && w->ok; i++) {
+            uint64_t h = key_hash(flags, &block[i]);
+            if (local == NULL) {
+                // No private table: count straight into the map
+                w->ok = add_hashed(w->map, &block[i], h, 1, NULL);
+                continue;
+            }
+            size_t slot = h & (COUNT_LOCAL_SLOTS - 1);
+            while (local->count[slot] != 0 &&
+                   !(local->hash[slot] == h && keys_equal(flags, &local->key[slot], &block[i]))) {
+                slot = (slot + 1) & (COUNT_LOCAL_SLOTS - 1);
+            }
+            if (local->count[slot] == 0) {
+                local->hash[slot] = h;
+                local->key[slot] = block[i];
+                local->used++;
+            }
+            local->count[slot]++;
+            if (local->used >= COUNT_LOCAL_SLOTS / 2) {
+                w->ok = flush_local(w->map, local);
+            }
+        }
+    }
+    if (local != NULL) {
+        w->ok = flush_local(w->map, local) && w->ok;
+        free(local);
+    }
+    if (!w->ok) {
+        w->status = cr_last_error();
+    }
+    return NULL;
+}
+
+// Number of threads to use for n values
+static int count_thread_count(size_t n, int threads) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    size_t useful = n / COUNT_MIN_CHUNK;
+    if (useful < (size_t)threads) {
+        threads = useful > 0 ? (int)useful : 1;
+    }
+    return threads;
+}
+
+// Count a packed column into map using several threads
+bool cr_count_packed(CRCountMap* map, const CRPackedArray* pa, int threads, CRError* error) {
+    size_t n = pa->count;
+    threads = count_thread_count(n, threads);
+    CountWorker single;
+    CountWorker* workers = threads > 1 ? malloc((size_t)threads * sizeof(CountWorker)) : NULL;
+    pthread_t* ids = workers != NULL ? malloc((size_t)threads * sizeof(pthread_t)) : NULL;
+    bool* started = ids != NULL ? calloc((size_t)threads, sizeof(bool)) : NULL;
+    if (started == NULL) {
+        // One thread requested, or no memory for bookkeeping: count inline
+        free(ids);
+        free(workers);
+        workers = &single;
+        threads = 1;
+    }
+
+    size_t chunk = n / (size_t)threads;
+    for (int t = 0; t < threads; t++) {
+        workers[t].map = map;
+        workers[t].pa = pa;
+        workers[t].start = (size_t)t * chunk;
+        workers[t].n = t == threads - 1 ? n - (size_t)t * chunk : chunk;
+
+        // Slice 0 runs on the calling thread; a failed create runs inline too
+        if (t > 0 && started != NULL && pthread_create(&ids[t], NULL, count_worker, &workers[t]) == 0) {
+            started[t] = true;
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        if (started == NULL || !started[t]) {
+            count_worker(&workers[t]);
+        }
+    }
+
+    // Report the failure of the earliest slice
+    const CRStatus* failure = NULL;
+    for (int t = 0; t < threads; t++) {
+        if (started != NULL && started[t]) {
+            pthread_join(ids[t], NULL);
+        }
+        if (!workers[t].ok && failure == NULL) {
+            failure = &workers[t].status;
+        }
+    }
+    bool ok = failure == NULL;
+    if (ok) {
+        cr_report_success(error);
+    } else {
+        cr_report(error, failure->code, (CROperation)failure->op, failure->value1, failure->value2);
+    }
+
+    if (workers != &single) {
+        free(workers);
+        free(ids);
+        free(started);
+    }
+    return ok;
+}
@@ -0,0 +1,221 @@
+#ifndef COMPACT_RATIONAL_INTERNAL_H
+#define COMPACT_RATIONAL_INTERNAL_H
+
+// Helpers shared between the library translation units.
+// Not part of the public API; do not include from programs.
+
+// The library defines the functions the CR_INLINE macros stand in for
+#define CR_BUILDING_LIBRARY 1
+
+#include "compact_rational.h"
+#include <string.h>
+
+// Number of antichain denominators (128..255)
+#define CR_DENOM_RANGE (MAX_DENOMINATOR - MIN_DENOMINATOR + 1)
+
+// Wide exact accumulator for column sums: the public CRAccumulator
+typedef CRAccumulator CRWideSum;
+
+/**
+ * Report a failure: sets the thread's sticky flag and last status, and
+ * fills error (formatting its message) when it is not NULL
+ */
+void cr_report(CRError* error, CRErrorCode code, CROperation op, int32_t value1, int32_t value2);
+
+/**
+ * Record a failure another one outranks (the inexact rounding of a value
+ * that was also clamped): sets the sticky flag, but leaves the last status
+ * and error to the failure that is reported
+ */
+void cr_report_flag(CRErrorCode code);
+
+/**
+ * Report success: a few stores, no formatting (no-op when error is NULL)
+ */
+static inline void cr_report_success(CRError* error) {
+    if (error != NULL) {
+        error->code = CR_SUCCESS;
+        memcpy(error->message, "Success", sizeof("Success"));
+        error->value1 = 0;
+        error->value2 = 0;
+    }
+}
+
+/**
+ * Set this thread's sticky flags and last failure, to put back what a
+ * batch saved before clearing them to watch its own rows
+ */
+void cr_error_restore(uint32_t flags, CRStatus last);
+
+// Saturate a size or 64-bit value into an int32_t context field
+static inline int32_t cr_saturate_i32(int64_t v) {
+    return v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : (int32_t)v;
+}
+
+/**
+ * Clamp a whole part to [MIN_WHOLE_VALUE, MAX_WHOLE_VALUE]
+ * Reports CR_ERROR_VALUE_CLAMPED for op (value1 = original, saturated to
+ * int32_t) or CR_SUCCESS.
+ */
+int32_t cr_clamp_whole(int64_t whole, CROperation op, CRError* error);
+
+/**
+ * Wide accumulator operations (compact_rational_sum.c)
+ */
+void cr_wide_sum_init(CRWideSum* acc);
+void cr_wide_sum_add_array(CRWideSum* acc, const CompactRational* values, size_t n);
+void cr_wide_sum_merge(CRWideSum* acc, const CRWideSum* other);
+int64_t cr_wide_sum_split(const CRWideSum* acc, CompactRational* fraction, int* needed);
+CompactRational cr_wide_sum_result(const CRWideSum* acc, CRError* error);
+void cr_wide_sum_parallel(const CompactRational* values, size_t n, int threads, CRWideSum* total);
+
+/**
+ * Fill the statistics of one block of n > 0 values (all but offset):
+ * count, integer count, min, max and the exact split sum
+ */
+void cr_block_stats(CRFileBlock* block, const CompactRational* values, size_t n);
+
+/**
+ * Canonical tuples of cr in out (whole bits clear, bit 15 set if any
+ * tuple remains); returns the unclamped whole part (compact_rational_lib.c)
+ */
+int64_t cr_canonical_parts(const CompactRational* cr, CompactRational* out);
+
+/**
+ * Signed value of bits 14-0 of a whole field
+ */
+static inline int32_t cr_whole_value(int16_t whole) {
+    return (int16_t)((uint16_t)whole << 1) >> 1;
+}
+
+/**
+ * Fraction part of a value without reduction
+ * The tuples sum to *num / *denom, where *denom is the product of the
+ * tuple denominators (below 255^5 < 2^40). Each tuple is under 2, so
+ * *num < 10 * *denom. Walks tuples exactly as cr_to_rational does.
+ */
+static inline void cr_fraction_parts(const CompactRational* cr, int64_t* num, int64_t* denom) {
+    int64_t n = 0, d = 1;
+    if (cr->whole & 0x8000) {
+        for (int i = 0; i < MAX_TUPLES; i++) {
+            int64_t td = MIN_DENOMINATOR + (cr->tuples[i] & 0x7F);
+            n = n * td + (int64_t)(cr->tuples[i] >> 8) * d;
+            d *= td;
+            if (cr->tuples[i] & 0x80) break;
+        }
+    }
+    *num = n;
+    *denom = d;
+}
+
+/**
+ * Encode num/denom from 128-bit intermediates (compact_rational_encode.c)
+ * Same result as cr_encode_optimal when the reduced fraction fits 64 bits;
+ * larger denominators are rounded and reported as CR_ERROR_INEXACT.
+ * Clamping and inexactness are reported for op. denom must not be zero.
+ */
+CompactRational cr_encode_wide(__int128 num, __int128 denom, CROperation op, CRError* error);
+
+/**
+ * Tuples the exact encoding of p/q needs (0 < p < q, reduced), or -1 if
+ * no set of MAX_TUPLES antichain denominators holds it
+ * (compact_rational_encode.c)
+ */
+int cr_exact_tuple_count(uint64_t p, uint64_t q);
+
+/**
+ * cr_format for an encoding whose whole field is whole_bits wide
+ * (compact_rational_text.c): whole is the decoded whole part, raw_whole
+ * the field itself (for CR_FORMAT_ENCODING).
+ */
+size_t cr_format_value(char* buf, size_t cap, int64_t whole, uint64_t raw_whole, int whole_bits,
+                       const uint16_t* tuples, uint32_t flags);
+
+/**
+ * Packed byte length of a value, read from the first bytes of a stream
+ * Returns 0 if the stream is truncated or has no end flag within MAX_TUPLES.
+ */
+static inline size_t cr_packed_length(const uint8_t* buf, size_t len) {
+    if (len < 2) return 0;
+    if (!(buf[1] & 0x80)) return 2;  // Bit 15 of whole clear: integer only
+
+    for (size_t i = 0; i < MAX_TUPLES; i++) {
+        size_t pos = 2 + 2 * i;
+        if (pos + 2 > len) return 0;
+        if (buf[pos] & 0x80) return pos + 2;  // End flag in denominator byte
+    }
+    return 0;
+}
+
+/**
+ * Byte offset of value i < pa->count in a packed array's stream
+ * (compact_rational_packed.c). Returns SIZE_MAX if the index entry lies
+ * past the stream or the skip from it meets a malformed value, which only
+ * an unverified file view can hold.
+ */
+size_t cr_packed_offset(const CRPackedArray* pa, size_t i);
+
+// ============================================================================
+// STATISTICS HOOKS
+// ============================================================================
+
+#if CR_ENABLE_STATS
+
+#if !defined(__x86_64__) && !defined(__i386__)
+#include <time.h>
+#endif
+
+/**
+ * One thread's counters (compact_rational_stats.c); only the owner writes
+ * them, so a relaxed load and store replace a locked increment
+ */
+typedef struct CRStatsBlock {
+    CRStats stats;
+    struct CRStatsBlock* next;
+    struct CRStatsBlock* prev;
+} CRStatsBlock;
+
+extern __thread CRStatsBlock* cr_thread_stats;
+CRStatsBlock* cr_stats_register(void);
+
+static inline CRStats* cr_stats_local(void) {
+    CRStatsBlock* block = cr_thread_stats;
+    return &(block != NULL ? block : cr_stats_register())->stats;
+}
+
+static inline void cr_stats_bump(uint64_t* slot) {
+    __atomic_store_n(slot, __atomic_load_n(slot, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+// Time stamp counter where there is one, else nanoseconds
+static inline uint64_t cr_stats_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline void cr_stats_record_cycles(uint64_t* histogram, uint64_t start) {
+    uint64_t cycles = cr_stats_cycles() - start;
+    int bucket = 63 - __builtin_clzll(cycles | 1);
+    cr_stats_bump(&histogram[bucket < CR_STATS_CYCLE_BUCKETS ? bucket : CR_STATS_CYCLE_BUCKETS - 1]);
+}
+
+#define CR_STAT_INC(counter) cr_stats_bump(&cr_stats_local()->counters[counter])
+#define CR_STAT_DEPTH(depth) cr_stats_bump(&cr_stats_local()->to_rational_depth[depth])
+#define CR_STAT_TIMER(name) uint64_t name = cr_stats_cycles()
+#define CR_STAT_CYCLES(histogram, name) cr_stats_record_cycles(cr_stats_local()->histogram, name)
+
+#else
+
+#define CR_STAT_INC(counter) ((void)0)
+#define CR_STAT_DEPTH(depth) ((void)(depth))
+#define CR_STAT_TIMER(name) ((void)0)
+#define CR_STAT_CYCLES(histogram, name) ((void)0)
+
+#endif // CR_ENABLE_STATS
+
+#endif // COMPACT_RATIONAL_INTERNAL_H
@@ -0,0 +1,64 @@
+#include "compact_rational_internal.h"
+
+// ============================================================================
+// 16-BIT LANES
+// ============================================================================
+
+// The loops below have no branches on the values, so they vectorize
+
+// Take the lanes of an array of full values
+size_t cr16_from_array(const CompactRational* values, size_t n, cr16_t* lanes) {
+    size_t tagged = 0;
+    for (size_t i = 0; i < n; i++) {
+        lanes[i] = cr16_from_cr(&values[i]);
+        tagged += lanes[i] >> 15;
+    }
+    return tagged;
+}
+
+// Lanes per block of cr16_add_array: the clamp check of a block is read
+// from L1 before it is written, so out may alias an input
+#define LANE_BLOCK 256
+
+// Saturating element-wise sum; clamps are located only in a block that has one
+size_t cr16_add_array(const cr16_t* a, const cr16_t* b, cr16_t* out, size_t n, CRError* error) {
+    size_t tagged = 0;
+    int64_t first_clamp = 0;
+    bool clamped = false;
+    for (size_t base = 0; base < n; base += LANE_BLOCK) {
+        size_t len = n - base < LANE_BLOCK ? n - base : LANE_BLOCK;
+        int32_t saturated = 0;
+        for (size_t i = base; i < base + len; i++) {
+            int32_t sum = cr16_whole(a[i]) + cr16_whole(b[i]);
+            saturated |= (sum > MAX_WHOLE_VALUE) | (sum < MIN_WHOLE_VALUE);
+        }
+        for (size_t i = base; saturated && !clamped; i++) {
+            int32_t sum = cr16_whole(a[i]) + cr16_whole(b[i]);
+            if (sum > MAX_WHOLE_VALUE || sum < MIN_WHOLE_VALUE) {
+                first_clamp = sum;
+                clamped = true;
+            }
+        }
+        for (size_t i = base; i < base + len; i++) {
+            cr16_t lane = cr16_add(a[i], b[i]);
+            tagged += lane >> 15;
+            out[i] = lane;
+        }
+    }
+
+    // Reports the clamp, or success
+    cr_clamp_whole(first_clamp, CR_OP_ADD, error);
+    return tagged;
+}
+
+// Sum of the integers of an array of lanes
+int64_t cr16_sum(const cr16_t* lanes, size_t n, size_t* tagged) {
+    int64_t total = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += cr16_whole(lanes[i]);
+        count += lanes[i] >> 15;
+    }
+    if (tagged != NULL) *tagged = count;
+    return total;
+}
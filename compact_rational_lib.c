@@ -1,4 +1,5 @@
-#include "compact_rational.h"
+#include "compact_rational_internal.h"
+#include "antichain_table.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,26 +9,16 @@
 // UTILITY FUNCTIONS
 // ============================================================================
 
-// Helper function to set error information
-static void set_error(CRError* error, CRErrorCode code, const char* message, int32_t value1, int32_t value2) {
-    if (error != NULL) {
-        error->code = code;
-        snprintf(error->message, sizeof(error->message), "%s", message);
-        error->value1 = value1;
-        error->value2 = value2;
-    }
-}
-
-// GCD using Euclidean algorithm
+// GCD using Euclidean algorithm, on magnitudes so INT64_MIN is defined
 int64_t gcd(int64_t a, int64_t b) {
-    a = llabs(a);
-    b = llabs(b);
-    while (b != 0) {
-        int64_t temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
+    uint64_t x = a < 0 ? -(uint64_t)a : (uint64_t)a;
+    uint64_t y = b < 0 ? -(uint64_t)b : (uint64_t)b;
+    while (y != 0) {
+        uint64_t temp = y;
+        y = x % y;
+        x = temp;
+    }
+    return (int64_t)x;  // 2^63 only for gcd(INT64_MIN, 0 or INT64_MIN)
 }
 
 // Reduce a rational to lowest terms
@@ -47,16 +38,12 @@ void reduce_rational(Rational* r) {
 
 // Find best antichain denominator for a given denominator
 uint8_t find_antichain_denominator(int64_t denom) {
-    // For denominators that divide into an antichain denominator nicely,
-    // find the smallest one
-    for (int d = MIN_DENOMINATOR; d <= MAX_DENOMINATOR; d++) {
-        if (d % denom == 0) {
-            return (uint8_t)d;
-        }
+    if (denom < 0) {
+        denom = -denom;
     }
-    // Otherwise, just use the denominator if it's in range
-    if (denom >= MIN_DENOMINATOR && denom <= MAX_DENOMINATOR) {
-        return (uint8_t)denom;
+    // Smallest antichain denominator that denom divides, from the generated table
+    if (denom >= 1 && denom <= MAX_DENOMINATOR) {
+        return cr_antichain_denominator_table[denom];
     }
     // Default to MIN_DENOMINATOR and scale
     return MIN_DENOMINATOR;
@@ -77,29 +64,15 @@ CompactRational cr_from_int(int32_t value, CRError* error) {
     CompactRational cr;
     cr_init(&cr);
 
-    int32_t original_value = value;
-    bool clamped = false;
-
     // Clamp to 15-bit signed range
     if (value > MAX_WHOLE_VALUE) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Value %d exceeds MAX_WHOLE_VALUE (%d), clamping to %d",
-                 value, MAX_WHOLE_VALUE, MAX_WHOLE_VALUE);
-        set_error(error, CR_ERROR_VALUE_CLAMPED, msg, original_value, MAX_WHOLE_VALUE);
+        cr_report(error, CR_ERROR_VALUE_CLAMPED, CR_OP_FROM_INT, value, MAX_WHOLE_VALUE);
         value = MAX_WHOLE_VALUE;
-        clamped = true;
     } else if (value < MIN_WHOLE_VALUE) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Value %d below MIN_WHOLE_VALUE (%d), clamping to %d",
-                 value, MIN_WHOLE_VALUE, MIN_WHOLE_VALUE);
-        set_error(error, CR_ERROR_VALUE_CLAMPED, msg, original_value, MIN_WHOLE_VALUE);
+        cr_report(error, CR_ERROR_VALUE_CLAMPED, CR_OP_FROM_INT, value, MIN_WHOLE_VALUE);
         value = MIN_WHOLE_VALUE;
-        clamped = true;
-    }
-
-    // If no clamping occurred, set success
-    if (!clamped && error != NULL) {
-        set_error(error, CR_SUCCESS, "Success", 0, 0);
+    } else {
+        cr_report_success(error);
     }
 
     // Store as 15-bit signed value in bits 14-0, bit 15 = 0 (no tuples)
@@ -107,15 +80,30 @@ CompactRational cr_from_int(int32_t value, CRError* error) {
     return cr;
 }
 
+// Clamp a decoded whole part to the 15-bit range, reporting the outcome
+int32_t cr_clamp_whole(int64_t whole, CROperation op, CRError* error) {
+    if (whole > MAX_WHOLE_VALUE) {
+        cr_report(error, CR_ERROR_VALUE_CLAMPED, op, cr_saturate_i32(whole), MAX_WHOLE_VALUE);
+        return MAX_WHOLE_VALUE;
+    }
+    if (whole < MIN_WHOLE_VALUE) {
+        cr_report(error, CR_ERROR_VALUE_CLAMPED, op, cr_saturate_i32(whole), MIN_WHOLE_VALUE);
+        return MIN_WHOLE_VALUE;
+    }
+
+    // No error occurred, set success
+    cr_report_success(error);
+    return (int32_t)whole;
+}
+
 // Create compact rational from numerator and denominator
 CompactRational cr_from_fraction(int32_t num, int32_t denom, CRError* error) {
     CompactRational cr;
     cr_init(&cr);
+    CR_STAT_INC(CR_STAT_FROM_FRACTION);
 
     if (denom == 0) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Division by zero (numerator=%d, denominator=%d)", num, denom);
-        set_error(error, CR_ERROR_DIVISION_BY_ZERO, msg, num, denom);
+        cr_report(error, CR_ERROR_DIVISION_BY_ZERO, CR_OP_FROM_FRACTION, num, denom);
         return cr;
     }
 
@@ -133,38 +121,22 @@ CompactRational cr_from_fraction(int32_t num, int32_t denom, CRError* error) {
         whole -= 1;
     }
 
-    int32_t original_whole = whole;
-    bool clamped = false;
-
-    // Clamp whole part
-    if (whole > MAX_WHOLE_VALUE) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Whole part %d exceeds MAX_WHOLE_VALUE (%d), clamping to %d",
-                 whole, MAX_WHOLE_VALUE, MAX_WHOLE_VALUE);
-        set_error(error, CR_ERROR_VALUE_CLAMPED, msg, original_whole, MAX_WHOLE_VALUE);
-        whole = MAX_WHOLE_VALUE;
-        clamped = true;
-    } else if (whole < MIN_WHOLE_VALUE) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Whole part %d below MIN_WHOLE_VALUE (%d), clamping to %d",
-                 whole, MIN_WHOLE_VALUE, MIN_WHOLE_VALUE);
-        set_error(error, CR_ERROR_VALUE_CLAMPED, msg, original_whole, MIN_WHOLE_VALUE);
-        whole = MIN_WHOLE_VALUE;
-        clamped = true;
-    }
-
-    // If no error occurred, set success
-    if (!clamped && error != NULL) {
-        set_error(error, CR_SUCCESS, "Success", 0, 0);
-    }
+    whole = cr_clamp_whole(whole, CR_OP_FROM_FRACTION, error);
 
     // If there's a fractional part, encode it
     if (remainder_num != 0) {
-        // Find appropriate antichain denominator
-        uint8_t antichain_denom = find_antichain_denominator(r.denominator);
-
-        // Scale numerator to match antichain denominator
-        uint64_t scaled_num = (remainder_num * antichain_denom) / r.denominator;
+        // Find appropriate antichain denominator and scale numerator to match
+        uint8_t antichain_denom;
+        uint64_t scaled_num;
+        if (r.denominator <= MAX_DENOMINATOR) {
+            // Exact: table lookup and a multiply, no scan or division
+            antichain_denom = cr_antichain_denominator_table[r.denominator];
+            scaled_num = (uint64_t)remainder_num * cr_antichain_scale_table[r.denominator];
+        } else {
+            CR_STAT_INC(CR_STAT_FROM_FRACTION_LOSSY);
+            antichain_denom = MIN_DENOMINATOR;
+            scaled_num = (remainder_num * antichain_denom) / r.denominator;
+        }
 
         if (scaled_num > 0 && scaled_num <= MAX_NUMERATOR) {
             // Encode whole part in bits 14-0, set bit 15 = 1 (tuples present)
@@ -204,12 +176,15 @@ Rational cr_to_rational(const CompactRational* cr) {
     // Check bit 15 for tuple presence flag
     if (!(cr->whole & 0x8000)) {
         // Bit 15 = 0, no tuples
+        CR_STAT_DEPTH(0);
         return result;
     }
 
     // Bit 15 = 1, tuples are present
     // Process tuples until we find one with end flag (bit 7 set in denominator byte)
+    int walked = 0;
     for (int i = 0; i < MAX_TUPLES; i++) {
+        walked = i + 1;
         uint8_t numerator = (cr->tuples[i] >> 8) & 0xFF;
         uint8_t denom_byte = cr->tuples[i] & 0xFF;
         uint8_t offset = denom_byte & 0x7F;
@@ -229,6 +204,7 @@ Rational cr_to_rational(const CompactRational* cr) {
         }
     }
 
+    CR_STAT_DEPTH(walked);
     return result;
 }
 
@@ -238,95 +214,331 @@ double cr_to_double(const CompactRational* cr, CRError* error) {
 
     // Defensive check for zero denominator
     if (r.denominator == 0) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Invalid denominator (zero) in rational conversion");
-        set_error(error, CR_ERROR_INVALID_DENOMINATOR, msg, 0, 0);
+        cr_report(error, CR_ERROR_INVALID_DENOMINATOR, CR_OP_TO_DOUBLE, 0, 0);
         return 0.0;
     }
 
     // Success
-    if (error != NULL) {
-        set_error(error, CR_SUCCESS, "Success", 0, 0);
-    }
+    cr_report_success(error);
 
     return (double)r.numerator / (double)r.denominator;
 }
 
 // Print compact rational in human-readable form
 void cr_print(const CompactRational* cr) {
-    Rational r = cr_to_rational(cr);
+    char text[CR_FORMAT_MAX];
+    cr_format(text, sizeof(text), cr, CR_FORMAT_DECIMAL);
+    fputs(text, stdout);
+}
 
-    if (r.denominator == 1) {
-        printf("%lld", (long long)r.numerator);
-    } else {
-        int64_t whole = r.numerator / r.denominator;
-        int64_t rem = llabs(r.numerator % r.denominator);
-
-        if (whole != 0) {
-            printf("%lld", (long long)whole);
-            if (rem != 0) {
-                printf(" %lld/%lld", (long long)rem, (long long)r.denominator);
-            }
+// True for a value with exactly one tuple whose numerator is in (0, denominator)
+static bool is_simple_tuple(const CompactRational* cr) {
+    if (!(cr->whole & 0x8000) || !(cr->tuples[0] & 0x80)) {
+        return false;
+    }
+    uint8_t num = cr->tuples[0] >> 8;
+    return num > 0 && num < MIN_DENOMINATOR + (cr->tuples[0] & 0x7F);
+}
+
+/**
+ * Fast paths for the common shapes of a sum
+ * Handles integer + integer, integer + single tuple and single tuple +
+ * single tuple on the same denominator. Numerators add with a carry into
+ * the whole part, as in cr_canonicalize, so no gcd or re-encoding is needed.
+ * Returns false if the operands need the general rational path.
+ */
+static bool add_fast_path(const CompactRational* a, const CompactRational* b,
+                          CompactRational* result, CROperation op, CRError* error) {
+    bool a_int = !(a->whole & 0x8000);
+    bool b_int = !(b->whole & 0x8000);
+    uint16_t tuple;
+
+    if (a_int && b_int) {
+        tuple = 0;
+    } else if (a_int && is_simple_tuple(b)) {
+        tuple = b->tuples[0];
+    } else if (b_int && is_simple_tuple(a)) {
+        tuple = a->tuples[0];
+    } else if (is_simple_tuple(a) && is_simple_tuple(b) &&
+               (a->tuples[0] & 0x7F) == (b->tuples[0] & 0x7F)) {
+        uint32_t denom = MIN_DENOMINATOR + (a->tuples[0] & 0x7F);
+        uint32_t num = (uint32_t)(a->tuples[0] >> 8) + (b->tuples[0] >> 8);
+        int32_t carry = 0;
+        if (num >= denom) {
+            num -= denom;
+            carry = 1;
+        }
+        int32_t whole = cr_clamp_whole(cr_whole_value(a->whole) + cr_whole_value(b->whole) + carry, op, error);
+        cr_init(result);
+        if (num == 0) {
+            result->whole = (int16_t)(whole & 0x7FFF);
         } else {
-            if (r.numerator < 0) printf("-");
-            printf("%lld/%lld", (long long)rem, (long long)r.denominator);
+            result->whole = (int16_t)((whole & 0x7FFF) | 0x8000);
+            result->tuples[0] = (uint16_t)((num << 8) | (a->tuples[0] & 0xFF));
         }
+        return true;
+    } else {
+        return false;
+    }
+
+    int32_t whole = cr_clamp_whole(cr_whole_value(a->whole) + cr_whole_value(b->whole), op, error);
+    cr_init(result);
+    if (tuple == 0) {
+        result->whole = (int16_t)(whole & 0x7FFF);
+    } else {
+        result->whole = (int16_t)((whole & 0x7FFF) | 0x8000);
+        result->tuples[0] = tuple;
+    }
+    return true;
+}
+
+// Value as an unreduced 128-bit fraction: whole * denom + tuples over denom
+static void decode_wide(const CompactRational* cr, __int128* num, __int128* denom) {
+    int64_t n, d;
+    cr_fraction_parts(cr, &n, &d);
+    *num = (__int128)cr_whole_value(cr->whole) * d + n;
+    *denom = d;
+}
+
+// Sum with the fast paths, falling back to exact 128-bit arithmetic
+static CompactRational add_values(const CompactRational* a, const CompactRational* b,
+                                  CROperation op, CRError* error) {
+    CompactRational fast;
+    CR_STAT_INC(CR_STAT_ADD);
+    if (add_fast_path(a, b, &fast, op, error)) {
+        return fast;
     }
-    printf(" (%.6f)", cr_to_double(cr, NULL));  // Ignore errors in print function
+
+    // ra + rb = (ra.num * rb.denom + rb.num * ra.denom) / (ra.denom * rb.denom)
+    CR_STAT_INC(CR_STAT_ADD_SLOW);
+    CR_STAT_TIMER(start);
+    __int128 an, ad, bn, bd;
+    decode_wide(a, &an, &ad);
+    decode_wide(b, &bn, &bd);
+    CompactRational sum = cr_encode_wide(an * bd + bn * ad, ad * bd, op, error);
+    CR_STAT_CYCLES(add_slow_cycles, start);
+    return sum;
 }
 
 // Add two compact rationals
 CompactRational cr_add(const CompactRational* a, const CompactRational* b, CRError* error) {
-    // Convert both to standard rationals, add them, then encode back
-    Rational ra = cr_to_rational(a);
-    Rational rb = cr_to_rational(b);
-
-    // Add: ra + rb = (ra.num * rb.denom + rb.num * ra.denom) / (ra.denom * rb.denom)
-    Rational sum;
-    sum.numerator = ra.numerator * rb.denominator + rb.numerator * ra.denominator;
-    sum.denominator = ra.denominator * rb.denominator;
-
-    reduce_rational(&sum);
-
-    // Check for overflow before downcasting to int32_t
-    if (sum.numerator > INT32_MAX || sum.numerator < INT32_MIN ||
-        sum.denominator > INT32_MAX || sum.denominator < INT32_MIN) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Overflow in addition - result (%lld/%lld) exceeds int32_t range",
-                 (long long)sum.numerator, (long long)sum.denominator);
-        set_error(error, CR_ERROR_OVERFLOW, msg, (int32_t)sum.numerator, (int32_t)sum.denominator);
-        return cr_from_int(0, NULL);  // Return zero on overflow
-    }
-
-    // Success - pass through any errors from cr_from_fraction
-    // Convert back to compact form
-    return cr_from_fraction((int32_t)sum.numerator, (int32_t)sum.denominator, error);
+    return add_values(a, b, CR_OP_ADD, error);
 }
 
-// Print raw encoding (for debugging)
-void cr_print_encoding(const CompactRational* cr) {
-    // Cast to uint16_t to avoid sign extension artifacts in hex display
-    bool has_tuples = (cr->whole & 0x8000) != 0;
-    printf("Encoding: whole=0x%04X (bit15=%d)", (uint16_t)cr->whole, has_tuples ? 1 : 0);
-
-    if (has_tuples) {
-        printf(" [");
-        for (int i = 0; i < MAX_TUPLES; i++) {
-            uint8_t num = (cr->tuples[i] >> 8) & 0xFF;
-            uint8_t denom_byte = cr->tuples[i] & 0xFF;
-            uint8_t offset = denom_byte & 0x7F;
-            bool end_flag = (denom_byte & 0x80) != 0;
-
-            printf("%d/%d%s", num, MIN_DENOMINATOR + offset, end_flag ? "(end)" : "");
-
-            if (end_flag) {
-                break;  // Stop after the last tuple
-            }
-            printf(", ");
+/**
+ * Negate an integer or a simple single tuple on the encoding itself:
+ * -(w + n/d) = (-w - 1) + (d - n)/d keeps the denominator. Returns false
+ * for other shapes; *whole is the unclamped whole part.
+ */
+static bool negate_simple(const CompactRational* cr, CompactRational* out, int32_t* whole) {
+    cr_init(out);
+    if (!(cr->whole & 0x8000)) {
+        *whole = -cr_whole_value(cr->whole);
+        out->whole = (int16_t)(*whole & 0x7FFF);
+        return true;
+    }
+    if (!is_simple_tuple(cr)) {
+        return false;
+    }
+
+    uint16_t denom = MIN_DENOMINATOR + (cr->tuples[0] & 0x7F);
+    uint16_t num = denom - (cr->tuples[0] >> 8);
+    *whole = -cr_whole_value(cr->whole) - 1;
+    out->whole = (int16_t)((*whole & 0x7FFF) | 0x8000);
+    out->tuples[0] = (uint16_t)((num << 8) | (cr->tuples[0] & 0xFF));
+    return true;
+}
+
+// Negate a compact rational
+CompactRational cr_neg(const CompactRational* a, CRError* error) {
+    CompactRational result;
+    int32_t whole;
+    if (negate_simple(a, &result, &whole)) {
+        int32_t clamped = cr_clamp_whole(whole, CR_OP_NEG, error);
+        result.whole = (int16_t)((clamped & 0x7FFF) | (result.whole & 0x8000));
+        return result;
+    }
+
+    __int128 num, denom;
+    decode_wide(a, &num, &denom);
+    return cr_encode_wide(-num, denom, CR_OP_NEG, error);
+}
+
+// Subtract two compact rationals
+CompactRational cr_sub(const CompactRational* a, const CompactRational* b, CRError* error) {
+    // a - b = a + (-b) whenever -b is cheap and in range
+    CompactRational neg_b;
+    int32_t whole;
+    if (negate_simple(b, &neg_b, &whole) && whole >= MIN_WHOLE_VALUE) {
+        return add_values(a, &neg_b, CR_OP_SUB, error);
+    }
+
+    // Counted as a slow addition, like the 128-bit path of add_values
+    CR_STAT_INC(CR_STAT_ADD);
+    CR_STAT_INC(CR_STAT_ADD_SLOW);
+    CR_STAT_TIMER(start);
+    __int128 an, ad, bn, bd;
+    decode_wide(a, &an, &ad);
+    decode_wide(b, &bn, &bd);
+    CompactRational difference = cr_encode_wide(an * bd - bn * ad, ad * bd, CR_OP_SUB, error);
+    CR_STAT_CYCLES(add_slow_cycles, start);
+    return difference;
+}
+
+// Multiply two compact rationals
+CompactRational cr_mul(const CompactRational* a, const CompactRational* b, CRError* error) {
+    if (!(a->whole & 0x8000) && !(b->whole & 0x8000)) {
+        int64_t product = (int64_t)cr_whole_value(a->whole) * cr_whole_value(b->whole);
+        CompactRational result;
+        cr_init(&result);
+        result.whole = (int16_t)(cr_clamp_whole(product, CR_OP_MUL, error) & 0x7FFF);
+        return result;
+    }
+
+    __int128 an, ad, bn, bd;
+    decode_wide(a, &an, &ad);
+    decode_wide(b, &bn, &bd);
+    return cr_encode_wide(an * bn, ad * bd, CR_OP_MUL, error);
+}
+
+// Divide two compact rationals
+CompactRational cr_div(const CompactRational* a, const CompactRational* b, CRError* error) {
+    __int128 an, ad, bn, bd;
+    decode_wide(b, &bn, &bd);
+    if (bn == 0) {
+        CompactRational zero;
+        cr_init(&zero);
+        cr_report(error, CR_ERROR_DIVISION_BY_ZERO, CR_OP_DIV, cr_whole_value(a->whole), 0);
+        return zero;
+    }
+
+    decode_wide(a, &an, &ad);
+    return cr_encode_wide(an * bd, ad * bn, CR_OP_DIV, error);
+}
+
+/**
+ * Compare two compact rationals exactly
+ * Fraction parts lie in [0, 10), so whole parts 10 apart decide alone.
+ * Otherwise sign((wa - wb) * da * db + na * db - nb * da) with products
+ * below 2^91.
+ */
+int cr_cmp(const CompactRational* a, const CompactRational* b) {
+    int32_t wa = cr_whole_value(a->whole);
+    int32_t wb = cr_whole_value(b->whole);
+    if (!((a->whole | b->whole) & 0x8000) || wa - wb >= 10 || wb - wa >= 10) {
+        return (wa > wb) - (wa < wb);
+    }
+
+    int64_t na, da, nb, db;
+    cr_fraction_parts(a, &na, &da);
+    cr_fraction_parts(b, &nb, &db);
+    __int128 diff = (__int128)(wa - wb) * da * db + (__int128)na * db - (__int128)nb * da;
+    return (diff > 0) - (diff < 0);
+}
+
+// ============================================================================
+// CANONICALIZATION
+// ============================================================================
+
+/**
+ * Canonical tuples of a value, in O(MAX_TUPLES)
+ * Already canonical input is copied. Otherwise the (offset, numerator)
+ * pairs are sorted by a fixed network in registers, so equal offsets are
+ * adjacent and merging, carrying numerators >= denominator into the whole
+ * part and dropping zeros take one straight-line pass: the random tuple
+ * counts of merged data cost no mispredicted loop exits. out gets the
+ * tuples and bit 15 (whole bits clear); the unclamped whole part is
+ * returned.
+ */
+int64_t cr_canonical_parts(const CompactRational* cr, CompactRational* out) {
+    int64_t whole = cr_whole_value(cr->whole);
+    memset(out, 0, sizeof(*out));
+    if (!(cr->whole & 0x8000)) {
+        return whole;
+    }
+
+    // Common case: already canonical, as every encoder produces
+    int prev = -1;
+    for (int i = 0; i < MAX_TUPLES; i++) {
+        uint16_t tuple = cr->tuples[i];
+        int offset = tuple & 0x7F;
+        uint32_t num = tuple >> 8;
+        if (offset <= prev || num == 0 || num >= MIN_DENOMINATOR + (uint32_t)offset) {
+            break;
+        }
+        prev = offset;
+        if (tuple & 0x80) {
+            memcpy(out->tuples, cr->tuples, (size_t)(i + 1) * sizeof(uint16_t));
+            out->whole = (int16_t)0x8000;
+            return whole;
+        }
+    }
+
+    // offset << 8 | numerator keeps the sort key in the high bits; slots
+    // after the end flag become UINT32_MAX and sort last
+    uint32_t items[MAX_TUPLES];
+    uint32_t live = UINT32_MAX;
+    for (int i = 0; i < MAX_TUPLES; i++) {
+        uint16_t tuple = cr->tuples[i];
+        items[i] = (((uint32_t)(tuple & 0x7F) << 8) | (tuple >> 8)) | ~live;
+        live &= (tuple & 0x80) ? 0 : UINT32_MAX;
+    }
+
+    // Optimal 9-comparator sorting network for five elements, on locals so
+    // each compare-exchange is a pair of conditional moves
+#define CR_SORT2(x, y) do { uint32_t lo_ = x < y ? x : y; y = x < y ? y : x; x = lo_; } while (0)
+    uint32_t t0 = items[0], t1 = items[1], t2 = items[2], t3 = items[3], t4 = items[4];
+    CR_SORT2(t0, t3); CR_SORT2(t1, t4); CR_SORT2(t0, t2); CR_SORT2(t1, t3); CR_SORT2(t0, t1);
+    CR_SORT2(t2, t4); CR_SORT2(t1, t2); CR_SORT2(t3, t4); CR_SORT2(t2, t3);
+#undef CR_SORT2
+    items[0] = t0; items[1] = t1; items[2] = t2; items[3] = t3; items[4] = t4;
+
+    // Fold each numerator into the next slot when the offsets match
+    uint32_t offsets[MAX_TUPLES], nums[MAX_TUPLES];
+    for (int i = 0; i < MAX_TUPLES; i++) {
+        offsets[i] = items[i] >> 8;
+        nums[i] = items[i] == UINT32_MAX ? 0 : items[i] & 0xFF;
+    }
+    for (int i = 0; i + 1 < MAX_TUPLES; i++) {
+        uint32_t same = offsets[i] == offsets[i + 1] ? UINT32_MAX : 0;
+        nums[i + 1] += nums[i] & same;
+        nums[i] &= ~same;
+    }
+
+    // Carry whole parts and compact the nonzero numerators in order
+    int count = 0;
+    for (int i = 0; i < MAX_TUPLES; i++) {
+        uint32_t num = nums[i];
+        uint32_t denom = MIN_DENOMINATOR + offsets[i];
+        if (num >= denom) {
+            whole += num / denom;
+            num %= denom;
         }
-        printf("]");
+        out->tuples[count] = (uint16_t)(num == 0 ? 0 : (num << 8) | offsets[i]);
+        count += num != 0;
     }
-    printf("\n");
+
+    if (count > 0) {
+        out->tuples[count - 1] |= 0x80;
+        out->whole = (int16_t)0x8000;
+    }
+    return whole;
+}
+
+// Canonicalize a compact rational
+CompactRational cr_canonicalize(const CompactRational* cr, CRError* error) {
+    CompactRational result;
+    int32_t whole = cr_clamp_whole(cr_canonical_parts(cr, &result), CR_OP_CANONICALIZE, error);
+    result.whole = (int16_t)(result.whole | (whole & 0x7FFF));
+    return result;
+}
+
+// Print raw encoding (for debugging)
+void cr_print_encoding(const CompactRational* cr) {
+    char text[CR_FORMAT_MAX];
+    size_t len = cr_format(text, sizeof(text) - 1, cr, CR_FORMAT_ENCODING);
+    text[len] = '\n';
+    fwrite(text, 1, len + 1, stdout);
 }
 
 // Get size in bytes
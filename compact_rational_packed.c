@@ -0,0 +1,261 @@
+#include "compact_rational_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// SINGLE VALUE PACKING
+// ============================================================================
+
+// Write one value as little-endian whole followed by little-endian tuples
+size_t cr_pack(const CompactRational* cr, uint8_t* buf, size_t cap) {
+    size_t size = cr_size(cr);
+    if (size > cap) {
+        return 0;
+    }
+
+    uint16_t whole = (uint16_t)cr->whole;
+    buf[0] = (uint8_t)(whole & 0xFF);
+    buf[1] = (uint8_t)(whole >> 8);
+
+    size_t tuple_count = (size - 2) / 2;
+    for (size_t i = 0; i < tuple_count; i++) {
+        uint8_t denom_byte = cr->tuples[i] & 0xFF;
+        if (i == tuple_count - 1) {
+            denom_byte |= 0x80;  // cr_size stops at MAX_TUPLES even without an end flag
+        }
+        buf[2 + 2 * i] = denom_byte;
+        buf[3 + 2 * i] = (uint8_t)(cr->tuples[i] >> 8);
+    }
+
+    return size;
+}
+
+// Read one packed value back into the fixed-size struct
+size_t cr_unpack(const uint8_t* buf, size_t len, CompactRational* cr) {
+    size_t size = cr_packed_length(buf, len);
+    if (size == 0) {
+        return 0;
+    }
+
+    cr_init(cr);
+    cr->whole = (int16_t)((uint16_t)buf[0] | ((uint16_t)buf[1] << 8));
+
+    size_t tuple_count = (size - 2) / 2;
+    for (size_t i = 0; i < tuple_count; i++) {
+        cr->tuples[i] = (uint16_t)(((uint16_t)buf[3 + 2 * i] << 8) | buf[2 + 2 * i]);
+    }
+
+    return size;
+}
+
+// ============================================================================
+// PACKED ARRAY
+// ============================================================================
+
+// Initialize an empty packed array
+void cr_packed_init(CRPackedArray* pa) {
+    pa->data = NULL;
+    pa->size = 0;
+    pa->capacity = 0;
+    pa->count = 0;
+    pa->index = NULL;
+    pa->index_capacity = 0;
+    pa->view = false;
+}
+
+// Release storage and reset to empty
+void cr_packed_free(CRPackedArray* pa) {
+    if (!pa->view) {
+        free(pa->data);
+        free(pa->index);
+    }
+    cr_packed_init(pa);
+}
+
+// Number of index entries needed for count values
+static size_t index_entries_for(size_t count) {
+    return (count + CR_PACKED_INDEX_STRIDE - 1) / CR_PACKED_INDEX_STRIDE;
+}
+
+// Grow a buffer geometrically so repeated appends stay amortized O(1)
+static size_t grow_capacity(size_t current, size_t needed) {
+    size_t capacity = current > 0 ? current : 64;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// Replace borrowed storage by owned copies sized for the requested growth
+static bool detach_view(CRPackedArray* pa, size_t needed_bytes, size_t needed_entries, CRError* error) {
+    size_t capacity = grow_capacity(0, needed_bytes);
+    uint8_t* data = malloc(capacity);
+    if (data == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_PACKED_RESERVE, cr_saturate_i32((int64_t)capacity), 0);
+        return false;
+    }
+
+    size_t index_capacity = grow_capacity(0, needed_entries);
+    uint64_t* index = malloc(index_capacity * sizeof(uint64_t));
+    if (index == NULL) {
+        free(data);
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_PACKED_RESERVE, cr_saturate_i32((int64_t)index_capacity), 1);
+        return false;
+    }
+
+    memcpy(data, pa->data, pa->size);
+    memcpy(index, pa->index, index_entries_for(pa->count) * sizeof(uint64_t));
+    pa->data = data;
+    pa->capacity = capacity;
+    pa->index = index;
+    pa->index_capacity = index_capacity;
+    pa->view = false;
+    return true;
+}
+
+// Reserve room for additional values
+bool cr_packed_reserve(CRPackedArray* pa, size_t extra_bytes, size_t extra_count, CRError* error) {
+    if (pa->view && !detach_view(pa, pa->size + extra_bytes, index_entries_for(pa->count + extra_count), error)) {
+        return false;
+    }
+
+    size_t needed_bytes = pa->size + extra_bytes;
+    if (needed_bytes > pa->capacity) {
+        size_t capacity = grow_capacity(pa->capacity, needed_bytes);
+        uint8_t* data = realloc(pa->data, capacity);
+        if (data == NULL) {
+            cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_PACKED_RESERVE, cr_saturate_i32((int64_t)capacity), 0);
+            return false;
+        }
+        pa->data = data;
+        pa->capacity = capacity;
+    }
+
+    size_t needed_entries = index_entries_for(pa->count + extra_count);
+    if (needed_entries > pa->index_capacity) {
+        size_t capacity = grow_capacity(pa->index_capacity, needed_entries);
+        uint64_t* index = realloc(pa->index, capacity * sizeof(uint64_t));
+        if (index == NULL) {
+            cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_PACKED_RESERVE, cr_saturate_i32((int64_t)capacity), 1);
+            return false;
+        }
+        pa->index = index;
+        pa->index_capacity = capacity;
+    }
+
+    cr_report_success(error);
+    return true;
+}
+
+// Append a value whose storage has already been reserved
+static void append_reserved(CRPackedArray* pa, const CompactRational* cr) {
+    if (pa->count % CR_PACKED_INDEX_STRIDE == 0) {
+        pa->index[pa->count / CR_PACKED_INDEX_STRIDE] = pa->size;
+    }
+    pa->size += cr_pack(cr, pa->data + pa->size, pa->capacity - pa->size);
+    pa->count++;
+}
+
+// Append one value
+bool cr_packed_append(CRPackedArray* pa, const CompactRational* cr, CRError* error) {
+    if (!cr_packed_reserve(pa, cr_size(cr), 1, error)) {
+        return false;
+    }
+    append_reserved(pa, cr);
+    return true;
+}
+
+// Byte offset of value i: one index lookup plus a short skip over flags
+size_t cr_packed_offset(const CRPackedArray* pa, size_t i) {
+    uint64_t entry = pa->index[i / CR_PACKED_INDEX_STRIDE];
+    if (entry > pa->size) {
+        return SIZE_MAX;  // Index of an unverified file points past the stream
+    }
+    size_t pos = (size_t)entry;
+    for (size_t skip = i % CR_PACKED_INDEX_STRIDE; skip > 0; skip--) {
+        size_t len = cr_packed_length(pa->data + pos, pa->size - pos);
+        if (len == 0) {
+            return SIZE_MAX;
+        }
+        pos += len;
+    }
+    return pos;
+}
+
+// Random access into a packed array
+CompactRational cr_packed_get(const CRPackedArray* pa, size_t i, CRError* error) {
+    CompactRational cr;
+    cr_init(&cr);
+
+    if (i >= pa->count) {
+        cr_report(error, CR_ERROR_OUT_OF_BOUNDS, CR_OP_PACKED_GET, cr_saturate_i32((int64_t)i),
+                  cr_saturate_i32((int64_t)pa->count));
+        return cr;
+    }
+
+    size_t pos = cr_packed_offset(pa, i);
+    if (pos == SIZE_MAX || cr_unpack(pa->data + pos, pa->size - pos, &cr) == 0) {
+        cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_PACKED_GET, cr_saturate_i32((int64_t)i), 0);
+        cr_init(&cr);
+        return cr;
+    }
+
+    cr_report_success(error);
+    return cr;
+}
+
+// Byte footprint: stream plus one index entry per stride
+size_t cr_packed_footprint(const CRPackedArray* pa) {
+    return pa->size + index_entries_for(pa->count) * sizeof(uint64_t);
+}
+
+// Append an array of values, sizing storage exactly once
+bool cr_pack_array(const CompactRational* values, size_t n, CRPackedArray* out, CRError* error) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; i++) {
+        bytes += cr_size(&values[i]);
+    }
+
+    if (!cr_packed_reserve(out, bytes, n, error)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        append_reserved(out, &values[i]);
+    }
+    return true;
+}
+
+// Decode a contiguous range after a single index seek
+size_t cr_unpack_array(const CRPackedArray* pa, size_t start, size_t n, CompactRational* out, CRError* error) {
+    if (start >= pa->count) {
+        if (n == 0) {
+            cr_report_success(error);
+            return 0;
+        }
+        cr_report(error, CR_ERROR_OUT_OF_BOUNDS, CR_OP_UNPACK_ARRAY, cr_saturate_i32((int64_t)start),
+                  cr_saturate_i32((int64_t)pa->count));
+        return 0;
+    }
+
+    if (n > pa->count - start) {
+        n = pa->count - start;
+    }
+
+    size_t pos = cr_packed_offset(pa, start);
+    if (pos == SIZE_MAX) {
+        cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_UNPACK_ARRAY, cr_saturate_i32((int64_t)start), 0);
+        return 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t used = cr_unpack(pa->data + pos, pa->size - pos, &out[i]);
+        if (used == 0) {
+            cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_UNPACK_ARRAY, cr_saturate_i32((int64_t)(start + i)), 0);
+            return i;
+        }
+        pos += used;
+    }
+
+    cr_report_success(error);
+    return n;
+}
@@ -0,0 +1,254 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "compact_rational_internal.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ============================================================================
+// BULK CONVERSION
+// ============================================================================
+
+// Takes one converted chunk, in row order; false stops the pipeline
+typedef bool (*ChunkSink)(void* target, const CompactRational* values, size_t n, CRError* error);
+
+// One chunk buffer of the ring between the workers and the sink
+typedef struct {
+    CompactRational* values;
+    size_t count;
+    bool ready;                       // Converted, waiting for the sink
+    uint32_t flags;                   // Error codes the chunk's rows reported
+    CRStatus status;                  // First failing row, if flags is nonzero
+} Slot;
+
+typedef struct {
+    const Rational* pairs;
+    size_t n;
+    size_t chunk_count;
+    Slot* slots;
+    size_t depth;                     // Slots in the ring
+    pthread_mutex_t lock;
+    pthread_cond_t converted;         // A slot became ready
+    pthread_cond_t drained;           // The sink released a slot, or stop was set
+    size_t next_chunk;                // Next chunk a worker claims
+    size_t consumed;                  // Chunks the sink has taken
+    bool stop;                        // The sink failed
+} Pipeline;
+
+// Reduce, classify and encode one pair, as cr_encode_optimal does
+static inline CompactRational convert_pair(Rational r) {
+    if (r.denominator > 0 && r.numerator % r.denominator == 0) {
+        // Integer quotient: no gcd, no fraction search
+        CompactRational cr;
+        cr_init(&cr);
+        cr.whole = (int16_t)(cr_clamp_whole(r.numerator / r.denominator, CR_OP_ENCODE_OPTIMAL, NULL) & 0x7FFF);
+        return cr;
+    }
+    return cr_encode_optimal(r.numerator, r.denominator, NULL);
+}
+
+/**
+ * Convert n pairs into slot. Failures are watched through this thread's
+ * flags, cleared for the chunk and put back afterwards; a chunk that has
+ * any is converted again row by row to find the first.
+ */
+static void convert_chunk(const Rational* pairs, size_t n, Slot* slot) {
+    uint32_t saved_flags = cr_error_flags();
+    CRStatus saved_last = cr_last_error();
+
+    cr_error_clear();
+    for (size_t i = 0; i < n; i++) {
+        slot->values[i] = convert_pair(pairs[i]);
+    }
+    slot->count = n;
+
+    uint32_t flags = cr_error_flags();
+    CRStatus last = cr_last_error();
+    slot->flags = flags;
+    for (size_t i = 0; flags != 0 && i < n; i++) {
+        cr_error_clear();
+        convert_pair(pairs[i]);
+        if (cr_error_flags() != 0) {
+            slot->status = cr_last_error();
+            break;
+        }
+    }
+    cr_error_restore(saved_flags | flags, flags != 0 ? last : saved_last);
+}
+
+// Convert a chunk into its slot
+static void convert_chunk_at(Pipeline* p, size_t c) {
+    size_t start = c * CR_PIPELINE_CHUNK;
+    size_t len = p->n - start < CR_PIPELINE_CHUNK ? p->n - start : CR_PIPELINE_CHUNK;
+    convert_chunk(p->pairs + start, len, &p->slots[c % p->depth]);
+}
+
+static void* pipeline_worker(void* arg) {
+    Pipeline* p = (Pipeline*)arg;
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        // Back-pressure: a chunk's slot must have been drained by the sink
+        while (!p->stop && p->next_chunk < p->chunk_count && p->next_chunk >= p->consumed + p->depth) {
+            pthread_cond_wait(&p->drained, &p->lock);
+        }
+        if (p->stop || p->next_chunk == p->chunk_count) {
+            break;
+        }
+        size_t c = p->next_chunk++;
+        pthread_mutex_unlock(&p->lock);
+
+        convert_chunk_at(p, c);
+
+        pthread_mutex_lock(&p->lock);
+        p->slots[c % p->depth].ready = true;
+        pthread_cond_signal(&p->converted);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+// Number of encoding threads for chunk_count chunks
+static int pipeline_thread_count(size_t chunk_count, int threads) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (chunk_count < (size_t)threads) {
+        threads = chunk_count > 0 ? (int)chunk_count : 1;
+    }
+    return threads;
+}
+
+static void free_slots(Slot* slots, size_t depth) {
+    for (size_t s = 0; slots != NULL && s < depth; s++) {
+        free(slots[s].values);
+    }
+    free(slots);
+}
+
+// Run the workers and feed the sink on the calling thread
+static size_t run_pipeline(const Rational* pairs, size_t n, int threads, ChunkSink sink, void* target,
+                           CRError* error) {
+    if (n == 0) {
+        cr_report_success(error);
+        return 0;
+    }
+
+    Pipeline p;
+    p.pairs = pairs;
+    p.n = n;
+    p.chunk_count = (n + CR_PIPELINE_CHUNK - 1) / CR_PIPELINE_CHUNK;
+    p.next_chunk = 0;
+    p.consumed = 0;
+    p.stop = false;
+
+    // Two buffers per worker: one being converted while the other waits
+    int workers = pipeline_thread_count(p.chunk_count, threads);
+    p.depth = workers > 1 ? 2 * (size_t)workers : 1;
+    p.slots = calloc(p.depth, sizeof(Slot));
+    bool allocated = p.slots != NULL;
+    for (size_t s = 0; allocated && s < p.depth; s++) {
+        p.slots[s].values = malloc(CR_PIPELINE_CHUNK * sizeof(CompactRational));
+        allocated = p.slots[s].values != NULL;
+    }
+    if (!allocated) {
+        free_slots(p.slots, p.depth);
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_PIPELINE,
+                  cr_saturate_i32((int64_t)(p.depth * CR_PIPELINE_CHUNK * sizeof(CompactRational))), 0);
+        return 0;
+    }
+
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.converted, NULL);
+    pthread_cond_init(&p.drained, NULL);
+
+    // With no worker running (one thread asked for, or none could start)
+    // the chunks are converted inline, one buffer at a time
+    pthread_t* ids = workers > 1 ? malloc((size_t)workers * sizeof(pthread_t)) : NULL;
+    int started = 0;
+    for (int t = 0; ids != NULL && t < workers; t++) {
+        if (pthread_create(&ids[started], NULL, pipeline_worker, &p) == 0) {
+            started++;
+        }
+    }
+
+    size_t written = 0;
+    bool sink_failed = false;
+    uint32_t flags = 0;
+    CRStatus first = {CR_SUCCESS, CR_OP_NONE, 0, 0, 0};
+    for (size_t c = 0; c < p.chunk_count; c++) {
+        Slot* slot = &p.slots[c % p.depth];
+        if (started == 0) {
+            convert_chunk_at(&p, c);
+        } else {
+            pthread_mutex_lock(&p.lock);
+            while (!slot->ready) {
+                pthread_cond_wait(&p.converted, &p.lock);
+            }
+            pthread_mutex_unlock(&p.lock);
+        }
+
+        if (slot->flags != 0 && flags == 0) {
+            first = slot->status;
+        }
+        flags |= slot->flags;
+        if (!sink(target, slot->values, slot->count, error)) {
+            sink_failed = true;
+            break;
+        }
+        written += slot->count;
+
+        if (started > 0) {
+            pthread_mutex_lock(&p.lock);
+            slot->ready = false;
+            p.consumed++;
+            pthread_cond_broadcast(&p.drained);
+            pthread_mutex_unlock(&p.lock);
+        }
+    }
+
+    if (sink_failed) {
+        pthread_mutex_lock(&p.lock);
+        p.stop = true;
+        pthread_cond_broadcast(&p.drained);
+        pthread_mutex_unlock(&p.lock);
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    free(ids);
+    pthread_cond_destroy(&p.drained);
+    pthread_cond_destroy(&p.converted);
+    pthread_mutex_destroy(&p.lock);
+    free_slots(p.slots, p.depth);
+
+    // Codes seen on the workers become this thread's too; a failed sink
+    // has already described its own error
+    cr_error_restore(cr_error_flags() | flags, cr_last_error());
+    if (!sink_failed) {
+        if (flags != 0) {
+            cr_report(error, first.code, (CROperation)first.op, first.value1, first.value2);
+        } else {
+            cr_report_success(error);
+        }
+    }
+    return written;
+}
+
+static bool pack_sink(void* target, const CompactRational* values, size_t n, CRError* error) {
+    return cr_pack_array(values, n, (CRPackedArray*)target, error);
+}
+
+static bool file_sink(void* target, const CompactRational* values, size_t n, CRError* error) {
+    return cr_file_writer_append((CRFileWriter*)target, values, n, error);
+}
+
+// Convert pairs into a packed array
+size_t cr_pipeline_pack(const Rational* pairs, size_t n, int threads, CRPackedArray* out, CRError* error) {
+    return run_pipeline(pairs, n, threads, pack_sink, out, error);
+}
+
+// Convert pairs into an open column file
+size_t cr_pipeline_write(const Rational* pairs, size_t n, int threads, CRFileWriter* w, CRError* error) {
+    return run_pipeline(pairs, n, threads, file_sink, w, error);
+}
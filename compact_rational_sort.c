@@ -0,0 +1,378 @@
+#include "compact_rational_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Fixed-point fraction bits in a sort key
+#define CR_KEY_FRACTION_BITS 40
+
+// Added to the whole part so keys of negative values stay unsigned
+#define CR_KEY_BIAS (MAX_WHOLE_VALUE + 1)
+
+// Radix digit width and passes needed for a 56-bit key
+#define CR_RADIX_BITS 8
+#define CR_RADIX_PASSES 7
+
+// Tied runs at most this long are insertion sorted
+#define CR_TIE_INSERTION_MAX 16
+
+// ============================================================================
+// SORT KEYS
+// ============================================================================
+
+/**
+ * floor((whole + CR_KEY_BIAS + fraction) * 2^40), exactly
+ * Each tuple contributes the quotient of (n << 40) / d; the remainders are
+ * summed as one unreduced fraction (numerator under 5 * 255^5 < 2^43) whose
+ * floor supplies the carry. Everything fits in 64 bits.
+ */
+uint64_t cr_sort_key(const CompactRational* cr) {
+    uint64_t key = (uint64_t)(cr_whole_value(cr->whole) + CR_KEY_BIAS) << CR_KEY_FRACTION_BITS;
+    if (!(cr->whole & 0x8000)) {
+        return key;
+    }
+
+    uint64_t rem_num = 0, rem_denom = 1;
+    for (int i = 0; i < MAX_TUPLES; i++) {
+        uint64_t d = MIN_DENOMINATOR + (cr->tuples[i] & 0x7F);
+        uint64_t scaled = (uint64_t)(cr->tuples[i] >> 8) << CR_KEY_FRACTION_BITS;
+        key += scaled / d;
+        rem_num = rem_num * d + (scaled % d) * rem_denom;
+        rem_denom *= d;
+        if (cr->tuples[i] & 0x80) break;
+    }
+    return key + rem_num / rem_denom;
+}
+
+// ============================================================================
+// RADIX SORT
+// ============================================================================
+
+typedef struct {
+    uint64_t key;
+    size_t index;
+} SortItem;
+
+typedef struct {
+    CompactRational value;
+    size_t index;
+} TiedItem;
+
+/**
+ * Compute the sort key of every value in stream order
+ * Returns false (reporting CR_ERROR_INVALID_ENCODING for op) if the stream
+ * ends early or a value has no end flag.
+ */
+static bool extract_keys(const CRPackedArray* pa, SortItem* items, CROperation op, CRError* error) {
+    size_t pos = 0;
+    for (size_t i = 0; i < pa->count; i++) {
+        CompactRational cr;
+        size_t used = cr_unpack(pa->data + pos, pa->size - pos, &cr);
+        if (used == 0) {
+            cr_report(error, CR_ERROR_INVALID_ENCODING, op, cr_saturate_i32((int64_t)i), 0);
+            return false;
+        }
+        items[i].key = cr_sort_key(&cr);
+        items[i].index = i;
+        pos += used;
+    }
+    return true;
+}
+
+/**
+ * Stable LSD radix sort on the low 56 bits of the keys
+ * All digit histograms come from one read pass; a digit shared by every
+ * key (the fraction bytes of an integer column, the top bytes of a narrow
+ * range) costs no scatter pass. Returns whichever buffer holds the result.
+ */
+static SortItem* radix_sort(SortItem* items, SortItem* scratch, size_t n) {
+    size_t counts[CR_RADIX_PASSES][1 << CR_RADIX_BITS];
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = items[i].key;
+        for (int p = 0; p < CR_RADIX_PASSES; p++) {
+            counts[p][(key >> (p * CR_RADIX_BITS)) & 0xFF]++;
+        }
+    }
+
+    for (int p = 0; p < CR_RADIX_PASSES; p++) {
+        int shift = p * CR_RADIX_BITS;
+        if (counts[p][(items[0].key >> shift) & 0xFF] == n) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (int digit = 0; digit < (1 << CR_RADIX_BITS); digit++) {
+            size_t c = counts[p][digit];
+            counts[p][digit] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            scratch[counts[p][(items[i].key >> shift) & 0xFF]++] = items[i];
+        }
+
+        SortItem* t = items;
+        items = scratch;
+        scratch = t;
+    }
+    return items;
+}
+
+// Exact order of tied items: value, then original index
+static bool tied_before(const TiedItem* a, const TiedItem* b) {
+    int c = cr_cmp(&a->value, &b->value);
+    return c < 0 || (c == 0 && a->index < b->index);
+}
+
+// Stable merge sort of a tied run (scratch holds n items)
+static void sort_tied(TiedItem* run, TiedItem* scratch, size_t n) {
+    if (n <= CR_TIE_INSERTION_MAX) {
+        for (size_t i = 1; i < n; i++) {
+            TiedItem t = run[i];
+            size_t j = i;
+            while (j > 0 && tied_before(&t, &run[j - 1])) {
+                run[j] = run[j - 1];
+                j--;
+            }
+            run[j] = t;
+        }
+        return;
+    }
+
+    size_t half = n / 2;
+    sort_tied(run, scratch, half);
+    sort_tied(run + half, scratch, n - half);
+
+    size_t i = 0, j = half, k = 0;
+    while (i < half && j < n) {
+        scratch[k++] = tied_before(&run[j], &run[i]) ? run[j++] : run[i++];
+    }
+    while (i < half) scratch[k++] = run[i++];
+    while (j < n) scratch[k++] = run[j++];
+    memcpy(run, scratch, n * sizeof(TiedItem));
+}
+
+/**
+ * Order each run of equal keys exactly
+ * Keys are exact floors, so values with different keys are already in
+ * order. A run whose key has no fraction bits holds one integer encoded
+ * possibly several ways, and needs nothing: a non-integer lies at least
+ * 1/255^5 > 2^-40 from any integer. Other runs are decoded and
+ * sorted with cr_cmp. Real ties are rare outside repeated values, which
+ * cost one pass of comparisons.
+ */
+static bool resolve_ties(const CRPackedArray* pa, SortItem* items, size_t n, CROperation op, CRError* error) {
+    const uint64_t fraction_mask = ((uint64_t)1 << CR_KEY_FRACTION_BITS) - 1;
+    TiedItem* run = NULL;
+    size_t run_capacity = 0;
+
+    size_t start = 0;
+    while (start < n) {
+        size_t end = start + 1;
+        while (end < n && items[end].key == items[start].key) {
+            end++;
+        }
+        size_t len = end - start;
+        if (len > 1 && (items[start].key & fraction_mask) != 0) {
+            if (len > run_capacity) {
+                free(run);
+                run = malloc(2 * len * sizeof(TiedItem));
+                if (run == NULL) {
+                    cr_report(error, CR_ERROR_OUT_OF_MEMORY, op,
+                              cr_saturate_i32((int64_t)(2 * len * sizeof(TiedItem))), 0);
+                    return false;
+                }
+                run_capacity = len;
+            }
+            for (size_t i = 0; i < len; i++) {
+                run[i].index = items[start + i].index;
+                run[i].value = cr_packed_get(pa, run[i].index, NULL);
+            }
+            sort_tied(run, run + len, len);
+            for (size_t i = 0; i < len; i++) {
+                items[start + i].index = run[i].index;
+            }
+        }
+        start = end;
+    }
+
+    free(run);
+    return true;
+}
+
+// ============================================================================
+// SORTING AND SELECTION
+// ============================================================================
+
+bool cr_sort(const CRPackedArray* pa, size_t* order, CRError* error) {
+    size_t n = pa->count;
+    if (n == 0) {
+        cr_report_success(error);
+        return true;
+    }
+
+    SortItem* items = malloc(2 * n * sizeof(SortItem));
+    if (items == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_SORT, cr_saturate_i32((int64_t)(2 * n * sizeof(SortItem))), 0);
+        return false;
+    }
+
+    bool ok = extract_keys(pa, items, CR_OP_SORT, error);
+    if (ok) {
+        SortItem* sorted = radix_sort(items, items + n, n);
+        ok = resolve_ties(pa, sorted, n, CR_OP_SORT, error);
+        if (ok) {
+            for (size_t i = 0; i < n; i++) {
+                order[i] = sorted[i].index;
+            }
+            cr_report_success(error);
+        }
+    }
+
+    free(items);
+    return ok;
+}
+
+typedef struct {
+    uint64_t key;
+    CompactRational value;
+    size_t index;
+} RankItem;
+
+// Rank order for top-k: larger value first, then the earlier index
+static bool ranks_above(const RankItem* a, const RankItem* b) {
+    if (a->key != b->key) return a->key > b->key;
+    int c = cr_cmp(&a->value, &b->value);
+    return c > 0 || (c == 0 && a->index < b->index);
+}
+
+// Restore the min-heap (lowest rank at the root) below position i
+static void sift_down(RankItem* heap, size_t n, size_t i) {
+    for (;;) {
+        size_t lowest = i;
+        size_t left = 2 * i + 1, right = left + 1;
+        if (left < n && ranks_above(&heap[lowest], &heap[left])) lowest = left;
+        if (right < n && ranks_above(&heap[lowest], &heap[right])) lowest = right;
+        if (lowest == i) return;
+        RankItem t = heap[i];
+        heap[i] = heap[lowest];
+        heap[lowest] = t;
+        i = lowest;
+    }
+}
+
+/**
+ * Bounded min-heap over one pass of the stream
+ * Once the heap is full, a value whose key is below the root's cannot
+ * rank, so most of a large column is rejected on the key alone.
+ */
+size_t cr_topk(const CRPackedArray* pa, size_t k, size_t* order, CRError* error) {
+    if (k > pa->count) {
+        k = pa->count;
+    }
+    if (k == 0) {
+        cr_report_success(error);
+        return 0;
+    }
+
+    RankItem* heap = malloc(k * sizeof(RankItem));
+    if (heap == NULL) {
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_TOPK, cr_saturate_i32((int64_t)(k * sizeof(RankItem))), 0);
+        return 0;
+    }
+
+    size_t filled = 0, pos = 0;
+    for (size_t i = 0; i < pa->count; i++) {
+        RankItem item;
+        size_t used = cr_unpack(pa->data + pos, pa->size - pos, &item.value);
+        if (used == 0) {
+            cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_TOPK, cr_saturate_i32((int64_t)i), 0);
+            free(heap);
+            return 0;
+        }
+        pos += used;
+        item.key = cr_sort_key(&item.value);
+        item.index = i;
+
+        if (filled < k) {
+            // Sift up
+            size_t j = filled++;
+            while (j > 0 && ranks_above(&heap[(j - 1) / 2], &item)) {
+                heap[j] = heap[(j - 1) / 2];
+                j = (j - 1) / 2;
+            }
+            heap[j] = item;
+        } else if (item.key >= heap[0].key && ranks_above(&item, &heap[0])) {
+            heap[0] = item;
+            sift_down(heap, k, 0);
+        }
+    }
+
+    // Popping the root yields the lowest rank first
+    for (size_t n = k; n > 0; n--) {
+        order[n - 1] = heap[0].index;
+        heap[0] = heap[n - 1];
+        sift_down(heap, n - 1, 0);
+    }
+
+    free(heap);
+    cr_report_success(error);
+    return k;
+}
+
+/**
+ * Bin lookup by binary search over the edge keys
+ * The last edge whose key does not exceed the value's is the candidate:
+ * any later edge has a larger key and so a larger value. Only when the
+ * keys are equal does cr_cmp decide, stepping back past edges above the
+ * value.
+ */
+size_t cr_histogram(const CRPackedArray* pa, const CompactRational* edges, size_t bins,
+                    uint64_t* counts, CRError* error) {
+    uint64_t edge_keys_local[64];
+    uint64_t* edge_keys = edge_keys_local;
+    if (bins + 1 > sizeof(edge_keys_local) / sizeof(edge_keys_local[0])) {
+        edge_keys = malloc((bins + 1) * sizeof(uint64_t));
+        if (edge_keys == NULL) {
+            cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_HISTOGRAM,
+                      cr_saturate_i32((int64_t)((bins + 1) * sizeof(uint64_t))), 0);
+            return 0;
+        }
+    }
+    for (size_t b = 0; b <= bins; b++) {
+        edge_keys[b] = cr_sort_key(&edges[b]);
+    }
+    memset(counts, 0, bins * sizeof(uint64_t));
+
+    size_t binned = 0, pos = 0;
+    for (size_t i = 0; i < pa->count; i++) {
+        CompactRational cr;
+        size_t used = cr_unpack(pa->data + pos, pa->size - pos, &cr);
+        if (used == 0) {
+            cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_HISTOGRAM, cr_saturate_i32((int64_t)i), 0);
+            if (edge_keys != edge_keys_local) free(edge_keys);
+            return binned;
+        }
+        pos += used;
+        uint64_t key = cr_sort_key(&cr);
+
+        // Number of edges with key <= value key
+        size_t lo = 0, hi = bins + 1;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (edge_keys[mid] <= key) lo = mid + 1; else hi = mid;
+        }
+        while (lo > 0 && edge_keys[lo - 1] == key && cr_cmp(&cr, &edges[lo - 1]) < 0) {
+            lo--;
+        }
+
+        // lo edges lie at or below the value: bin lo - 1, if it is a bin
+        if (lo > 0 && lo <= bins) {
+            counts[lo - 1]++;
+            binned++;
+        }
+    }
+
+    if (edge_keys != edge_keys_local) free(edge_keys);
+    cr_report_success(error);
+    return binned;
+}
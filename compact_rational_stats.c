@@ -0,0 +1,86 @@
+#include "compact_rational_internal.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+#if CR_ENABLE_STATS
+
+__thread CRStatsBlock* cr_thread_stats = NULL;
+
+// Blocks of live threads, and the totals of threads that have exited
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static CRStatsBlock* live_blocks = NULL;
+static CRStats retired;
+static pthread_key_t stats_key;
+static pthread_once_t stats_once = PTHREAD_ONCE_INIT;
+
+// Shared by threads whose block could not be allocated
+static CRStatsBlock fallback_block;
+
+static void add_stats(CRStats* total, const CRStats* part) {
+    for (int i = 0; i < CR_STAT_COUNTER_COUNT; i++) {
+        total->counters[i] += __atomic_load_n(&part->counters[i], __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i <= MAX_TUPLES; i++) {
+        total->to_rational_depth[i] += __atomic_load_n(&part->to_rational_depth[i], __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < CR_STATS_CYCLE_BUCKETS; i++) {
+        total->add_slow_cycles[i] += __atomic_load_n(&part->add_slow_cycles[i], __ATOMIC_RELAXED);
+    }
+}
+
+// Thread-exit destructor: fold the block into the retired totals
+static void retire_block(void* arg) {
+    CRStatsBlock* block = (CRStatsBlock*)arg;
+    pthread_mutex_lock(&stats_lock);
+    add_stats(&retired, &block->stats);
+    if (block->prev != NULL) block->prev->next = block->next;
+    else live_blocks = block->next;
+    if (block->next != NULL) block->next->prev = block->prev;
+    pthread_mutex_unlock(&stats_lock);
+    free(block);
+}
+
+static void create_stats_key(void) {
+    pthread_key_create(&stats_key, retire_block);
+}
+
+// Give the calling thread its block; a static fallback keeps counting if
+// the allocation fails
+CRStatsBlock* cr_stats_register(void) {
+    CRStatsBlock* block = (CRStatsBlock*)calloc(1, sizeof(CRStatsBlock));
+    if (block == NULL) return &fallback_block;
+
+    pthread_once(&stats_once, create_stats_key);
+    pthread_mutex_lock(&stats_lock);
+    block->next = live_blocks;
+    if (live_blocks != NULL) live_blocks->prev = block;
+    live_blocks = block;
+    pthread_mutex_unlock(&stats_lock);
+    pthread_setspecific(stats_key, block);
+    cr_thread_stats = block;
+    return block;
+}
+
+#endif // CR_ENABLE_STATS
+
+// Totals over every thread, including threads that have exited
+CRStats cr_stats_snapshot(void) {
+    CRStats total;
+    memset(&total, 0, sizeof(total));
+#if CR_ENABLE_STATS
+    total.enabled = true;
+    pthread_mutex_lock(&stats_lock);
+    add_stats(&total, &retired);
+    add_stats(&total, &fallback_block.stats);
+    for (const CRStatsBlock* block = live_blocks; block != NULL; block = block->next) {
+        add_stats(&total, &block->stats);
+    }
+    pthread_mutex_unlock(&stats_lock);
+#endif
+    return total;
+}
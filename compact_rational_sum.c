@@ -0,0 +1,504 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "compact_rational_internal.h"
+#include "antichain_table.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// Smallest slice worth handing to a thread of its own
+#define CR_SUM_MIN_CHUNK 16384
+
+// Values converted to fixed point per weighted-sum block
+#define CR_WEIGHTED_CHUNK 256
+
+// Largest denominator lcm per operand for the fixed-point weighted sum
+#define CR_WEIGHTED_MAX_LCM ((uint64_t)1 << 32)
+
+// Bound on |value| / lcm for a fixed-point operand: whole part plus five
+// tuples below 2 each
+#define CR_WEIGHTED_MAGNITUDE (MAX_WHOLE_VALUE + 1 + 2 * MAX_TUPLES)
+
+// ============================================================================
+// WIDE ACCUMULATOR
+// ============================================================================
+
+// Reset an accumulator to zero
+void cr_wide_sum_init(CRWideSum* acc) {
+    acc->whole = 0;
+    memset(acc->numerators, 0, sizeof(acc->numerators));
+}
+
+// Accumulate an array of values; no reduction happens here
+void cr_wide_sum_add_array(CRWideSum* acc, const CompactRational* values, size_t n) {
+    int64_t whole = acc->whole;
+
+    for (size_t i = 0; i < n; i++) {
+        const CompactRational* cr = &values[i];
+        whole += cr_whole_value(cr->whole);
+        if (!(cr->whole & 0x8000)) {
+            continue;
+        }
+
+        // Same walk as cr_to_rational: stop at the end flag or MAX_TUPLES
+        for (int t = 0; t < MAX_TUPLES; t++) {
+            uint16_t tuple = cr->tuples[t];
+            acc->numerators[tuple & 0x7F] += tuple >> 8;
+            if (tuple & 0x80) {
+                break;
+            }
+        }
+    }
+
+    acc->whole = whole;
+}
+
+// Fold another accumulator into this one
+void cr_wide_sum_merge(CRWideSum* acc, const CRWideSum* other) {
+    acc->whole += other->whole;
+    for (int i = 0; i < CR_DENOM_RANGE; i++) {
+        acc->numerators[i] += other->numerators[i];
+    }
+}
+
+// Largest common denominator tried for an exact re-encoding; with at most
+// CR_DENOM_RANGE terms below 1 the numerator stays below 2^127
+#define CR_SUM_MAX_EXACT_LCM ((unsigned __int128)1 << 119)
+
+/**
+ * Re-encode more than MAX_TUPLES residues exactly: the sum over their lcm
+ * goes through cr_encode_wide, which may find a cover with fewer tuples on
+ * other denominators (1/128 + ... + 1/133 fits five). Returns false, with
+ * num and whole untouched and no error reported, if the lcm grows past
+ * CR_SUM_MAX_EXACT_LCM or no exact encoding exists.
+ */
+static bool encode_exact_tail(uint64_t* num, int64_t* whole) {
+    unsigned __int128 lcm = 1;
+    __int128 total = 0;
+    for (int i = 0; i < CR_DENOM_RANGE; i++) {
+        if (num[i] == 0) continue;
+        uint64_t denom = MIN_DENOMINATOR + i;
+        uint64_t factor = denom / (uint64_t)gcd((int64_t)(lcm % denom), (int64_t)denom);
+        if (lcm > CR_SUM_MAX_EXACT_LCM / factor) {
+            return false;
+        }
+        lcm *= factor;
+        total = total * (__int128)factor + (__int128)(num[i] * (lcm / denom));
+    }
+
+    uint32_t saved_flags = cr_error_flags();
+    CRStatus saved_last = cr_last_error();
+    CRError local;
+    CompactRational cr = cr_encode_wide(total, (__int128)lcm, CR_OP_SUM, &local);
+    cr_error_restore(saved_flags, saved_last);
+    if (local.code != CR_SUCCESS) {
+        return false;
+    }
+
+    memset(num, 0, CR_DENOM_RANGE * sizeof(num[0]));
+    *whole += cr_whole_value(cr.whole);
+    for (int t = 0; t < MAX_TUPLES && (cr.whole & 0x8000); t++) {
+        num[cr.tuples[t] & 0x7F] = cr.tuples[t] >> 8;
+        if (cr.tuples[t] & 0x80) break;
+    }
+    return true;
+}
+
+/**
+ * Replace the tuples after the first MAX_TUPLES - 1 by one approximation
+ * The tail is summed in long double, its integer part carried into the
+ * whole, and the remainder rounded to the nearest n/d over the offsets that
+ * are free. Returns the number of tuples the exact result needed.
+ */
+static int approximate_tail(uint64_t* num, int64_t* whole) {
+    int needed = 0;
+    long double tail = 0.0L;
+    for (int i = 0; i < CR_DENOM_RANGE; i++) {
+        if (num[i] == 0) continue;
+        if (++needed >= MAX_TUPLES) {
+            tail += (long double)num[i] / (MIN_DENOMINATOR + i);
+            num[i] = 0;
+        }
+    }
+
+    long double carry = floorl(tail);
+    *whole += (int64_t)carry;
+    long double frac = tail - carry;
+
+    // Rounding to 0/d or d/d means no tuple at all
+    long double best_err = frac < 0.5L ? frac : 1.0L - frac;
+    int best_offset = -1;
+    uint64_t best_num = 0;
+    for (int i = 0; i < CR_DENOM_RANGE; i++) {
+        if (num[i] != 0) continue;  // Offset taken by an exact tuple
+        long double d = MIN_DENOMINATOR + i;
+        uint64_t n = (uint64_t)llroundl(frac * d);
+        if (n == 0 || n >= (uint64_t)(MIN_DENOMINATOR + i)) continue;
+        long double err = fabsl(frac - n / d);
+        if (err < best_err) {
+            best_err = err;
+            best_offset = i;
+            best_num = n;
+        }
+    }
+
+    if (best_offset >= 0) {
+        num[best_offset] = best_num;
+    } else if (frac >= 0.5L) {
+        *whole += 1;
+    }
+    return needed;
+}
+
+/**
+ * Replace several tuples by one when their sum has a denominator <= 255
+ * (1/3 + 1/6 becomes 64/128). With at most MAX_TUPLES terms the common
+ * denominator stays below 255^5, so the exact sum fits in 64 bits.
+ * Returns the resulting tuple count.
+ */
+static int collapse_to_single_tuple(uint64_t* num, int64_t* whole) {
+    Rational frac = {0, 1};
+    int count = 0;
+    for (int i = 0; i < CR_DENOM_RANGE; i++) {
+        if (num[i] == 0) continue;
+        int64_t denom = MIN_DENOMINATOR + i;
+        frac.numerator = frac.numerator * denom + (int64_t)num[i] * frac.denominator;
+        frac.denominator *= denom;
+        reduce_rational(&frac);
+        count++;
+    }
+
+    if (frac.denominator > MAX_DENOMINATOR) {
+        return count;
+    }
+
+    memset(num, 0, CR_DENOM_RANGE * sizeof(num[0]));
+    *whole += frac.numerator / frac.denominator;
+    int64_t rem = frac.numerator % frac.denominator;
+    if (rem == 0) {
+        return 0;
+    }
+    num[cr_antichain_denominator_table[frac.denominator] - MIN_DENOMINATOR] =
+        (uint64_t)rem * cr_antichain_scale_table[frac.denominator];
+    return 1;
+}
+
+/**
+ * Canonicalize an accumulated sum into an unclamped whole part and a
+ * fraction (a compact rational with whole part 0)
+ *
+ * Offsets are visited from the largest denominator down. Each residue is
+ * reduced and moved onto the smallest antichain denominator that holds it
+ * exactly; that denominator is never larger, so a single descending pass
+ * merges every pair of equal fractions (64/128 and 75/150 both land on
+ * 64/128) and carries whole parts as they appear. Fractions on different
+ * denominators are then combined when their sum fits a single tuple.
+ * More than MAX_TUPLES residues are re-encoded exactly over their lcm;
+ * only if that fails is the tail approximated, and *needed then receives
+ * the residue count (0 otherwise).
+ */
+int64_t cr_wide_sum_split(const CRWideSum* acc, CompactRational* fraction, int* needed) {
+    cr_init(fraction);
+
+    int64_t whole = acc->whole;
+    uint64_t num[CR_DENOM_RANGE];
+    memcpy(num, acc->numerators, sizeof(num));
+
+    int tuple_count = 0;
+    for (int i = CR_DENOM_RANGE - 1; i >= 0; i--) {
+        uint64_t denom = MIN_DENOMINATOR + i;
+        whole += (int64_t)(num[i] / denom);
+        uint64_t rem = num[i] % denom;
+        num[i] = 0;
+        if (rem == 0) continue;
+
+        uint64_t g = (uint64_t)gcd((int64_t)rem, (int64_t)denom);
+        uint64_t reduced = denom / g;
+        int target = cr_antichain_denominator_table[reduced] - MIN_DENOMINATOR;
+        uint64_t scaled = (rem / g) * cr_antichain_scale_table[reduced];
+        if (target == i) {
+            num[i] = scaled;
+            tuple_count++;
+        } else {
+            num[target] += scaled;  // Visited later in this pass
+        }
+    }
+
+    if (tuple_count > 1 && tuple_count <= MAX_TUPLES) {
+        tuple_count = collapse_to_single_tuple(num, &whole);
+    }
+
+    *needed = tuple_count > MAX_TUPLES && !encode_exact_tail(num, &whole) ? approximate_tail(num, &whole) : 0;
+
+    // Emit the surviving tuples in ascending denominator order
+    int tuple_idx = 0;
+    int last = -1;
+    for (int i = 0; i < CR_DENOM_RANGE; i++) {
+        if (num[i] == 0) continue;
+        fraction->tuples[tuple_idx++] = (uint16_t)((num[i] << 8) | (uint16_t)i);
+        last = tuple_idx - 1;
+    }
+
+    if (last >= 0) {
+        fraction->whole = (int16_t)0x8000;
+        fraction->tuples[last] |= 0x80;  // End flag on the last tuple
+    }
+    return whole;
+}
+
+// Build the canonical compact rational for an accumulated sum
+CompactRational cr_wide_sum_result(const CRWideSum* acc, CRError* error) {
+    CompactRational result;
+    int needed;
+    int64_t whole = cr_wide_sum_split(acc, &result, &needed);
+
+    if (needed > 0) {
+        cr_report(error, CR_ERROR_TUPLE_BOUNDS, CR_OP_SUM, needed, MAX_TUPLES);
+    } else {
+        cr_report_success(error);
+    }
+
+    if (whole > MAX_WHOLE_VALUE || whole < MIN_WHOLE_VALUE) {
+        whole = cr_clamp_whole(whole, CR_OP_SUM, error);
+    }
+    result.whole = (int16_t)((whole & 0x7FFF) | (result.whole & 0x8000));
+    return result;
+}
+
+// Public names of the accumulator operations
+void cr_acc_init(CRAccumulator* acc) {
+    cr_wide_sum_init(acc);
+}
+
+void cr_acc_add_array(CRAccumulator* acc, const CompactRational* values, size_t n) {
+    cr_wide_sum_add_array(acc, values, n);
+}
+
+void cr_acc_merge(CRAccumulator* acc, const CRAccumulator* other) {
+    cr_wide_sum_merge(acc, other);
+}
+
+CompactRational cr_acc_finish(const CRAccumulator* acc, CRError* error) {
+    return cr_wide_sum_result(acc, error);
+}
+
+// ============================================================================
+// PARALLEL SUM
+// ============================================================================
+
+typedef struct {
+    const CompactRational* values;
+    size_t n;
+    CRWideSum sum;
+} SumWorker;
+
+static void* sum_worker(void* arg) {
+    SumWorker* w = (SumWorker*)arg;
+
+    // Accumulate on the stack so workers never share a cache line while
+    // running; the slot in the shared array is written once at the end
+    CRWideSum local;
+    cr_wide_sum_init(&local);
+    cr_wide_sum_add_array(&local, w->values, w->n);
+    w->sum = local;
+    return NULL;
+}
+
+// Number of threads to use for n values
+static int sum_thread_count(size_t n, int threads) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    size_t useful = n / CR_SUM_MIN_CHUNK;
+    if (useful < (size_t)threads) {
+        threads = useful > 0 ? (int)useful : 1;
+    }
+    return threads;
+}
+
+// Accumulate a column into total using several threads
+void cr_wide_sum_parallel(const CompactRational* values, size_t n, int threads, CRWideSum* total) {
+    cr_wide_sum_init(total);
+
+    threads = sum_thread_count(n, threads);
+    SumWorker* workers = threads > 1 ? malloc((size_t)threads * sizeof(SumWorker)) : NULL;
+    pthread_t* ids = workers != NULL ? malloc((size_t)threads * sizeof(pthread_t)) : NULL;
+
+    if (ids == NULL) {
+        // Single thread requested, or no memory for bookkeeping: sum inline
+        free(workers);
+        cr_wide_sum_add_array(total, values, n);
+        return;
+    }
+
+    size_t chunk = n / (size_t)threads;
+    bool* started = calloc((size_t)threads, sizeof(bool));
+    for (int t = 0; t < threads; t++) {
+        workers[t].values = values + (size_t)t * chunk;
+        workers[t].n = t == threads - 1 ? n - (size_t)t * chunk : chunk;
+        cr_wide_sum_init(&workers[t].sum);
+
+        // Slice 0 runs on the calling thread; a failed create runs inline too
+        if (t > 0 && started != NULL && pthread_create(&ids[t], NULL, sum_worker, &workers[t]) == 0) {
+            started[t] = true;
+        }
+    }
+
+    for (int t = 0; t < threads; t++) {
+        if (started == NULL || !started[t]) {
+            sum_worker(&workers[t]);
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        if (started != NULL && started[t]) {
+            pthread_join(ids[t], NULL);
+        }
+        cr_wide_sum_merge(total, &workers[t].sum);
+    }
+
+    free(started);
+    free(ids);
+    free(workers);
+}
+
+// Sum a column using several threads
+CompactRational cr_sum_parallel(const CompactRational* values, size_t n, int threads, CRError* error) {
+    CRWideSum total;
+    cr_wide_sum_parallel(values, n, threads, &total);
+    return cr_wide_sum_result(&total, error);
+}
+
+// ============================================================================
+// WEIGHTED SUM
+// ============================================================================
+
+/**
+ * Lcm of every tuple denominator in a column, or false if it passes
+ * CR_WEIGHTED_MAX_LCM. Distinct denominators are collected in a bitmap
+ * first, so the lcm costs one gcd per distinct denominator.
+ */
+static bool denominator_lcm(const CompactRational* values, size_t n, uint64_t* lcm) {
+    uint64_t seen[2] = {0, 0};
+    for (size_t i = 0; i < n; i++) {
+        if (!(values[i].whole & 0x8000)) continue;
+        for (int k = 0; k < MAX_TUPLES; k++) {
+            unsigned offset = values[i].tuples[k] & 0x7F;
+            seen[offset >> 6] |= (uint64_t)1 << (offset & 63);
+            if (values[i].tuples[k] & 0x80) break;
+        }
+    }
+
+    uint64_t l = 1;
+    for (unsigned offset = 0; offset < CR_DENOM_RANGE; offset++) {
+        if (!(seen[offset >> 6] >> (offset & 63) & 1)) continue;
+        uint64_t d = MIN_DENOMINATOR + offset;
+        l = l / (uint64_t)gcd((int64_t)l, (int64_t)d) * d;
+        if (l > CR_WEIGHTED_MAX_LCM) return false;
+    }
+    *lcm = l;
+    return true;
+}
+
+// value * lcm, exact because every tuple denominator divides lcm
+static inline int64_t to_fixed(const CompactRational* v, int64_t lcm, const int64_t* scale) {
+    int64_t x = (int64_t)cr_whole_value(v->whole) * lcm;
+    if (v->whole & 0x8000) {
+        for (int k = 0; k < MAX_TUPLES; k++) {
+            x += (int64_t)(v->tuples[k] >> 8) * scale[v->tuples[k] & 0x7F];
+            if (v->tuples[k] & 0x80) break;
+        }
+    }
+    return x;
+}
+
+/**
+ * Fallback for columns with too many distinct denominators: multiply each
+ * pair with cr_mul and sum the products in the wide accumulator. Exact
+ * unless a product clamps or needs more than MAX_TUPLES tuples.
+ */
+static CompactRational weighted_sum_products(const CompactRational* weights, const CompactRational* scores,
+                                             size_t n, CRError* error) {
+    CRWideSum acc;
+    cr_wide_sum_init(&acc);
+    CRError first = {CR_SUCCESS, "", 0, 0};
+
+    CompactRational products[CR_WEIGHTED_CHUNK];
+    for (size_t start = 0; start < n; start += CR_WEIGHTED_CHUNK) {
+        size_t count = n - start < CR_WEIGHTED_CHUNK ? n - start : CR_WEIGHTED_CHUNK;
+        for (size_t j = 0; j < count; j++) {
+            CRError local;
+            products[j] = cr_mul(&weights[start + j], &scores[start + j], &local);
+            if (local.code != CR_SUCCESS && first.code == CR_SUCCESS) first = local;
+        }
+        cr_wide_sum_add_array(&acc, products, count);
+    }
+
+    CompactRational result;
+    int needed;
+    int64_t whole = cr_wide_sum_split(&acc, &result, &needed);
+    if (needed > 0) {
+        cr_report(error, CR_ERROR_INEXACT, CR_OP_WEIGHTED_SUM, MAX_TUPLES, MAX_TUPLES);
+    } else if (first.code != CR_SUCCESS) {
+        cr_report(error, first.code, CR_OP_WEIGHTED_SUM, first.value1, first.value2);
+    } else {
+        cr_report_success(error);
+    }
+    if (whole > MAX_WHOLE_VALUE || whole < MIN_WHOLE_VALUE) {
+        whole = cr_clamp_whole(whole, CR_OP_WEIGHTED_SUM, error);
+    }
+    result.whole = (int16_t)((whole & 0x7FFF) | (result.whole & 0x8000));
+    return result;
+}
+
+/**
+ * Weighted sum in fixed point
+ * With Lw and Ls the lcms of the weight and score denominators, every
+ * weight * Lw and score * Ls is an integer, so the sum is an integer dot
+ * product over Lw * Ls. Blocks are converted to int64 first; the dot loop
+ * then runs on plain arrays, in int64 when the bounds allow and in 128-bit
+ * otherwise, and the exact total is encoded once.
+ */
+CompactRational cr_weighted_sum(const CompactRational* weights, const CompactRational* scores, size_t n,
+                                CRError* error) {
+    uint64_t lw, ls;
+    if (!denominator_lcm(weights, n, &lw) || !denominator_lcm(scores, n, &ls)) {
+        return weighted_sum_products(weights, scores, n, error);
+    }
+
+    int64_t scale_w[CR_DENOM_RANGE], scale_s[CR_DENOM_RANGE];
+    for (int offset = 0; offset < CR_DENOM_RANGE; offset++) {
+        uint64_t d = MIN_DENOMINATOR + offset;
+        scale_w[offset] = lw % d == 0 ? (int64_t)(lw / d) : 0;
+        scale_s[offset] = ls % d == 0 ? (int64_t)(ls / d) : 0;
+    }
+
+    // Products of one block fit int64 when both operands are well below 2^31
+    __int128 bound = (__int128)CR_WEIGHTED_MAGNITUDE * lw * CR_WEIGHTED_MAGNITUDE * ls * CR_WEIGHTED_CHUNK;
+    bool narrow = bound < ((__int128)1 << 63);
+
+    __int128 total = 0;
+    int64_t wf[CR_WEIGHTED_CHUNK], sf[CR_WEIGHTED_CHUNK];
+    for (size_t start = 0; start < n; start += CR_WEIGHTED_CHUNK) {
+        size_t count = n - start < CR_WEIGHTED_CHUNK ? n - start : CR_WEIGHTED_CHUNK;
+        for (size_t j = 0; j < count; j++) {
+            wf[j] = to_fixed(&weights[start + j], (int64_t)lw, scale_w);
+            sf[j] = to_fixed(&scores[start + j], (int64_t)ls, scale_s);
+        }
+        if (narrow) {
+            int64_t block = 0;
+            for (size_t j = 0; j < count; j++) {
+                block += wf[j] * sf[j];
+            }
+            total += block;
+        } else {
+            for (size_t j = 0; j < count; j++) {
+                total += (__int128)wf[j] * sf[j];
+            }
+        }
+    }
+
+    return cr_encode_wide(total, (__int128)lw * ls, CR_OP_WEIGHTED_SUM, error);
+}
@@ -0,0 +1,504 @@
+#include "compact_rational_internal.h"
+#include <string.h>
+
+// Longest digit run accepted in one component (10^18 < 2^63)
+#define CR_PARSE_MAX_DIGITS 18
+
+// Values parsed per chunk by cr_parse_packed before packing
+#define CR_PARSE_CHUNK 256
+
+// ============================================================================
+// INTEGER FIELD FAST PATH
+// ============================================================================
+
+/**
+ * SWAR scan of eight bytes: the number of leading ASCII digits (0-8)
+ * Each byte is XORed with '0', leaving 0-9 for digits; a byte is a digit
+ * when neither its high nibble nor its value + 6 reaches 0x10. A carry out
+ * of a non-digit byte can only disturb later bytes, and only the first
+ * non-digit matters.
+ */
+static inline int leading_digits(uint64_t chunk, uint64_t* values) {
+    uint64_t x = chunk ^ 0x3030303030303030ull;
+    uint64_t bad = (x | (x + 0x0606060606060606ull)) & 0xF0F0F0F0F0F0F0F0ull;
+    *values = x;
+    return bad == 0 ? 8 : __builtin_ctzll(bad) / 8;
+}
+
+/**
+ * Value of the first n digit bytes (1-8) of x, most significant first
+ * The digits are shifted to the top of the word (leading zeros below),
+ * then adjacent lanes are combined pairwise: 2, 4 and 8 digits at a time.
+ */
+static inline uint32_t swar_digits(uint64_t x, int n) {
+    x <<= 8 * (8 - n);
+    x = (x * 10 + (x >> 8)) & 0x00FF00FF00FF00FFull;
+    x = (x * 100 + (x >> 16)) & 0x0000FFFF0000FFFFull;
+    x = (x * 10000 + (x >> 32)) & 0xFFFFFFFFull;
+    return (uint32_t)x;
+}
+
+// ============================================================================
+// GENERAL PARSER
+// ============================================================================
+
+static inline bool is_digit(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+static inline bool is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// Digit run at *p (at most CR_PARSE_MAX_DIGITS); returns the digit count
+static int parse_digits(const char** p, const char* end, int64_t* value) {
+    const char* s = *p;
+    int64_t v = 0;
+    int n = 0;
+    while (s < end && is_digit(*s)) {
+        if (++n > CR_PARSE_MAX_DIGITS) return -1;
+        v = v * 10 + (*s++ - '0');
+    }
+    *p = s;
+    *value = v;
+    return n;
+}
+
+/**
+ * Parse one value from [p, end)
+ * Accepts [+-]W, [+-]W.F, [+-].F, [+-]N/D and [+-]W N/D (the sign applies
+ * to the whole mixed number, as cr_format writes it). Returns the end of
+ * the value, or NULL if none starts at p.
+ */
+static const char* parse_value(const char* p, const char* end, CompactRational* out, CRError* error) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p++ == '-';
+    }
+
+    int64_t whole;
+    int whole_digits = parse_digits(&p, end, &whole);
+    if (whole_digits < 0) return NULL;
+
+    __int128 num, denom;
+    if (p < end && *p == '.') {
+        p++;
+        int64_t fraction;
+        int fraction_digits = parse_digits(&p, end, &fraction);
+        if (fraction_digits <= 0) return NULL;
+        int64_t scale = 1;
+        for (int i = 0; i < fraction_digits; i++) scale *= 10;
+        num = (__int128)whole * scale + fraction;
+        denom = scale;
+    } else if (whole_digits == 0) {
+        return NULL;
+    } else if (p < end && *p == '/') {
+        p++;
+        int64_t d;
+        if (parse_digits(&p, end, &d) <= 0 || d == 0) return NULL;
+        num = whole;
+        denom = d;
+    } else {
+        // Mixed number, if blanks are followed by N/D; otherwise an integer
+        const char* q = p;
+        while (q < end && is_blank(*q)) q++;
+        int64_t n, d;
+        if (q == p || parse_digits(&q, end, &n) <= 0 || q >= end || *q != '/') {
+            int32_t w = cr_clamp_whole(negative ? -whole : whole, CR_OP_PARSE, error);
+            cr_init(out);
+            out->whole = (int16_t)(w & 0x7FFF);
+            return p;
+        }
+        q++;
+        if (parse_digits(&q, end, &d) <= 0 || d == 0) return NULL;
+        num = (__int128)whole * d + n;
+        denom = d;
+        p = q;
+    }
+
+    *out = cr_encode_wide(negative ? -num : num, denom, CR_OP_PARSE, error);
+    return p;
+}
+
+size_t cr_parse(const char* text, size_t len, CompactRational* out, CRError* error) {
+    const char* p = text;
+    const char* end = text + len;
+    while (p < end && is_blank(*p)) p++;
+
+    const char* stop = parse_value(p, end, out, error);
+    if (stop == NULL) {
+        cr_report(error, CR_ERROR_SYNTAX, CR_OP_PARSE, 0, cr_saturate_i32(p - text));
+        cr_init(out);
+        return 0;
+    }
+    return (size_t)(stop - text);
+}
+
+// ============================================================================
+// FIELD STREAMS
+// ============================================================================
+
+static inline bool is_separator(char c, char delimiter) {
+    return c == delimiter || c == '\n' || c == '\r';
+}
+
+/**
+ * Field loop
+ * Short unsigned or negative integer fields are read eight bytes at a time
+ * and never reach the general parser. Other fields are delimited first, so
+ * a field cut off by the end of a non-final buffer is left for the next
+ * call. Encoding issues (clamping, inexact decimals) do not stop the
+ * stream; the first one is reported when nothing worse happens.
+ */
+size_t cr_parse_array(const char* text, size_t len, char delimiter, bool final,
+                      CompactRational* out, size_t max, size_t* consumed, CRError* error) {
+    const char* p = text;
+    const char* end = text + len;
+    size_t count = 0;
+    bool failed = false;
+    CRError first_issue;
+    first_issue.code = CR_SUCCESS;
+
+    while (count < max && p < end) {
+        // Fast path: [-]digits followed by a separator, 8 bytes readable
+        const char* digits = p + (*p == '-');
+        if (end - digits >= 8) {
+            uint64_t chunk, x;
+            memcpy(&chunk, digits, sizeof(chunk));
+            int n = leading_digits(chunk, &x);
+            if (n > 0 && n < 8 && is_separator(digits[n], delimiter)) {
+                int64_t v = swar_digits(x, n);
+                if (digits != p) v = -v;
+                CompactRational* cr = &out[count++];
+                memset(cr, 0, sizeof(*cr));
+                if (v > MAX_WHOLE_VALUE || v < MIN_WHOLE_VALUE) {
+                    CRError local;
+                    cr->whole = (int16_t)(cr_clamp_whole(v, CR_OP_PARSE, &local) & 0x7FFF);
+                    if (first_issue.code == CR_SUCCESS) first_issue = local;
+                } else {
+                    cr->whole = (int16_t)(v & 0x7FFF);
+                }
+                p = digits + n + 1;
+                continue;
+            }
+        }
+
+        // General path: find the separator, then parse the trimmed field
+        const char* stop = p;
+        while (stop < end && !is_separator(*stop, delimiter)) stop++;
+        if (stop == end && !final) break;  // Rest of the field is not here yet
+
+        const char* first = p;
+        const char* last = stop;
+        while (first < last && is_blank(*first)) first++;
+        while (last > first && is_blank(last[-1])) last--;
+        if (first == last) {
+            // Blank line, or the empty field of a trailing delimiter or CR LF
+            if (stop < end && *stop == delimiter) {
+                cr_report(error, CR_ERROR_SYNTAX, CR_OP_PARSE, cr_saturate_i32((int64_t)count),
+                          cr_saturate_i32(p - text));
+                failed = true;
+                break;
+            }
+            p = stop < end ? stop + 1 : stop;
+            continue;
+        }
+
+        CRError local;
+        if (parse_value(first, last, &out[count], &local) != last) {
+            cr_report(error, CR_ERROR_SYNTAX, CR_OP_PARSE, cr_saturate_i32((int64_t)count),
+                      cr_saturate_i32(first - text));
+            failed = true;
+            break;
+        }
+        if (local.code != CR_SUCCESS && first_issue.code == CR_SUCCESS) first_issue = local;
+        count++;
+        p = stop < end ? stop + 1 : stop;
+    }
+
+    if (consumed != NULL) *consumed = (size_t)(p - text);
+    if (!failed) {
+        if (first_issue.code != CR_SUCCESS) {
+            if (error != NULL) *error = first_issue;
+        } else {
+            cr_report_success(error);
+        }
+    }
+    return count;
+}
+
+bool cr_parse_packed(const char* text, size_t len, char delimiter, bool final,
+                     CRPackedArray* out, size_t* consumed, CRError* error) {
+    CompactRational chunk[CR_PARSE_CHUNK];
+    size_t pos = 0;
+    CRError first_issue;
+    first_issue.code = CR_SUCCESS;
+
+    for (;;) {
+        size_t used;
+        CRError local;
+        size_t n = cr_parse_array(text + pos, len - pos, delimiter, final, chunk, CR_PARSE_CHUNK, &used, &local);
+        if (n > 0 && !cr_pack_array(chunk, n, out, error)) {
+            break;  // Nothing of this chunk was appended
+        }
+        pos += used;
+
+        if (local.code != CR_SUCCESS && first_issue.code == CR_SUCCESS) first_issue = local;
+        if (local.code == CR_ERROR_SYNTAX || n < CR_PARSE_CHUNK) {
+            if (consumed != NULL) *consumed = pos;
+            if (error != NULL) {
+                if (first_issue.code != CR_SUCCESS) {
+                    *error = local.code == CR_ERROR_SYNTAX ? local : first_issue;
+                } else {
+                    cr_report_success(error);
+                }
+            }
+            return local.code != CR_ERROR_SYNTAX;
+        }
+    }
+
+    if (consumed != NULL) *consumed = pos;
+    return false;
+}
+
+// ============================================================================
+// FORMATTING
+// ============================================================================
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Write v in decimal ending just before *end; returns the first character
+static char* format_u64(char* end, uint64_t v) {
+    while (v >= 100) {
+        unsigned d = (unsigned)(v % 100) * 2;
+        v /= 100;
+        *--end = digit_pairs[d + 1];
+        *--end = digit_pairs[d];
+    }
+    if (v >= 10) {
+        *--end = digit_pairs[v * 2 + 1];
+        *--end = digit_pairs[v * 2];
+    } else {
+        *--end = (char)('0' + v);
+    }
+    return end;
+}
+
+// Write v in decimal ending just before *end, 19 digits per 64-bit step
+static char* format_u128(char* end, unsigned __int128 v) {
+    const uint64_t chunk = 10000000000000000000ull;  // 10^19
+    while (v > UINT64_MAX) {
+        uint64_t low = (uint64_t)(v % chunk);
+        v /= chunk;
+        char* stop = end - 19;
+        end = format_u64(end, low);
+        while (end > stop) *--end = '0';
+    }
+    return format_u64(end, (uint64_t)v);
+}
+
+/**
+ * Decimal form of whole + num / denom (num < denom) to six places, as
+ * "%.6f" prints it
+ * Rounds the exact value half to even; printf of the double can differ
+ * only at exact ties, where the double is already an ulp off. A negative
+ * value keeps its sign even if it rounds to zero, as printf does.
+ */
+static char* format_decimal(char* end, bool negative, uint64_t whole, uint64_t num, uint64_t denom) {
+    uint64_t scaled = num * 1000000;  // num < 2^40
+    uint64_t frac = scaled / denom;
+    uint64_t left = scaled % denom;
+    if (2 * left > denom || (2 * left == denom && (frac & 1))) {
+        frac++;
+    }
+    if (frac == 1000000) {
+        frac = 0;
+        whole++;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        unsigned d = (unsigned)(frac % 100) * 2;
+        frac /= 100;
+        *--end = digit_pairs[d + 1];
+        *--end = digit_pairs[d];
+    }
+    *--end = '.';
+    char* p = format_u64(end, whole);
+    if (negative) *--p = '-';
+    return p;
+}
+
+static const char hex_digits[17] = "0123456789ABCDEF";
+
+// "Encoding: whole=0x8007 (bit15=1) [43/129(end)]", written forward
+static size_t format_encoding(char* text, uint64_t raw_whole, int whole_bits, const uint16_t* tuples) {
+    static const char prefix[] = "Encoding: whole=0x";
+    char* p = text;
+    bool has_tuples = (raw_whole >> (whole_bits - 1)) & 1;
+
+    memcpy(p, prefix, sizeof(prefix) - 1);
+    p += sizeof(prefix) - 1;
+    for (int shift = whole_bits - 4; shift >= 0; shift -= 4) {
+        *p++ = hex_digits[(raw_whole >> shift) & 0xF];
+    }
+    memcpy(p, " (bit", 5);
+    p += 5;
+    *p++ = (char)('0' + (whole_bits - 1) / 10);
+    *p++ = (char)('0' + (whole_bits - 1) % 10);
+    memcpy(p, has_tuples ? "=1)" : "=0)", 3);
+    p += 3;
+
+    if (has_tuples) {
+        *p++ = ' ';
+        *p++ = '[';
+        for (int i = 0; i < MAX_TUPLES; i++) {
+            char digits[8];
+            char* d_end = digits + sizeof(digits);
+            char* d = format_u64(d_end, (uint64_t)(tuples[i] >> 8));
+            memcpy(p, d, (size_t)(d_end - d));
+            p += d_end - d;
+            *p++ = '/';
+            d = format_u64(d_end, (uint64_t)(MIN_DENOMINATOR + (tuples[i] & 0x7F)));
+            memcpy(p, d, (size_t)(d_end - d));
+            p += d_end - d;
+            if (tuples[i] & 0x80) {
+                memcpy(p, "(end)", 5);
+                p += 5;
+                break;
+            }
+            *p++ = ',';
+            *p++ = ' ';
+        }
+        *p++ = ']';
+    }
+    return (size_t)(p - text);
+}
+
+/**
+ * Render one value into text (CR_FORMAT_MAX bytes)
+ * whole is the decoded whole part and raw_whole the whole field of a
+ * whole_bits wide encoding (16 for CompactRational). The fraction is
+ * reduced once and the value split into sign, magnitude whole part and
+ * proper fraction, so wide whole parts never meet the denominator in
+ * 64 bits. Numbers are written right to left from the end of the buffer.
+ * Returns the start of the text and its length in *len.
+ */
+static const char* render(char* text, int64_t whole, uint64_t raw_whole, int whole_bits,
+                          const uint16_t* tuples, uint32_t flags, size_t* len) {
+    if (flags & CR_FORMAT_ENCODING) {
+        *len = format_encoding(text, raw_whole, whole_bits, tuples);
+        return text;
+    }
+
+    char* end = text + CR_FORMAT_MAX;
+    char* p = end;
+
+    CompactRational fraction;
+    fraction.whole = ((raw_whole >> (whole_bits - 1)) & 1) ? (int16_t)0x8000 : 0;
+    memcpy(fraction.tuples, tuples, sizeof(fraction.tuples));
+    int64_t num, denom;
+    cr_fraction_parts(&fraction, &num, &denom);
+    whole += num / denom;
+    num %= denom;
+    if (num == 0) {
+        denom = 1;
+    } else {
+        int64_t g = gcd(num, denom);
+        num /= g;
+        denom /= g;
+    }
+
+    // -(w + n/d) = (-w - 1) + (d - n)/d
+    bool negative = whole < 0;
+    uint64_t mag_whole = negative ? (uint64_t)-(whole + (num > 0)) : (uint64_t)whole;
+    uint64_t mag_num = (negative && num > 0) ? (uint64_t)(denom - num) : (uint64_t)num;
+
+    if (flags & CR_FORMAT_FIXED) {
+        p = format_decimal(p, negative, mag_whole, mag_num, (uint64_t)denom);
+        *len = (size_t)(end - p);
+        return p;
+    }
+    if (flags & CR_FORMAT_DECIMAL) {
+        *--p = ')';
+        p = format_decimal(p, negative, mag_whole, mag_num, (uint64_t)denom);
+        *--p = '(';
+        *--p = ' ';
+    }
+
+    if (mag_num == 0) {
+        p = format_u64(p, mag_whole);
+    } else {
+        p = format_u64(p, (uint64_t)denom);
+        *--p = '/';
+        if (flags & CR_FORMAT_IMPROPER) {
+            p = format_u128(p, (unsigned __int128)mag_whole * (uint64_t)denom + mag_num);
+        } else {
+            p = format_u64(p, mag_num);
+            if (mag_whole > 0) {
+                *--p = ' ';
+                p = format_u64(p, mag_whole);
+            }
+        }
+    }
+    if (negative) *--p = '-';
+
+    *len = (size_t)(end - p);
+    return p;
+}
+
+// Copy the text of any width into buf as snprintf would
+size_t cr_format_value(char* buf, size_t cap, int64_t whole, uint64_t raw_whole, int whole_bits,
+                       const uint16_t* tuples, uint32_t flags) {
+    char text[CR_FORMAT_MAX];
+    size_t len;
+    const char* p = render(text, whole, raw_whole, whole_bits, tuples, flags, &len);
+    if (cap > 0) {
+        size_t n = len < cap - 1 ? len : cap - 1;
+        memcpy(buf, p, n);
+        buf[n] = '\0';
+    }
+    return len;
+}
+
+size_t cr_format(char* buf, size_t cap, const CompactRational* cr, uint32_t flags) {
+    return cr_format_value(buf, cap, cr_whole_value(cr->whole), (uint16_t)cr->whole, 16, cr->tuples, flags);
+}
+
+/**
+ * Values are rendered into a local buffer and copied whole, so a value is
+ * either written completely (with its separator) or not at all; integer
+ * values without flags are written directly.
+ */
+size_t cr_format_array(char* buf, size_t cap, const CompactRational* values, size_t n,
+                       char separator, uint32_t flags, size_t* written) {
+    size_t pos = 0;
+    size_t i = 0;
+
+    for (; i < n; i++) {
+        const CompactRational* cr = &values[i];
+        char text[CR_FORMAT_MAX];
+        const char* p;
+        size_t len;
+
+        if (!(cr->whole & 0x8000) && (flags & ~CR_FORMAT_IMPROPER) == 0) {
+            int32_t whole = cr_whole_value(cr->whole);
+            char* start = format_u64(text + CR_FORMAT_MAX, (uint64_t)(whole < 0 ? -(int64_t)whole : whole));
+            if (whole < 0) *--start = '-';
+            p = start;
+            len = (size_t)(text + CR_FORMAT_MAX - start);
+        } else {
+            p = render(text, cr_whole_value(cr->whole), (uint16_t)cr->whole, 16, cr->tuples, flags, &len);
+        }
+
+        if (cap - pos < len + 1) break;
+        memcpy(buf + pos, p, len);
+        pos += len;
+        buf[pos++] = separator;
+    }
+
+    if (written != NULL) *written = pos;
+    return i;
+}
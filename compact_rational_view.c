@@ -0,0 +1,154 @@
+#include "compact_rational_internal.h"
+#include <string.h>
+
+// ============================================================================
+// WIRE FORMAT VIEWS
+// ============================================================================
+
+// Start a view over a borrowed buffer
+void cr_view_init(CRView* v, const uint8_t* data, size_t size) {
+    v->data = data;
+    v->size = size;
+    v->pos = 0;
+    v->count = 0;
+}
+
+// Length of the value at the view's position, or 0 if none is complete
+static inline size_t next_length(const CRView* v) {
+    return v->pos < v->size ? cr_packed_length(v->data + v->pos, v->size - v->pos) : 0;
+}
+
+/**
+ * Report how a loop over the view ended: last is the length of the last
+ * value looked at, 0 if it stopped on a value it could not read. That
+ * value is only malformed if all MAX_TUPLES tuples are there without an
+ * end flag; anything shorter was cut off by the buffer.
+ */
+static void report_stop(const CRView* v, size_t last, CRError* error) {
+    if (last == 0 && v->size - v->pos >= 2 + 2 * MAX_TUPLES) {
+        cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_VIEW, cr_saturate_i32((int64_t)v->count),
+                  cr_saturate_i32((int64_t)v->pos));
+        return;
+    }
+    cr_report_success(error);
+}
+
+// Decode the next value
+bool cr_view_next(CRView* v, CompactRational* out, CRError* error) {
+    return cr_view_read(v, out, 1, error) == 1;
+}
+
+// Decode up to max values
+size_t cr_view_read(CRView* v, CompactRational* out, size_t max, CRError* error) {
+    size_t len = 1;
+    size_t i = 0;
+    while (i < max && (len = next_length(v)) != 0) {
+        cr_unpack(v->data + v->pos, len, &out[i]);
+        v->pos += len;
+        i++;
+    }
+    v->count += i;
+    report_stop(v, len, error);
+    return i;
+}
+
+// Step over up to n values, reading only their flags
+size_t cr_view_skip(CRView* v, size_t n, CRError* error) {
+    size_t len = 1;
+    size_t i = 0;
+    while (i < n && (len = next_length(v)) != 0) {
+        v->pos += len;
+        i++;
+    }
+    v->count += i;
+    report_stop(v, len, error);
+    return i;
+}
+
+// Fold up to n values into an accumulator as cr_acc_add would
+size_t cr_view_accumulate(CRView* v, size_t n, CRAccumulator* acc, CRError* error) {
+    size_t len = 1;
+    size_t i = 0;
+    while (i < n && (len = next_length(v)) != 0) {
+        const uint8_t* p = v->data + v->pos;
+        uint16_t whole = (uint16_t)(p[0] | (uint16_t)p[1] << 8);
+        acc->whole += (int16_t)(uint16_t)(whole << 1) >> 1;
+        // len is 2 for an integer; tuples store the denominator byte first
+        for (size_t t = 2; t < len; t += 2) {
+            acc->numerators[p[t] & 0x7F] += p[t + 1];
+        }
+        v->pos += len;
+        i++;
+    }
+    v->count += i;
+    report_stop(v, len, error);
+    return i;
+}
+
+// Bytes not yet read
+size_t cr_view_remaining(const CRView* v) {
+    return v->size - v->pos;
+}
+
+// ============================================================================
+// WIRE FORMAT WRITERS
+// ============================================================================
+
+// Write values until one does not fit
+size_t cr_write_values(uint8_t* buf, size_t cap, const CompactRational* values, size_t n, size_t* written) {
+    size_t bytes = 0;
+    size_t i = 0;
+    for (; i < n; i++) {
+        size_t used = cr_pack(&values[i], buf + bytes, cap - bytes);
+        if (used == 0) {
+            break;
+        }
+        bytes += used;
+    }
+    if (written != NULL) *written = bytes;
+    return i;
+}
+
+// Write the pointed-to values until one does not fit
+size_t cr_write_gather(uint8_t* buf, size_t cap, const CompactRational* const* values, size_t n, size_t* written) {
+    size_t bytes = 0;
+    size_t i = 0;
+    for (; i < n; i++) {
+        size_t used = cr_pack(values[i], buf + bytes, cap - bytes);
+        if (used == 0) {
+            break;
+        }
+        bytes += used;
+    }
+    if (written != NULL) *written = bytes;
+    return i;
+}
+
+// Copy a range of the packed stream: seek, scan lengths, one memcpy
+size_t cr_write_packed(uint8_t* buf, size_t cap, const CRPackedArray* pa, size_t start, size_t n, size_t* written) {
+    if (written != NULL) *written = 0;
+    if (start >= pa->count) {
+        return 0;
+    }
+    if (n > pa->count - start) {
+        n = pa->count - start;
+    }
+
+    size_t begin = cr_packed_offset(pa, start);
+    if (begin == SIZE_MAX) {
+        return 0;
+    }
+
+    size_t end = begin;
+    size_t i = 0;
+    for (; i < n; i++) {
+        size_t len = cr_packed_length(pa->data + end, pa->size - end);
+        if (len == 0 || len > cap - (end - begin)) {
+            break;
+        }
+        end += len;
+    }
+    memcpy(buf, pa->data + begin, end - begin);
+    if (written != NULL) *written = end - begin;
+    return i;
+}
@@ -0,0 +1,189 @@
+#include "compact_rational_internal.h"
+#include <string.h>
+
+// ============================================================================
+// SHARED HELPERS
+// ============================================================================
+
+// Saturate a 128-bit whole part into an int32_t context field
+static int32_t saturate_wide(__int128 v) {
+    return v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : (int32_t)v;
+}
+
+/**
+ * Clamp a 128-bit whole part to [-limit, limit]
+ * Reports CR_ERROR_VALUE_CLAMPED for op when it has to; leaves error
+ * alone otherwise, so the status of the fraction arithmetic stands.
+ */
+static int64_t clamp_wide(__int128 whole, int64_t limit, CROperation op, CRError* error) {
+    if (whole > limit) {
+        cr_report(error, CR_ERROR_VALUE_CLAMPED, op, saturate_wide(whole), saturate_wide(limit));
+        return limit;
+    }
+    if (whole < -limit) {
+        cr_report(error, CR_ERROR_VALUE_CLAMPED, op, saturate_wide(whole), saturate_wide(-limit));
+        return -limit;
+    }
+    return (int64_t)whole;
+}
+
+// ============================================================================
+// WIDTH TEMPLATE
+//
+// Every value is handled as a whole part plus a 16-bit CompactRational
+// holding only the tuples (whole bits 0, bit 15 = tuple flag). Fraction
+// arithmetic goes through the 16-bit paths, whose whole parts stay below
+// 20; the wide whole parts are combined in 128 bits and clamped once.
+// ============================================================================
+
+#define CR_DEFINE_WIDE_TYPE(BITS, WHOLE_T, UWHOLE_T)                                                 \
+    typedef CompactRational##BITS Wide##BITS;                                                        \
+                                                                                                     \
+    static const UWHOLE_T flag##BITS = (UWHOLE_T)1 << (BITS - 1);                                   \
+    static const int64_t limit##BITS = CR##BITS##_MAX_WHOLE_VALUE;                                   \
+                                                                                                     \
+    /* Whole part of v; its tuples go to frac */                                                     \
+    static int64_t split##BITS(const Wide##BITS* v, CompactRational* frac) {                         \
+        frac->whole = ((UWHOLE_T)v->whole & flag##BITS) ? (int16_t)0x8000 : 0;                       \
+        memcpy(frac->tuples, v->tuples, sizeof(frac->tuples));                                       \
+        return (int64_t)(WHOLE_T)((UWHOLE_T)v->whole << 1) >> 1;                                     \
+    }                                                                                                \
+                                                                                                     \
+    /* whole + frac, where frac's whole part is small */                                             \
+    static Wide##BITS join##BITS(__int128 whole, const CompactRational* frac, CROperation op,        \
+                                 CRError* error) {                                                   \
+        Wide##BITS out;                                                                              \
+        int64_t w = clamp_wide(whole + cr_whole_value(frac->whole), limit##BITS, op, error);         \
+        out.whole = (WHOLE_T)(((UWHOLE_T)w & ~flag##BITS) | ((frac->whole & 0x8000) ? flag##BITS : 0)); \
+        memcpy(out.tuples, frac->tuples, sizeof(out.tuples));                                        \
+        return out;                                                                                  \
+    }                                                                                                \
+                                                                                                     \
+    void cr##BITS##_init(Wide##BITS* cr) {                                                           \
+        cr->whole = 0;                                                                               \
+        memset(cr->tuples, 0, sizeof(cr->tuples));                                                   \
+    }                                                                                                \
+                                                                                                     \
+    Wide##BITS cr##BITS##_from_int(int64_t value, CRError* error) {                                  \
+        CompactRational zero;                                                                        \
+        cr_init(&zero);                                                                              \
+        cr_report_success(error);                                                                    \
+        return join##BITS(value, &zero, CR_OP_FROM_INT, error);                                      \
+    }                                                                                                \
+                                                                                                     \
+    Wide##BITS cr##BITS##_from_fraction(int64_t num, int64_t denom, CRError* error) {                \
+        CompactRational frac;                                                                        \
+        cr_init(&frac);                                                                              \
+        if (denom == 0) {                                                                            \
+            cr_report(error, CR_ERROR_DIVISION_BY_ZERO, CR_OP_FROM_FRACTION, cr_saturate_i32(num), 0); \
+            return join##BITS(0, &frac, CR_OP_FROM_FRACTION, error);                                 \
+        }                                                                                            \
+                                                                                                     \
+        /* Floor division in 128 bits, so INT64_MIN / -1 is harmless */                              \
+        __int128 n = num, d = denom;                                                                 \
+        if (d < 0) {                                                                                 \
+            n = -n;                                                                                  \
+            d = -d;                                                                                  \
+        }                                                                                            \
+        __int128 whole = n / d, rem = n % d;                                                         \
+        if (rem < 0) {                                                                               \
+            rem += d;                                                                                \
+            whole -= 1;                                                                              \
+        }                                                                                            \
+        if (rem != 0) {                                                                              \
+            frac = cr_encode_wide(rem, d, CR_OP_FROM_FRACTION, error);                               \
+        } else {                                                                                     \
+            cr_report_success(error);                                                                \
+        }                                                                                            \
+        return join##BITS(whole, &frac, CR_OP_FROM_FRACTION, error);                                 \
+    }                                                                                                \
+                                                                                                     \
+    Wide##BITS cr##BITS##_from_cr(const CompactRational* cr) {                                       \
+        CompactRational frac = *cr;                                                                  \
+        frac.whole &= (int16_t)0x8000;                                                               \
+        return join##BITS(cr_whole_value(cr->whole), &frac, CR_OP_NONE, NULL);                       \
+    }                                                                                                \
+                                                                                                     \
+    CompactRational cr##BITS##_to_cr(const Wide##BITS* cr, CRError* error) {                         \
+        CompactRational out;                                                                         \
+        int64_t whole = split##BITS(cr, &out);                                                       \
+        int32_t clamped = cr_clamp_whole(whole, CR_OP_NARROW, error);                                \
+        out.whole = (int16_t)((clamped & 0x7FFF) | (out.whole & 0x8000));                            \
+        return out;                                                                                  \
+    }                                                                                                \
+                                                                                                     \
+    double cr##BITS##_to_double(const Wide##BITS* cr, CRError* error) {                              \
+        CompactRational frac;                                                                        \
+        int64_t whole = split##BITS(cr, &frac);                                                      \
+        return (double)whole + cr_to_double(&frac, error);                                           \
+    }                                                                                                \
+                                                                                                     \
+    Wide##BITS cr##BITS##_add(const Wide##BITS* a, const Wide##BITS* b, CRError* error) {            \
+        CompactRational fa, fb;                                                                      \
+        int64_t wa = split##BITS(a, &fa), wb = split##BITS(b, &fb);                                  \
+        if (!((fa.whole | fb.whole) & 0x8000)) {                                                     \
+            cr_report_success(error);                                                                \
+            return join##BITS((__int128)wa + wb, &fa, CR_OP_ADD, error);                             \
+        }                                                                                            \
+        CompactRational frac = cr_add(&fa, &fb, error);                                              \
+        return join##BITS((__int128)wa + wb, &frac, CR_OP_ADD, error);                               \
+    }                                                                                                \
+                                                                                                     \
+    Wide##BITS cr##BITS##_sub(const Wide##BITS* a, const Wide##BITS* b, CRError* error) {            \
+        CompactRational fa, fb;                                                                      \
+        int64_t wa = split##BITS(a, &fa), wb = split##BITS(b, &fb);                                  \
+        CompactRational frac = cr_sub(&fa, &fb, error);                                              \
+        return join##BITS((__int128)wa - wb, &frac, CR_OP_SUB, error);                               \
+    }                                                                                                \
+                                                                                                     \
+    Wide##BITS cr##BITS##_neg(const Wide##BITS* a, CRError* error) {                                 \
+        CompactRational fa;                                                                          \
+        int64_t wa = split##BITS(a, &fa);                                                            \
+        CompactRational frac = cr_neg(&fa, error);                                                   \
+        return join##BITS(-(__int128)wa, &frac, CR_OP_NEG, error);                                   \
+    }                                                                                                \
+                                                                                                     \
+    /* Whole parts 10 apart decide alone; otherwise their (small) difference */                      \
+    /* goes into one side and cr_cmp settles it exactly */                                           \
+    int cr##BITS##_cmp(const Wide##BITS* a, const Wide##BITS* b) {                                   \
+        CompactRational fa, fb;                                                                      \
+        int64_t wa = split##BITS(a, &fa), wb = split##BITS(b, &fb);                                  \
+        if (!((fa.whole | fb.whole) & 0x8000) || wa - wb >= 10 || wb - wa >= 10) {                   \
+            return (wa > wb) - (wa < wb);                                                            \
+        }                                                                                            \
+        fa.whole = (int16_t)((fa.whole & 0x8000) | ((wa - wb) & 0x7FFF));                            \
+        return cr_cmp(&fa, &fb);                                                                     \
+    }                                                                                                \
+                                                                                                     \
+    size_t cr##BITS##_format(char* buf, size_t cap, const Wide##BITS* cr, uint32_t flags) {          \
+        CompactRational frac;                                                                        \
+        int64_t whole = split##BITS(cr, &frac);                                                      \
+        return cr_format_value(buf, cap, whole, (UWHOLE_T)cr->whole, BITS, cr->tuples, flags);      \
+    }
+
+CR_DEFINE_WIDE_TYPE(32, int32_t, uint32_t)
+CR_DEFINE_WIDE_TYPE(64, int64_t, uint64_t)
+
+// ============================================================================
+// WIDE SUM
+// ============================================================================
+
+// Canonical sum of an accumulator, keeping its 64-bit whole part
+CompactRational64 cr_acc_finish64(const CRAccumulator* acc, CRError* error) {
+    CompactRational frac;
+    int needed;
+    int64_t whole = cr_wide_sum_split(acc, &frac, &needed);
+    if (needed > 0) {
+        cr_report(error, CR_ERROR_TUPLE_BOUNDS, CR_OP_SUM, needed, MAX_TUPLES);
+    } else {
+        cr_report_success(error);
+    }
+    return join64(whole, &frac, CR_OP_SUM, error);
+}
+
+// Sum a column, keeping the 64-bit whole part of the wide accumulator
+CompactRational64 cr64_sum_parallel(const CompactRational* values, size_t n, int threads, CRError* error) {
+    CRWideSum total;
+    cr_wide_sum_parallel(values, n, threads, &total);
+    return cr_acc_finish64(&total, error);
+}
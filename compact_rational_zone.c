@@ -0,0 +1,210 @@
+#include "compact_rational_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// BLOCK STATISTICS
+// ============================================================================
+
+// Statistics of one block, as the column file writer records them
+void cr_block_stats(CRFileBlock* block, const CompactRational* values, size_t n) {
+    memset(block, 0, sizeof(*block));
+    block->count = (uint32_t)n;
+    block->min = values[0];
+    block->max = values[0];
+    for (size_t i = 0; i < n; i++) {
+        const CompactRational* cr = &values[i];
+        if (!(cr->whole & 0x8000)) block->integer_count++;
+        if (cr_cmp(cr, &block->min) < 0) block->min = *cr;
+        if (cr_cmp(cr, &block->max) > 0) block->max = *cr;
+    }
+
+    CRWideSum sum;
+    int needed;
+    cr_wide_sum_init(&sum);
+    cr_wide_sum_add_array(&sum, values, n);
+    block->sum_whole = cr_wide_sum_split(&sum, &block->sum_fraction, &needed);
+    if (needed > 0) {
+        block->flags |= CR_FILE_BLOCK_SUM_INEXACT;
+    }
+}
+
+// ============================================================================
+// ZONE MAPS
+// ============================================================================
+
+// Summarize a packed array block by block, decoding each block once
+bool cr_zone_map_build(CRZoneMap* zm, const CRPackedArray* pa, uint32_t block_size, CRError* error) {
+    memset(zm, 0, sizeof(*zm));
+    zm->block_size = block_size > 0 ? block_size : CR_FILE_DEFAULT_BLOCK_SIZE;
+    size_t block_count = (pa->count + zm->block_size - 1) / zm->block_size;
+
+    if (block_count == 0) {
+        cr_report_success(error);
+        return true;
+    }
+
+    CRFileBlock* blocks = malloc(block_count * sizeof(CRFileBlock));
+    CompactRational* scratch = malloc((size_t)zm->block_size * sizeof(CompactRational));
+    if (blocks == NULL || scratch == NULL) {
+        free(blocks);
+        free(scratch);
+        cr_report(error, CR_ERROR_OUT_OF_MEMORY, CR_OP_ZONE_MAP,
+                  cr_saturate_i32((int64_t)((size_t)zm->block_size * sizeof(CompactRational))), 0);
+        return false;
+    }
+
+    size_t pos = 0;
+    for (size_t b = 0; b < block_count; b++) {
+        size_t start = b * zm->block_size;
+        size_t n = pa->count - start < zm->block_size ? pa->count - start : zm->block_size;
+        size_t block_start = pos;
+        for (size_t i = 0; i < n; i++) {
+            size_t used = cr_unpack(pa->data + pos, pa->size - pos, &scratch[i]);
+            if (used == 0) {
+                free(blocks);
+                free(scratch);
+                cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_ZONE_MAP, cr_saturate_i32((int64_t)(start + i)), 0);
+                return false;
+            }
+            pos += used;
+        }
+        cr_block_stats(&blocks[b], scratch, n);
+        blocks[b].offset = block_start;
+    }
+
+    free(scratch);
+    zm->blocks = blocks;
+    zm->block_count = block_count;
+    cr_report_success(error);
+    return true;
+}
+
+// Borrow a column file's block table
+void cr_zone_map_from_file(CRZoneMap* zm, const CRFile* f) {
+    zm->blocks = f->blocks;
+    zm->block_count = f->block_count;
+    zm->block_size = f->header->block_size;
+    zm->view = true;
+}
+
+// Release a built zone map
+void cr_zone_map_free(CRZoneMap* zm) {
+    if (!zm->view) {
+        free((void*)zm->blocks);
+    }
+    memset(zm, 0, sizeof(*zm));
+}
+
+// ============================================================================
+// RANGE FILTER
+// ============================================================================
+
+// Set bits first..first+n-1 of a bitmap
+static void set_bits(uint64_t* bitmap, size_t first, size_t n) {
+    size_t end = first + n;
+    while (first < end && first % 64 != 0) {
+        bitmap[first / 64] |= (uint64_t)1 << (first % 64);
+        first++;
+    }
+    for (; first + 64 <= end; first += 64) {
+        bitmap[first / 64] = ~(uint64_t)0;
+    }
+    for (; first < end; first++) {
+        bitmap[first / 64] |= (uint64_t)1 << (first % 64);
+    }
+}
+
+// Smallest integer >= the value, and largest integer <= it
+static int64_t integer_ceil(const CompactRational* cr) {
+    Rational r = cr_to_rational(cr);
+    int64_t q = r.numerator / r.denominator;
+    return q + (r.numerator % r.denominator > 0 ? 1 : 0);
+}
+
+static int64_t integer_floor(const CompactRational* cr) {
+    Rational r = cr_to_rational(cr);
+    int64_t q = r.numerator / r.denominator;
+    return q - (r.numerator % r.denominator < 0 ? 1 : 0);
+}
+
+/**
+ * Range test for an all-integer block: its stream is n little-endian whole
+ * words, compared against integer bounds without decoding
+ */
+static size_t filter_integers(const uint8_t* data, size_t n, int64_t lo, int64_t hi, uint64_t* bitmap, size_t first) {
+    size_t selected = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t v = cr_whole_value((int16_t)(data[2 * i] | data[2 * i + 1] << 8));
+        uint64_t in = (uint64_t)((v >= lo) & (v <= hi));
+        bitmap[(first + i) / 64] |= in << ((first + i) % 64);
+        selected += in;
+    }
+    return selected;
+}
+
+// Select the values in [lo, hi], decoding only blocks that straddle a bound
+size_t cr_filter_range(const CRPackedArray* pa, const CRZoneMap* zm, const CompactRational* lo,
+                       const CompactRational* hi, uint64_t* bitmap, CRError* error) {
+    memset(bitmap, 0, (pa->count + 63) / 64 * sizeof(uint64_t));
+    size_t covered = zm->block_count > 0
+        ? (zm->block_count - 1) * (size_t)zm->block_size + zm->blocks[zm->block_count - 1].count : 0;
+    if (covered != pa->count) {
+        cr_report(error, CR_ERROR_OUT_OF_BOUNDS, CR_OP_FILTER, cr_saturate_i32((int64_t)covered),
+                  cr_saturate_i32((int64_t)pa->count));
+        return 0;
+    }
+    if (lo != NULL && hi != NULL && cr_cmp(lo, hi) > 0) {
+        cr_report_success(error);
+        return 0;
+    }
+
+    // Integer bounds for whole-word comparisons: an integer v >= lo exactly when v >= ceil(lo)
+    int64_t lo_int = lo != NULL ? integer_ceil(lo) : INT64_MIN;
+    int64_t hi_int = hi != NULL ? integer_floor(hi) : INT64_MAX;
+    size_t selected = 0;
+
+    for (size_t b = 0; b < zm->block_count; b++) {
+        const CRFileBlock* block = &zm->blocks[b];
+        size_t first = b * (size_t)zm->block_size;
+        bool above_lo = lo == NULL || cr_cmp(&block->min, lo) >= 0;
+        bool below_hi = hi == NULL || cr_cmp(&block->max, hi) <= 0;
+        if ((lo != NULL && cr_cmp(&block->max, lo) < 0) || (hi != NULL && cr_cmp(&block->min, hi) > 0)) {
+            continue;  // Entirely outside
+        }
+        if (above_lo && below_hi) {
+            set_bits(bitmap, first, block->count);  // Entirely inside
+            selected += block->count;
+            continue;
+        }
+
+        size_t pos = (size_t)block->offset;
+        if (block->integer_count == block->count && pos + 2 * (size_t)block->count <= pa->size) {
+            selected += filter_integers(pa->data + pos, block->count, lo_int, hi_int, bitmap, first);
+            continue;
+        }
+        for (size_t i = 0; i < block->count; i++) {
+            CompactRational cr;
+            size_t used = pos < pa->size ? cr_unpack(pa->data + pos, pa->size - pos, &cr) : 0;
+            if (used == 0) {
+                cr_report(error, CR_ERROR_INVALID_ENCODING, CR_OP_FILTER, cr_saturate_i32((int64_t)(first + i)), 0);
+                return selected;
+            }
+            pos += used;
+            bool in;
+            if (cr16_is_integer(cr16_from_cr(&cr))) {
+                int64_t v = cr_whole_value(cr.whole);
+                in = v >= lo_int && v <= hi_int;
+            } else {
+                in = (lo == NULL || cr_cmp(&cr, lo) >= 0) && (hi == NULL || cr_cmp(&cr, hi) <= 0);
+            }
+            if (in) {
+                bitmap[(first + i) / 64] |= (uint64_t)1 << ((first + i) % 64);
+                selected++;
+            }
+        }
+    }
+
+    cr_report_success(error);
+    return selected;
+}
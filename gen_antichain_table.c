@@ -0,0 +1,80 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Build-time generator for antichain_table.h
+// Must agree with the constants in compact_rational.h.
+#define MIN_DENOMINATOR 128
+#define MAX_DENOMINATOR 255
+#define MAX_NUMERATOR 255
+
+// ============================================================================
+// TABLE GENERATION
+// ============================================================================
+
+/**
+ * For every reduced denominator 1..255, find the smallest antichain
+ * denominator it divides (the same search find_antichain_denominator used
+ * to run per call) and the factor that scales numerators onto it.
+ *
+ * The same tables answer the exact single-tuple question: a reduced n/d
+ * with 0 < n < d has the exact encoding (n * scale[d]) / antichain[d],
+ * and the generator checks that every such numerator fits in a byte.
+ * Denominators above 255 have no single-tuple encoding.
+ */
+int main() {
+    unsigned antichain[MAX_DENOMINATOR + 1] = {0};
+    unsigned scale[MAX_DENOMINATOR + 1] = {0};
+
+    for (int denom = 1; denom <= MAX_DENOMINATOR; denom++) {
+        for (int d = MIN_DENOMINATOR; d <= MAX_DENOMINATOR; d++) {
+            if (d % denom == 0) {
+                antichain[denom] = (unsigned)d;
+                scale[denom] = (unsigned)(d / denom);
+                break;
+            }
+        }
+        if (antichain[denom] == 0 || (denom - 1) * scale[denom] > MAX_NUMERATOR) {
+            fprintf(stderr, "gen_antichain_table: denominator %d has no exact single-tuple encoding\n", denom);
+            return 1;
+        }
+    }
+
+    printf("#ifndef ANTICHAIN_TABLE_H\n");
+    printf("#define ANTICHAIN_TABLE_H\n\n");
+    printf("// Generated by gen_antichain_table.c - do not edit.\n\n");
+    printf("#include <stdint.h>\n\n");
+
+    printf("// Smallest antichain denominator divisible by d, for reduced d in 1..255 (0 = unused)\n");
+    printf("static const uint8_t cr_antichain_denominator_table[%d] = {\n", MAX_DENOMINATOR + 1);
+    for (int i = 0; i <= MAX_DENOMINATOR; i++) {
+        printf("%s%3u,%s", i % 16 == 0 ? "    " : " ", antichain[i], i % 16 == 15 ? "\n" : "");
+    }
+    printf("};\n\n");
+
+    printf("// Numerator scale factor: cr_antichain_denominator_table[d] / d (0 = unused)\n");
+    printf("static const uint8_t cr_antichain_scale_table[%d] = {\n", MAX_DENOMINATOR + 1);
+    for (int i = 0; i <= MAX_DENOMINATOR; i++) {
+        printf("%s%3u,%s", i % 16 == 0 ? "    " : " ", scale[i], i % 16 == 15 ? "\n" : "");
+    }
+    printf("};\n\n");
+
+    // Inverses of the antichain denominators modulo the Mersenne prime
+    // 2^61 - 1, by Fermat: d^(p - 2)
+    const uint64_t p = ((uint64_t)1 << 61) - 1;
+    printf("// (128 + offset)^-1 modulo 2^61 - 1, for cr_hash\n");
+    printf("static const uint64_t cr_hash_inverse_table[%d] = {\n", MAX_DENOMINATOR - MIN_DENOMINATOR + 1);
+    for (int d = MIN_DENOMINATOR; d <= MAX_DENOMINATOR; d++) {
+        uint64_t result = 1, base = (uint64_t)d;
+        for (uint64_t e = p - 2; e > 0; e >>= 1) {
+            if (e & 1) result = (uint64_t)((unsigned __int128)result * base % p);
+            base = (uint64_t)((unsigned __int128)base * base % p);
+        }
+        int i = d - MIN_DENOMINATOR;
+        printf("%s0x%016llxull,%s", i % 4 == 0 ? "    " : " ", (unsigned long long)result, i % 4 == 3 ? "\n" : "");
+    }
+    printf("};\n\n");
+
+    printf("#endif // ANTICHAIN_TABLE_H\n");
+    return 0;
+}
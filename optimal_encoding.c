@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#include "antichain_table.h"
 
 #define MAX_TUPLES 5
 #define MIN_DENOMINATOR 128
@@ -80,69 +81,93 @@ typedef struct {
 
 /**
  * Try to represent fraction (num/denom) using a single antichain denominator
+ *
+ * num * d is divisible by denom exactly when the reduced denominator divides
+ * d, so the smallest such d comes straight from the generated table and no
+ * scan over 128..255 is needed.
  */
 bool try_single_denominator(int64_t num, int64_t denom, Tuple* result) {
-    // Try each antichain denominator
-    for (int d = MIN_DENOMINATOR; d <= MAX_DENOMINATOR; d++) {
-        // Check if we can represent exactly: num/denom = n/d
-        // This requires: num * d = n * denom, and n <= 255
-
-        if ((num * d) % denom == 0) {
-            int64_t n = (num * d) / denom;
-            if (n > 0 && n <= MAX_NUMERATOR) {
-                result->numerator = (uint8_t)n;
-                result->denominator = (uint8_t)d;
-                return true;
-            }
-        }
+    int64_t g = gcd(num, denom);
+    if (g == 0) return false;
+    num /= g;
+    denom /= g;
+    if (denom < 0) {
+        num = -num;
+        denom = -denom;
+    }
+
+    if (denom > MAX_DENOMINATOR) {
+        return false;
+    }
+
+    int64_t n = num * cr_antichain_scale_table[denom];
+    if (n > 0 && n <= MAX_NUMERATOR) {
+        result->numerator = (uint8_t)n;
+        result->denominator = cr_antichain_denominator_table[denom];
+        return true;
     }
     return false;
 }
 
+// Modular inverse of a mod m (gcd(a, m) = 1)
+int64_t inverse_mod(int64_t a, int64_t m) {
+    int64_t t = 0, new_t = 1;
+    int64_t r = m, new_r = a % m;
+    while (new_r != 0) {
+        int64_t q = r / new_r;
+        int64_t tmp = t - q * new_t;
+        t = new_t;
+        new_t = tmp;
+        tmp = r - q * new_r;
+        r = new_r;
+        new_r = tmp;
+    }
+    return t < 0 ? t + m : t;
+}
+
 /**
  * Find optimal two-denominator representation
  * Solve: num/denom = n1/d1 + n2/d2
+ *
+ * A pair can only work if denom divides lcm(d1, d2), so d2 runs over the
+ * multiples of denom / gcd(denom, d1). With L = lcm(d1, d2) the equation is
+ * n1 * (L/d1) + n2 * (L/d2) = num * L / denom, and since L/d1 and L/d2 are
+ * coprime, n1 is fixed modulo L/d2: no numerator scan or gcd per candidate.
  */
 bool try_two_denominators(int64_t num, int64_t denom, Tuple result[2]) {
-    // Try all pairs of antichain denominators
     for (int d1 = MIN_DENOMINATOR; d1 <= MAX_DENOMINATOR; d1++) {
-        for (int d2 = d1; d2 <= MAX_DENOMINATOR; d2++) {
-            // Solve for n1, n2:
-            // num/denom = n1/d1 + n2/d2
-            // num * d1 * d2 = n1 * denom * d2 + n2 * denom * d1
+        int64_t step = denom / gcd(denom, d1);
+        if (step > MAX_DENOMINATOR) continue;
 
-            // Use greedy: maximize n1, then solve for n2
-            int64_t max_n1 = (num * d1) / denom;
-            if (max_n1 > MAX_NUMERATOR) max_n1 = MAX_NUMERATOR;
+        int64_t first = (d1 + step - 1) / step * step;
+        for (int64_t d2 = first; d2 <= MAX_DENOMINATOR; d2 += step) {
+            int64_t l = d1 / gcd(d1, d2) * d2;
+            if (l % denom != 0) continue;
+
+            int64_t a = l / d1;
+            int64_t b = l / d2;
+            int64_t c = num * (l / denom);
 
-            for (int64_t n1 = max_n1; n1 >= 0; n1--) {
-                // Remaining: num/denom - n1/d1 = (num*d1 - n1*denom) / (denom*d1)
-                int64_t rem_num = num * d1 - n1 * denom;
-                int64_t rem_denom = denom * d1;
-
-                // Reduce
-                int64_t g = gcd(rem_num, rem_denom);
-                rem_num /= g;
-                rem_denom /= g;
-
-                if (rem_num == 0) {
-                    // Exact single-denominator solution
-                    result[0].numerator = (uint8_t)n1;
-                    result[0].denominator = (uint8_t)d1;
-                    return true;
-                }
-
-                // Try to represent remainder with d2
-                if ((rem_num * d2) % rem_denom == 0) {
-                    int64_t n2 = (rem_num * d2) / rem_denom;
-                    if (n2 > 0 && n2 <= MAX_NUMERATOR) {
-                        result[0].numerator = (uint8_t)n1;
-                        result[0].denominator = (uint8_t)d1;
-                        result[1].numerator = (uint8_t)n2;
-                        result[1].denominator = (uint8_t)d2;
-                        return true;
-                    }
-                }
+            // Largest n1 in the residue class, as the greedy search preferred
+            int64_t n1_min = (c % b) * inverse_mod(a % b, b) % b;
+            int64_t max_n1 = c / a;
+            if (max_n1 > MAX_NUMERATOR) max_n1 = MAX_NUMERATOR;
+            if (max_n1 < n1_min) continue;
+            int64_t n1 = n1_min + (max_n1 - n1_min) / b * b;
+            int64_t n2 = (c - a * n1) / b;
+
+            if (n2 == 0) {
+                // Exact single-denominator solution
+                result[0].numerator = (uint8_t)n1;
+                result[0].denominator = (uint8_t)d1;
+                return true;
+            }
+            if (n2 > 0 && n2 <= MAX_NUMERATOR) {
+                result[0].numerator = (uint8_t)n1;
+                result[0].denominator = (uint8_t)d1;
+                result[1].numerator = (uint8_t)n2;
+                result[1].denominator = (uint8_t)d2;
+                return true;
             }
         }
     }
@@ -0,0 +1,143 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// ACCUMULATOR TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool same_value(const CompactRational* a, const CompactRational* b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+static bool equals_fraction(const CompactRational* cr, int64_t num, int64_t denom) {
+    Rational r = cr_to_rational(cr);
+    return (__int128)r.numerator * denom == (__int128)num * r.denominator;
+}
+
+void test_accumulator() {
+    printf("=== Accumulator Tests ===\n\n");
+    CRError error;
+    CRAccumulator acc;
+
+    // Test 1: Exact where chained cr_add is not
+    printf("Test 1: Exactness\n");
+    cr_acc_init(&acc);
+    CompactRational chained;
+    cr_init(&chained);
+    for (int d = 2; d <= 6; d++) {
+        CompactRational term = cr_from_fraction(1, d, NULL);
+        cr_acc_add(&acc, &term);
+        chained = cr_add(&chained, &term, NULL);
+    }
+    CompactRational total = cr_acc_finish(&acc, &error);
+    check(error.code == CR_SUCCESS && equals_fraction(&total, 29, 20), "1/2 + 1/3 + 1/4 + 1/5 + 1/6 = 29/20");
+    check(same_value(&total, &chained), "as chained cr_add while that stays exact");
+
+    cr_acc_init(&acc);
+    for (int i = 0; i < 3; i++) {
+        CompactRational term = cr_encode_optimal(1, 251LL * 253, NULL);
+        cr_acc_add(&acc, &term);
+    }
+    CompactRational two_tuples = cr_encode_optimal(3, 251LL * 253, NULL);
+    total = cr_acc_finish(&acc, &error);
+    check(error.code == CR_SUCCESS && same_value(&total, &two_tuples), "three two-tuple values reduce to 3/63503");
+    CompactRational negative = cr_from_fraction(-7, 3, NULL);
+    cr_acc_add(&acc, &negative);
+    total = cr_acc_finish(&acc, NULL);
+    check(equals_fraction(&total, 3 * 3 - 7 * 63503, 3 * 63503), "adding continues after finish");
+    printf("\n");
+
+    // Test 2: Agrees with the column sum
+    printf("Test 2: Against cr_sum_parallel\n");
+    enum { N = 100000 };
+    CompactRational* values = malloc(N * sizeof(CompactRational));
+    uint32_t seed = 7;
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int32_t denom = i % 3 == 0 ? 1 : 2 + (int32_t)(seed >> 24) % 40;
+        values[i] = cr_from_fraction((int32_t)(seed >> 16) % 5000 - 2500, denom, NULL);
+    }
+    cr_acc_init(&acc);
+    for (int i = 0; i < N; i++) {
+        cr_acc_add(&acc, &values[i]);
+    }
+    CRAccumulator array_acc, left, right;
+    cr_acc_init(&array_acc);
+    cr_acc_add_array(&array_acc, values, N);
+    cr_acc_init(&left);
+    cr_acc_init(&right);
+    cr_acc_add_array(&left, values, N / 3);
+    cr_acc_add_array(&right, values + N / 3, N - N / 3);
+    cr_acc_merge(&left, &right);
+    CRError sum_error;
+    CompactRational expected = cr_sum_parallel(values, N, 1, &sum_error);
+    total = cr_acc_finish(&acc, &error);
+    check(same_value(&total, &expected) && error.code == sum_error.code, "per-value adds give the column sum");
+    check(memcmp(&acc, &array_acc, sizeof(acc)) == 0 && memcmp(&acc, &left, sizeof(acc)) == 0,
+          "cr_acc_add_array and cr_acc_merge give the same state");
+    CompactRational64 wide = cr_acc_finish64(&acc, &error);
+    CompactRational64 wide_expected = cr64_sum_parallel(values, N, 2, NULL);
+    check(cr64_cmp(&wide, &wide_expected) == 0, "cr_acc_finish64 matches cr64_sum_parallel");
+    free(values);
+    printf("\n");
+
+    // Test 3: Long folds and the whole-part range
+    printf("Test 3: Range\n");
+    cr_acc_init(&acc);
+    CompactRational tick = cr_from_fraction(1, 255, NULL);
+    for (int i = 0; i < 5000000; i++) {
+        cr_acc_add(&acc, &tick);
+    }
+    total = cr_acc_finish(&acc, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && (int)cr_to_double(&total, NULL) == MAX_WHOLE_VALUE,
+          "5e6 * 1/255 clamps in cr_acc_finish");
+    wide = cr_acc_finish64(&acc, &error);
+    CompactRational64 exact = cr64_from_fraction(5000000, 255, NULL);
+    check(error.code == CR_SUCCESS && cr64_cmp(&wide, &exact) == 0, "and is exact in cr_acc_finish64");
+    printf("\n");
+
+    // Test 4: More than MAX_TUPLES denominators
+    printf("Test 4: Tuple bounds\n");
+    cr_acc_init(&acc);
+    const int primes[] = {131, 137, 139, 149, 151, 157};
+    for (int i = 0; i < MAX_TUPLES + 1; i++) {
+        CompactRational term = cr_from_fraction(1, primes[i], NULL);
+        cr_acc_add(&acc, &term);
+    }
+    cr_acc_finish(&acc, &error);
+    check(error.code == CR_ERROR_TUPLE_BOUNDS && error.value1 > MAX_TUPLES, "approximated tail reported");
+    cr_acc_init(&acc);
+    CompactRational chain = cr_from_int(0, NULL);
+    for (int d = 128; d <= 133; d++) {
+        CompactRational term = cr_from_fraction(1, d, NULL);
+        cr_acc_add(&acc, &term);
+        chain = cr_add(&chain, &term, NULL);
+    }
+    total = cr_acc_finish(&acc, &error);
+    Rational sixth = cr_to_rational(&total);
+    check(error.code == CR_SUCCESS && sixth.numerator == 3152989591LL && sixth.denominator == 68565777280LL &&
+          cr_size(&total) == 2 + 2 * MAX_TUPLES && cr_equal(&total, &chain),
+          "1/128 + ... + 1/133: six offsets re-encoded exactly on five, as chained cr_add");
+    cr_acc_init(&acc);
+    total = cr_acc_finish(&acc, &error);
+    CompactRational zero;
+    cr_init(&zero);
+    check(error.code == CR_SUCCESS && same_value(&total, &zero), "empty accumulator is zero");
+    printf("\n");
+
+    printf("=== Accumulator Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_accumulator();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include "compact_rational.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// APPROXIMATION TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool same_value(const CompactRational* a, const CompactRational* b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+static bool equals_fraction(const CompactRational* cr, int64_t num, int64_t denom) {
+    Rational r = cr_to_rational(cr);
+    return (__int128)r.numerator * denom == (__int128)num * r.denominator;
+}
+
+static int64_t gcd_test(int64_t a, int64_t b) {
+    while (b != 0) {
+        int64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * Reference search: every set of up to left denominators below last,
+ * rounding p/q to the lcm; keeps the smallest error as best_dist/best_lcm
+ * (in units of 1/q)
+ */
+static void brute_force(int64_t p, int64_t q, int64_t lcm, int last, int left, int64_t* best_dist, int64_t* best_lcm) {
+    int64_t r = (int64_t)((__int128)p * lcm % q);
+    int64_t dist = r < q - r ? r : q - r;
+    if ((__int128)dist * *best_lcm < (__int128)*best_dist * lcm) {
+        *best_dist = dist;
+        *best_lcm = lcm;
+    }
+    if (left == 0) return;
+    for (int d = last - 1; d >= MIN_DENOMINATOR; d--) {
+        brute_force(p, q, lcm / gcd_test(lcm, d) * d, d, left - 1, best_dist, best_lcm);
+    }
+}
+
+void test_approx() {
+    printf("=== Approximation Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Targets with an exact encoding
+    printf("Test 1: Exact targets\n");
+    CompactRational third = cr_approximate_rational((Rational){7, 3}, 1, 1, &error);
+    check(error.code == CR_SUCCESS && equals_fraction(&third, 7, 3) && cr_size(&third) == 4, "7/3 in one tuple");
+    CompactRational split = cr_approximate_rational((Rational){1, 17947}, 2, 1, &error);
+    CompactRational optimal = cr_encode_optimal(1, 17947, NULL);
+    check(error.code == CR_SUCCESS && same_value(&split, &optimal), "1/17947 in two tuples, as cr_encode_optimal");
+    CompactRational half = cr_approximate(-2.5, 1, 1, &error);
+    check(error.code == CR_SUCCESS && equals_fraction(&half, -5, 2), "-2.5 from a double");
+    CompactRational one_tuple = cr_approximate_rational((Rational){1, 17947}, 1, 1, &error);
+    check(error.code == CR_ERROR_INEXACT && error.value1 <= 1 && error.value2 == 1 && cr_size(&one_tuple) <= 4,
+          "1/17947 in one tuple is reported inexact");
+    printf("\n");
+
+    // Test 2: The search finds the true optimum
+    printf("Test 2: Against exhaustive search\n");
+    bool all_optimal = true;
+    uint64_t seed = 12345;
+    for (int t = 0; t < 24 && all_optimal; t++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        int64_t q = (int64_t)(seed >> 34) + 1000;
+        int64_t p = (int64_t)((seed >> 3) % (uint64_t)q);
+        int budget = 1 + t % 3;
+        int64_t best_dist = q, best_lcm = 1;
+        int64_t g = gcd_test(p, q);
+        brute_force(p / g, q / g, 1, MAX_DENOMINATOR + 1, budget, &best_dist, &best_lcm);
+
+        CompactRational got = cr_approximate_rational((Rational){p - 5 * q, q}, budget, t % 4, NULL);
+        Rational r = cr_to_rational(&got);
+        __int128 e = (__int128)(p - 5 * q) * r.denominator - (__int128)r.numerator * q;
+        if (e < 0) e = -e;
+        if (e * best_lcm != (__int128)best_dist * g * r.denominator) all_optimal = false;
+    }
+    check(all_optimal, "24 random fractions match the exhaustive optimum for 1 to 3 tuples");
+    printf("\n");
+
+    // Test 3: Constants
+    printf("Test 3: Constants\n");
+    const double e = 2.718281828459045235360287471352662497757;
+    CompactRational e1 = cr_approximate(e, 1, 1, NULL), e2 = cr_approximate(e, 2, 1, NULL);
+    check(equals_fraction(&e1, 685, 252), "e in one tuple is 685/252");
+    check(equals_fraction(&e2, 25946, 9545), "e in two tuples is the convergent 25946/9545");
+    bool improving = true;
+    const Rational e_double = {INT64_C(6121026514868073), INT64_C(1) << 51};  // The double, exactly
+    CompactRational previous = e1;
+    for (int n = 2; n <= MAX_TUPLES; n++) {
+        CompactRational next = cr_approximate(e, n, 0, NULL);
+        if (cr_cmp_distance(&next, &previous, e_double) >= 0) improving = false;
+        previous = next;
+    }
+    check(improving, "each extra tuple lowers the error");
+    CompactRational tenth = cr_approximate(0.1, 1, 1, &error);
+    check(error.code == CR_ERROR_INEXACT && equals_fraction(&tenth, 1, 10), "the double 0.1 rounds to 1/10");
+    CompactRational pi = cr_approximate(-3.14159265358979323846, 1, 1, NULL);
+    check(equals_fraction(&pi, -355, 113), "-pi in one tuple is -355/113");
+    printf("\n");
+
+    // Test 4: The thread count does not change the result
+    printf("Test 4: Threads\n");
+    bool stable = true;
+    const double targets[] = {e, -1.0 / 7.0 + 1e-9, 12.3456789, 0.5772156649015329};
+    for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+        for (int n = 3; n <= MAX_TUPLES; n++) {
+            CompactRational serial = cr_approximate(targets[i], n, 1, NULL);
+            for (int threads = 2; threads <= 8; threads *= 2) {
+                CompactRational parallel = cr_approximate(targets[i], n, threads, NULL);
+                if (!same_value(&serial, &parallel)) stable = false;
+            }
+        }
+    }
+    check(stable, "1, 2, 4 and 8 threads agree for 3 to 5 tuples");
+    CompactRational wide = cr_approximate_rational((Rational){1000000007, 998244353}, 5, 4, NULL);
+    CompactRational narrow = cr_approximate_rational((Rational){1000000007, 998244353}, 4, 4, NULL);
+    check(cr_cmp_distance(&wide, &narrow, (Rational){1000000007, 998244353}) < 0, "five tuples beat four");
+    printf("\n");
+
+    // Test 5: Edge cases
+    printf("Test 5: Edge cases\n");
+    CompactRational integer = cr_approximate(2.5, 0, 1, &error);
+    check(error.code == CR_ERROR_INEXACT && equals_fraction(&integer, 2, 1), "no tuples: nearest integer, ties down");
+    CompactRational capped = cr_approximate(e, 9, 1, NULL), full = cr_approximate(e, MAX_TUPLES, 1, NULL);
+    check(same_value(&capped, &full), "budgets above MAX_TUPLES use MAX_TUPLES");
+    cr_approximate(1e9, 2, 1, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED, "out-of-range whole part is clamped");
+    CompactRational nan = cr_approximate(NAN, 2, 1, &error);
+    check(error.code == CR_ERROR_INEXACT && cr_to_double(&nan, NULL) == 0.0, "NaN gives zero");
+    cr_approximate_rational((Rational){1, 0}, 2, 1, &error);
+    check(error.code == CR_ERROR_DIVISION_BY_ZERO, "zero denominator reported");
+    CompactRational tiny = cr_approximate(-1e-30, 3, 1, &error);
+    check(cr_to_double(&tiny, NULL) == 0.0, "-1e-30 rounds to zero");
+    printf("\n");
+
+    // Test 6: Exact error evaluation
+    printf("Test 6: Exact errors\n");
+    const Rational e_exact = {INT64_C(5739439214861417731), INT64_C(2111421691000680031)};
+    CompactRational best5 = cr_approximate_rational(e_exact, 5, 0, NULL);
+    CompactRational best4 = cr_approximate_rational(e_exact, 4, 0, NULL);
+    long double r5 = cr_residual(&best5, e_exact, &error);
+    check(error.code == CR_SUCCESS && r5 != 0.0L && fabsl(r5) < 1e-18L,
+          "five-tuple error against e resolved below the double spacing");
+    check(cr_cmp_distance(&best5, &best4, e_exact) < 0 && cr_cmp_distance(&best4, &best5, e_exact) > 0 &&
+          cr_cmp_distance(&best5, &best5, e_exact) == 0, "exact distance ordering");
+    Rational r = cr_to_rational(&best5);
+    Rational nudged = {r.numerator * 1000003 + 1, r.denominator * 1000003};
+    long double expected_residual = -1.0L / ((long double)r.denominator * 1000003);
+    check(fabsl(cr_residual(&best5, nudged, NULL) / expected_residual - 1.0L) < 1e-18L,
+          "a residual of 1/(denominator * 1000003) keeps long double precision");
+    CompactRational lo = cr_from_fraction(1, 3, NULL), hi = cr_from_fraction(2, 3, NULL);
+    check(cr_cmp_distance(&lo, &hi, (Rational){1, 2}) == 0 && cr_residual(&lo, (Rational){-1, -2}, NULL) < 0,
+          "equal distances either side; negative denominators");
+    CompactRational zero;
+    cr_init(&zero);
+    check(cr_residual(&zero, (Rational){1, INT64_MIN}, NULL) == 0x1p-63L, "INT64_MIN denominator");
+    cr_residual(&zero, (Rational){1, 0}, &error);
+    check(error.code == CR_ERROR_DIVISION_BY_ZERO, "zero target denominator reported");
+    printf("\n");
+
+    printf("=== Approximation Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_approx();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include "compact_rational.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// ARENA TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool same_value(const uint8_t* stored, const CompactRational* expected) {
+    CompactRational got = cr_arena_load(stored);
+    return memcmp(&got, expected, sizeof(got)) == 0;
+}
+
+// Each worker fills its own thread arena and checks it back
+typedef struct {
+    int seed;
+    bool ok;
+} ArenaWorker;
+
+static void* arena_worker(void* arg) {
+    ArenaWorker* w = (ArenaWorker*)arg;
+    CRArena* arena = cr_arena_thread();
+    const uint8_t* stored[500];
+    w->ok = true;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 500; i++) {
+            stored[i] = cr_arena_encode_optimal(arena, w->seed * 1000 + i, 7 + i % 13, NULL);
+        }
+        for (int i = 0; i < 500; i++) {
+            CompactRational expected = cr_encode_optimal(w->seed * 1000 + i, 7 + i % 13, NULL);
+            if (stored[i] == NULL || !same_value(stored[i], &expected)) w->ok = false;
+        }
+        cr_arena_reset(arena);
+    }
+    return NULL;
+}
+
+void test_arena() {
+    printf("=== Arena Tests ===\n\n");
+    CRError error;
+    CRArena arena;
+
+    // Test 1: Values take their packed size
+    printf("Test 1: Store and load\n");
+    cr_arena_init(&arena, 0);
+    CompactRational integer = cr_from_int(-42, NULL), third = cr_from_fraction(7, 3, NULL);
+    CompactRational wide = cr_encode_optimal(1, 251LL * 253 * 254, NULL);
+    const uint8_t* p1 = cr_arena_store(&arena, &integer, &error);
+    const uint8_t* p2 = cr_arena_store(&arena, &third, NULL);
+    const uint8_t* p3 = cr_arena_store(&arena, &wide, NULL);
+    check(error.code == CR_SUCCESS && p1 != NULL && p2 == p1 + 2 && p3 == p2 + 4,
+          "integer takes 2 bytes, one tuple 4, stored back to back");
+    check(same_value(p1, &integer) && same_value(p2, &third) && same_value(p3, &wide), "values read back exactly");
+    check(arena.bytes == 2 + 4 + cr_size(&wide) && cr_arena_footprint(&arena) == CR_ARENA_DEFAULT_BLOCK_SIZE,
+          "one default block, bytes counted");
+    cr_arena_free(&arena);
+    check(arena.first == NULL && cr_arena_footprint(&arena) == 0, "free releases everything");
+    printf("\n");
+
+    // Test 2: Block chaining
+    printf("Test 2: Many small blocks\n");
+    enum { N = 5000 };
+    static const uint8_t* stored[N];
+    static CompactRational values[N];
+    cr_arena_init(&arena, 64);
+    for (int i = 0; i < N; i++) {
+        values[i] = cr_encode_optimal(i * 31 - 70000, 1 + i % 300, NULL);
+        stored[i] = cr_arena_store(&arena, &values[i], NULL);
+    }
+    bool all_ok = true;
+    size_t packed_bytes = 0;
+    for (int i = 0; i < N; i++) {
+        if (stored[i] == NULL || !same_value(stored[i], &values[i])) all_ok = false;
+        packed_bytes += cr_size(&values[i]);
+    }
+    check(all_ok, "5000 values across blocks read back exactly");
+    check(arena.bytes == packed_bytes && cr_arena_footprint(&arena) < packed_bytes + packed_bytes / 4,
+          "space is the packed size plus block tails");
+    printf("\n");
+
+    // Test 3: Reset keeps the blocks
+    printf("Test 3: Reset\n");
+    size_t footprint = cr_arena_footprint(&arena);
+    const uint8_t* first = stored[0];
+    cr_arena_reset(&arena);
+    check(arena.bytes == 0 && cr_arena_footprint(&arena) == footprint, "reset keeps memory, clears the count");
+    for (int i = 0; i < N; i++) {
+        stored[i] = cr_arena_store(&arena, &values[i], NULL);
+    }
+    check(stored[0] == first && cr_arena_footprint(&arena) == footprint, "same job reuses the same blocks");
+    void* big = cr_arena_alloc(&arena, 1000, &error);
+    check(big != NULL && error.code == CR_SUCCESS && cr_arena_footprint(&arena) == footprint + 1000,
+          "oversized request gets a block of its own");
+    CompactRational after = cr_from_fraction(1, 3, NULL);
+    const uint8_t* p = cr_arena_store(&arena, &after, NULL);
+    check(p != NULL && same_value(p, &after) && cr_arena_footprint(&arena) > footprint + 1000,
+          "allocation continues after it");
+    cr_arena_free(&arena);
+    printf("\n");
+
+    // Test 4: Operations write straight into the arena
+    printf("Test 4: Arena results\n");
+    cr_arena_init(&arena, 0);
+    CompactRational a = cr_from_fraction(22, 3, NULL), b = cr_from_fraction(1, 7, NULL);
+    CompactRational sum = cr_add(&a, &b, NULL);
+    check(same_value(cr_arena_add(&arena, &a, &b, &error), &sum) && error.code == CR_SUCCESS, "cr_arena_add");
+    CompactRational top = cr_from_int(MAX_WHOLE_VALUE, NULL);
+    cr_arena_add(&arena, &top, &top, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED, "the operation's clamp is reported");
+
+    CompactRational raw;
+    cr_init(&raw);
+    raw.whole = (int16_t)0x8001;
+    raw.tuples[0] = (200 << 8) | 0;
+    raw.tuples[1] = (100 << 8) | 0x80;  // 1 + 300/128, not canonical
+    CompactRational canonical = cr_canonicalize(&raw, NULL);
+    check(same_value(cr_arena_canonicalize(&arena, &raw, NULL), &canonical), "cr_arena_canonicalize");
+
+    const uint8_t* inexact = cr_arena_encode_optimal(&arena, 1, 1000003, &error);
+    CompactRational approx = cr_encode_optimal(1, 1000003, NULL);
+    check(inexact != NULL && same_value(inexact, &approx) && error.code == CR_ERROR_INEXACT,
+          "cr_arena_encode_optimal keeps CR_ERROR_INEXACT");
+    cr_arena_free(&arena);
+    printf("\n");
+
+    // Test 5: Per-thread arenas
+    printf("Test 5: Thread arenas\n");
+    enum { THREADS = 4 };
+    pthread_t ids[THREADS];
+    ArenaWorker workers[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        workers[t].seed = t + 1;
+        pthread_create(&ids[t], NULL, arena_worker, &workers[t]);
+    }
+    bool threads_ok = true;
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(ids[t], NULL);
+        threads_ok = threads_ok && workers[t].ok;
+    }
+    check(threads_ok, "4 threads fill and reset their own arenas");
+    CRArena* mine = cr_arena_thread();
+    check(mine == cr_arena_thread() && mine->block_size == CR_ARENA_DEFAULT_BLOCK_SIZE,
+          "cr_arena_thread is stable per thread");
+    cr_arena_free(mine);
+    printf("\n");
+
+    printf("=== Arena Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_arena();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================================
+// ARITHMETIC TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool equals_fraction(const CompactRational* cr, int64_t num, int64_t denom) {
+    Rational expected = {num, denom};
+    reduce_rational(&expected);
+    Rational got = cr_to_rational(cr);
+    return got.numerator == expected.numerator && got.denominator == expected.denominator;
+}
+
+// Sample operands: integers, halves, thirds, sevenths and a non-reduced tuple
+static CompactRational sample(int i) {
+    switch (i % 5) {
+        case 0: return cr_from_int(i * 7 - 300, NULL);
+        case 1: return cr_from_fraction(2 * i - 301, 2, NULL);
+        case 2: return cr_from_fraction(i - 150, 3, NULL);
+        case 3: return cr_from_fraction(5 * i + 1, 7, NULL);
+        default: {
+            CompactRational cr;
+            cr_init(&cr);
+            cr.whole = (int16_t)(0x8000 | ((i / 5 - 20) & 0x7FFF));
+            cr.tuples[0] = (uint16_t)((44 << 8) | 0x84);  // 44/132 = 1/3
+            return cr;
+        }
+    }
+}
+
+static void sample_fraction(int i, int64_t* num, int64_t* denom) {
+    CompactRational cr = sample(i);
+    Rational r = cr_to_rational(&cr);
+    *num = r.numerator;
+    *denom = r.denominator;
+}
+
+void test_addition() {
+    printf("=== Arithmetic Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Integer + integer
+    printf("Test 1: Integer + integer\n");
+    CompactRational a = cr_from_int(10, NULL);
+    CompactRational b = cr_from_int(-7, NULL);
+    CompactRational sum = cr_add(&a, &b, &error);
+    check(equals_fraction(&sum, 3, 1) && error.code == CR_SUCCESS, "10 + (-7) = 3");
+    check(cr_size(&sum) == 2, "result stays integer-only");
+    printf("\n");
+
+    // Test 2: Integer + tuple keeps the tuple
+    printf("Test 2: Integer + single tuple\n");
+    a = cr_from_int(5, NULL);
+    b = cr_from_fraction(22, 3, NULL);  // 7 1/3
+    sum = cr_add(&a, &b, &error);
+    check(equals_fraction(&sum, 37, 3) && error.code == CR_SUCCESS, "5 + 7 1/3 = 12 1/3");
+    check(sum.tuples[0] == b.tuples[0], "tuple passes through unchanged");
+    b = cr_from_fraction(-7, 2, NULL);  // -4 + 1/2
+    sum = cr_add(&b, &a, NULL);
+    check(equals_fraction(&sum, 3, 2), "-7/2 + 5 = 3/2");
+    printf("\n");
+
+    // Test 3: Shared denominator with carry
+    printf("Test 3: Shared denominator\n");
+    a = cr_from_fraction(3, 4, NULL);   // 96/128
+    b = cr_from_fraction(5, 8, NULL);   // 80/128
+    sum = cr_add(&a, &b, &error);
+    check(equals_fraction(&sum, 11, 8) && error.code == CR_SUCCESS, "3/4 + 5/8 = 1 3/8");
+    check(cr_size(&sum) == 4 && (sum.tuples[0] & 0x7F) == 0, "carry leaves one tuple on 128");
+    a = cr_from_fraction(1, 2, NULL);
+    sum = cr_add(&a, &a, NULL);
+    check(equals_fraction(&sum, 1, 1) && cr_size(&sum) == 2, "1/2 + 1/2 = 1 with no tuple");
+    printf("\n");
+
+    // Test 4: Fast paths agree with exact rational addition
+    printf("Test 4: Exhaustive pairs against rational arithmetic\n");
+    bool all_exact = true;
+    for (int i = 0; i < 60; i++) {
+        for (int j = 0; j < 60; j++) {
+            CompactRational x = sample(i);
+            CompactRational y = sample(j);
+            int64_t xn, xd, yn, yd;
+            sample_fraction(i, &xn, &xd);
+            sample_fraction(j, &yn, &yd);
+            CompactRational s = cr_add(&x, &y, NULL);
+            if (!equals_fraction(&s, xn * yd + yn * xd, xd * yd)) {
+                all_exact = false;
+            }
+        }
+    }
+    check(all_exact, "3600 sums are exact");
+    printf("\n");
+
+    // Test 5: Clamping is reported on the fast path
+    printf("Test 5: Clamping\n");
+    a = cr_from_int(16000, NULL);
+    b = cr_from_int(16000, NULL);
+    sum = cr_add(&a, &b, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && error.value1 == 32000, "16000 + 16000 reports clamping");
+    check(equals_fraction(&sum, MAX_WHOLE_VALUE, 1), "result clamps to MAX_WHOLE_VALUE");
+    a = cr_from_fraction(-32765, 2, NULL);
+    b = cr_from_int(-100, NULL);
+    sum = cr_add(&a, &b, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && error.value2 == MIN_WHOLE_VALUE,
+          "negative overflow clamps to MIN_WHOLE_VALUE");
+    printf("\n");
+
+    // Test 6: Subtraction, multiplication and division are exact
+    printf("Test 6: Other operations against rational arithmetic\n");
+    bool sub_exact = true, mul_exact = true, div_exact = true, neg_exact = true;
+    for (int i = 0; i < 60; i++) {
+        CompactRational x = sample(i);
+        int64_t xn, xd;
+        sample_fraction(i, &xn, &xd);
+        CompactRational n = cr_neg(&x, NULL);
+        if (!equals_fraction(&n, -xn, xd)) neg_exact = false;
+        for (int j = 0; j < 60; j++) {
+            CompactRational y = sample(j);
+            int64_t yn, yd;
+            sample_fraction(j, &yn, &yd);
+            CompactRational d = cr_sub(&x, &y, NULL);
+            if (!equals_fraction(&d, xn * yd - yn * xd, xd * yd)) sub_exact = false;
+            CompactRational p = cr_mul(&x, &y, &error);
+            if (error.code == CR_SUCCESS && !equals_fraction(&p, xn * yn, xd * yd)) mul_exact = false;
+            if (yn == 0) continue;
+            CompactRational q = cr_div(&x, &y, &error);
+            if (error.code == CR_SUCCESS && !equals_fraction(&q, xn * yd, xd * yn)) div_exact = false;
+        }
+    }
+    check(neg_exact, "60 negations are exact");
+    check(sub_exact, "3600 differences are exact");
+    check(mul_exact, "unclamped products are exact");
+    check(div_exact, "unclamped quotients are exact");
+    a = cr_from_fraction(1, 131, NULL);
+    b = cr_from_fraction(1, 137, NULL);
+    sum = cr_add(&a, &b, &error);
+    check(equals_fraction(&sum, 268, 131 * 137) && error.code == CR_SUCCESS, "1/131 + 1/137 is exact");
+    CompactRational prod = cr_mul(&a, &b, &error);
+    check(equals_fraction(&prod, 1, 131 * 137) && error.code == CR_SUCCESS, "1/131 * 1/137 is exact");
+    a = cr_from_int(3, NULL);
+    b = cr_from_int(0, NULL);
+    cr_div(&a, &b, &error);
+    check(error.code == CR_ERROR_DIVISION_BY_ZERO, "division by zero is reported");
+    printf("\n");
+
+    // Test 7: No zero results on large intermediates
+    printf("Test 7: Large intermediates\n");
+    a = cr_encode_optimal(16000LL * 131 * 137 * 139 + 1, 131 * 137 * 139, NULL);
+    b = cr_encode_optimal(-15000LL * 149 * 151 + 7, 149 * 151, NULL);
+    sum = cr_add(&a, &b, &error);
+    printf("  %.9f\n", cr_to_double(&sum, NULL));
+    check(fabs(cr_to_double(&sum, NULL) - (cr_to_double(&a, NULL) + cr_to_double(&b, NULL))) < 1e-9,
+          "sum with five distinct denominators is not zero");
+    a = cr_from_int(16000, NULL);
+    prod = cr_mul(&a, &a, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && equals_fraction(&prod, MAX_WHOLE_VALUE, 1), "product clamps");
+    a = cr_encode_optimal(MAX_WHOLE_VALUE * 2 + 1, 2, NULL);
+    cr_neg(&a, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED, "-(16383 1/2) clamps the whole part");
+    printf("\n");
+
+    // Test 8: Comparison
+    printf("Test 8: Exact comparison\n");
+    bool ordered = true;
+    for (int i = 0; i < 60; i++) {
+        for (int j = 0; j < 60; j++) {
+            int64_t xn, xd, yn, yd;
+            sample_fraction(i, &xn, &xd);
+            sample_fraction(j, &yn, &yd);
+            int expected = (xn * yd > yn * xd) - (xn * yd < yn * xd);
+            CompactRational x = sample(i), y = sample(j);
+            if (cr_cmp(&x, &y) != expected) ordered = false;
+        }
+    }
+    check(ordered, "3600 comparisons match cross-multiplication");
+    a = cr_from_fraction(1, 3, NULL);  // 43/129
+    CompactRational raw = sample(4);
+    raw.whole = (int16_t)0x8000;       // 0 + 44/132
+    check(cr_cmp(&a, &raw) == 0 && memcmp(&a, &raw, sizeof(a)) != 0, "different encodings of 1/3 are equal");
+    a = cr_encode_optimal(1, 131 * 137, NULL);
+    b = cr_encode_optimal(1, 131 * 137 + 1, NULL);
+    check(cr_cmp(&a, &b) == 1 && cr_cmp(&b, &a) == -1, "1/17947 > 1/17948");
+    a = cr_from_int(-9, NULL);
+    raw.whole = (int16_t)(0x8000 | (-10 & 0x7FFF));
+    raw.tuples[0] = (uint16_t)((255 << 8) | 0x00);  // 255/128, no end flag yet
+    raw.tuples[1] = (uint16_t)((1 << 8) | 0x80);    // + 1/128
+    check(cr_cmp(&a, &raw) == -1, "non-canonical -10 + 2 is above -9");
+    printf("\n");
+
+    printf("=== Arithmetic Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_addition();
+    return failures == 0 ? 0 : 1;
+}
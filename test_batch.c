@@ -0,0 +1,122 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================================
+// BATCH OPERATION TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+// Within a few ulps of the exactly rounded cr_to_double() result
+static bool close_to(double got, double expected) {
+    return fabs(got - expected) <= 4 * 2.220446049250313e-16 * fmax(1.0, fabs(expected));
+}
+
+void test_batch() {
+    printf("=== Batch Operation Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Integer-only column takes the fast lane
+    printf("Test 1: Integer-only column\n");
+    enum { N = 1003 };  // Not a multiple of the block width
+    static CompactRational ints[N];
+    static double out[N];
+    for (int i = 0; i < N; i++) {
+        ints[i] = cr_from_int(i * 31 % 32000 - 16000, NULL);
+    }
+    size_t bad = cr_to_double_batch(ints, N, out, &error);
+    bool exact = true;
+    for (int i = 0; i < N; i++) {
+        if (out[i] != cr_to_double(&ints[i], NULL)) exact = false;
+    }
+    check(bad == 0 && error.code == CR_SUCCESS, "no errors reported");
+    check(exact, "integers decode exactly");
+    printf("\n");
+
+    // Test 2: Mixed column with one, two and three tuples
+    printf("Test 2: Mixed column\n");
+    static CompactRational mixed[N];
+    for (int i = 0; i < N; i++) {
+        switch (i % 4) {
+            case 0: mixed[i] = cr_from_int(i - 500, NULL); break;
+            case 1: mixed[i] = cr_from_fraction(2 * i - 1001, 2, NULL); break;
+            case 2: mixed[i] = cr_from_fraction(i, 7, NULL); break;
+            default:
+                cr_init(&mixed[i]);
+                mixed[i].whole = (int16_t)(0x8000 | ((-(i % 50)) & 0x7FFF));
+                mixed[i].tuples[0] = (uint16_t)((55 << 8) | 38);          // 55/166
+                mixed[i].tuples[1] = (uint16_t)(((i % 200) << 8) | 60);   // n/188
+                mixed[i].tuples[2] = (uint16_t)((89 << 8) | 0xE6);        // 89/230, end
+                break;
+        }
+    }
+    bad = cr_to_double_batch(mixed, N, out, &error);
+    bool close = true;
+    for (int i = 0; i < N; i++) {
+        if (!close_to(out[i], cr_to_double(&mixed[i], NULL))) close = false;
+    }
+    check(bad == 0 && error.code == CR_SUCCESS, "no errors reported");
+    check(close, "every value matches cr_to_double within 4 ulps");
+    printf("\n");
+
+    // Test 3: Malformed values are counted once per batch
+    printf("Test 3: Aggregated error count\n");
+    CompactRational broken;
+    cr_init(&broken);
+    broken.whole = (int16_t)0x8003;
+    for (int t = 0; t < MAX_TUPLES; t++) {
+        broken.tuples[t] = (uint16_t)(1 << 8);  // 1/128, never terminated
+    }
+    mixed[5] = broken;
+    mixed[N - 1] = broken;
+    bad = cr_to_double_batch(mixed, N, out, &error);
+    check(bad == 2, "two malformed values counted");
+    check(error.code == CR_ERROR_TUPLE_BOUNDS && error.value2 == 5, "error points at the first one");
+    check(close_to(out[5], cr_to_double(&broken, NULL)), "malformed value still decoded");
+    printf("\n");
+
+    // Test 4: Empty batch
+    printf("Test 4: Empty batch\n");
+    check(cr_to_double_batch(mixed, 0, out, &error) == 0 && error.code == CR_SUCCESS, "n = 0 succeeds");
+    printf("\n");
+
+    // Test 5: Batch canonicalization in place
+    printf("Test 5: Batch canonicalization\n");
+    enum { M = 21 };
+    CompactRational column[M], expected[M];
+    for (int i = 0; i < M; i++) {
+        if (i % 3 == 0) {
+            column[i] = cr_from_int(i - 10, NULL);
+        } else {
+            cr_init(&column[i]);
+            column[i].whole = (int16_t)(0x8000 | ((i - 10) & 0x7FFF));
+            column[i].tuples[0] = (uint16_t)((200 << 8) | 3);       // 200/131
+            column[i].tuples[1] = (uint16_t)((i << 8) | 0x80 | 3);  // i/131
+        }
+        expected[i] = cr_canonicalize(&column[i], NULL);
+    }
+    column[M - 1].whole = (int16_t)(0x8000 | MAX_WHOLE_VALUE);
+    expected[M - 1] = cr_canonicalize(&column[M - 1], NULL);
+    size_t clamped = cr_canonicalize_array(column, M, column, &error);
+    check(memcmp(column, expected, sizeof(column)) == 0, "in-place result matches cr_canonicalize");
+    check(clamped == 1 && error.code == CR_ERROR_VALUE_CLAMPED && error.value1 == MAX_WHOLE_VALUE + 1,
+          "carry past MAX_WHOLE_VALUE counted and reported once");
+    Rational r = cr_to_rational(&column[1]);
+    check(column[1].tuples[0] == (uint16_t)((70 << 8) | 0x80 | 3) && r.numerator == -978 && r.denominator == 131,
+          "-9 + 201/131 becomes -8 + 70/131");
+    printf("\n");
+
+    printf("=== Batch Operation Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_batch();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+// ============================================================================
+// ENCODING CACHE TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+// Repeating workload: DISTINCT fractions cycled through many times
+enum { DISTINCT = 3000, THREADS = 4, LOOKUPS = 100000 };
+
+static int64_t key_num(int i) {
+    return (int64_t)(i % 97) * 7 + 1;
+}
+
+static int64_t key_denom(int i) {
+    return 2 + i;  // Up to 3001: many need several tuples
+}
+
+static CompactRational expected[DISTINCT];
+static CRCache shared;
+
+typedef struct {
+    int seed;
+    bool all_match;
+} Worker;
+
+static void* worker(void* arg) {
+    Worker* w = (Worker*)arg;
+    w->all_match = true;
+    for (int k = 0; k < LOOKUPS; k++) {
+        int i = (int)(((uint32_t)k * 2654435761u + (uint32_t)w->seed) % DISTINCT);
+        CompactRational got = cr_cache_encode_optimal(&shared, key_num(i), key_denom(i), NULL);
+        if (memcmp(&got, &expected[i], sizeof(got)) != 0) w->all_match = false;
+    }
+    return NULL;
+}
+
+void test_cache() {
+    printf("=== Encoding Cache Tests ===\n\n");
+    CRError error;
+    uint64_t hits, misses;
+
+    // Test 1: Hits and misses
+    printf("Test 1: Hit/miss counting\n");
+    CRCache cache;
+    check(cr_cache_init(&cache, 1024, &error) && error.code == CR_SUCCESS, "init succeeds");
+    check(sizeof(CRCacheCounters) == 64 && (uintptr_t)&cache.counters[0] % 64 == 0 &&
+          (uintptr_t)&shared.counters[1] % 64 == 0, "counter stripes sit on their own cache lines");
+    CompactRational a = cr_cache_from_fraction(&cache, 7, 12, &error);
+    CompactRational b = cr_cache_from_fraction(&cache, 14, 24, &error);  // Same reduced key
+    CompactRational direct = cr_from_fraction(7, 12, NULL);
+    check(memcmp(&a, &direct, sizeof(a)) == 0 && memcmp(&b, &direct, sizeof(b)) == 0,
+          "cached value equals cr_from_fraction");
+    cr_cache_stats(&cache, &hits, &misses);
+    check(hits == 1 && misses == 1, "7/12 then 14/24: one miss, one hit");
+
+    CompactRational opt = cr_cache_encode_optimal(&cache, 7, 12, NULL);
+    cr_cache_stats(&cache, &hits, &misses);
+    check(misses == 2 && memcmp(&opt, &direct, sizeof(opt)) == 0, "encoders are cached separately");
+    printf("\n");
+
+    // Test 2: Errors pass through and are not cached
+    printf("Test 2: Error results\n");
+    cr_cache_from_fraction(&cache, 40000, 1, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED, "clamping is reported");
+    cr_cache_from_fraction(&cache, 40000, 1, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED, "and reported again on repeat");
+    cr_cache_from_fraction(&cache, 1, 0, &error);
+    check(error.code == CR_ERROR_DIVISION_BY_ZERO, "division by zero is reported");
+    cr_cache_free(&cache);
+    printf("\n");
+
+    // Test 3: A small cache stays bounded and correct
+    printf("Test 3: Bounded capacity\n");
+    check(cr_cache_init(&cache, 16, NULL), "16-slot cache");
+    bool correct = true;
+    for (int rep = 0; rep < 3; rep++) {
+        for (int i = 0; i < DISTINCT; i++) {
+            CompactRational got = cr_cache_encode_optimal(&cache, key_num(i), key_denom(i), NULL);
+            CompactRational want = cr_encode_optimal(key_num(i), key_denom(i), NULL);
+            if (memcmp(&got, &want, sizeof(got)) != 0) correct = false;
+        }
+    }
+    check(correct && cache.mask == 15, "9000 lookups over 3000 keys all correct");
+    cr_cache_free(&cache);
+    printf("\n");
+
+    // Test 4: Concurrent readers and writers
+    printf("Test 4: %d threads sharing one cache\n", THREADS);
+    for (int i = 0; i < DISTINCT; i++) {
+        expected[i] = cr_encode_optimal(key_num(i), key_denom(i), NULL);
+    }
+    cr_cache_init(&shared, 4096, NULL);
+    pthread_t ids[THREADS];
+    Worker workers[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        workers[t].seed = t * 977;
+        pthread_create(&ids[t], NULL, worker, &workers[t]);
+    }
+    bool all_match = true;
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(ids[t], NULL);
+        if (!workers[t].all_match) all_match = false;
+    }
+    cr_cache_stats(&shared, &hits, &misses);
+    printf("  %llu hits, %llu misses (%.1f%% hit rate)\n", (unsigned long long)hits,
+           (unsigned long long)misses, 100.0 * (double)hits / (double)(hits + misses));
+    check(all_match, "every lookup returned the uncached encoding");
+    check(hits + misses == (uint64_t)THREADS * LOOKUPS, "counters account for every lookup");
+    cr_cache_free(&shared);
+    printf("\n");
+
+    printf("=== Encoding Cache Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_cache();
+    return failures == 0 ? 0 : 1;
+}
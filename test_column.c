@@ -0,0 +1,138 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// COLUMN TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool same_value(const CompactRational* a, const CompactRational* b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+// Two-tuple value with a distinct sequence for every n below 2^16
+static CompactRational raw_pattern(uint32_t n) {
+    CompactRational cr;
+    cr_init(&cr);
+    cr.whole = (int16_t)0x8000;
+    cr.tuples[0] = (uint16_t)((1 + n % 255) << 8 | (n / 255) % 128);
+    cr.tuples[1] = (uint16_t)((1 + n / (255 * 128)) << 8 | 0x80);
+    return cr;
+}
+
+void test_column() {
+    printf("=== Column Tests ===\n\n");
+    CRError error;
+    CRColumn col;
+
+    // Test 1: Integer-mostly data with a few distinct fractions
+    printf("Test 1: Round trip\n");
+    enum { N = 10000 };
+    static CompactRational values[N], out[N];
+    const CompactRational fractions[4] = {
+        cr_from_fraction(1, 2, NULL), cr_from_fraction(1, 3, NULL), cr_from_fraction(2, 3, NULL),
+        cr_encode_optimal(1, 251LL * 253, NULL),
+    };
+    for (int i = 0; i < N; i++) {
+        values[i] = cr_from_int(i % 2000 - 1000, NULL);
+        if (i % 20 == 7) {
+            values[i] = fractions[(i / 20) % 4];
+            values[i].whole = (int16_t)((values[i].whole & 0x8000) | ((i % 100) & 0x7FFF));
+        }
+    }
+    cr_column_init(&col);
+    check(cr_column_append_array(&col, values, N / 2, &error) == N / 2 && error.code == CR_SUCCESS,
+          "array append");
+    bool appended = true;
+    for (int i = N / 2; i < N; i++) {
+        appended = appended && cr_column_append(&col, &values[i], NULL);
+    }
+    check(appended && col.count == N && col.tagged == N / 20 && col.pattern_count == 4,
+          "500 fractional rows share 4 patterns");
+    bool all_equal = true;
+    for (int i = 0; i < N; i++) {
+        CompactRational got = cr_column_get(&col, i, NULL);
+        if (!same_value(&got, &values[i])) all_equal = false;
+    }
+    check(all_equal, "cr_column_get returns every value bit for bit");
+    check(cr_column_unpack(&col, 63, N, out, &error) == N - 63 && error.code == CR_SUCCESS &&
+          memcmp(out, values + 63, sizeof(CompactRational) * (N - 63)) == 0, "cr_column_unpack from mid-stride");
+    printf("\n");
+
+    // Test 2: Size and scans
+    printf("Test 2: Footprint and scans\n");
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    cr_pack_array(values, N, &pa, NULL);
+    check(cr_column_footprint(&col) < cr_packed_footprint(&pa), "smaller than the packed array");
+    check(cr_column_footprint(&col) < (size_t)N * 2 + (size_t)N / 20 * 2 + 200 * 8, "about 2 bytes per row");
+    int64_t expected = 0;
+    for (int i = 0; i < N; i++) {
+        expected += cr16_whole(cr16_from_cr(&values[i]));
+    }
+    size_t tagged = 0;
+    check(cr16_sum(cr_column_wholes(&col), col.count, &tagged) == expected && tagged == col.tagged,
+          "cr16_sum over the lane array");
+    cr_packed_free(&pa);
+    cr_column_free(&col);
+    printf("\n");
+
+    // Test 3: Encodings are stored as cr_pack stores them
+    printf("Test 3: Normalization\n");
+    CompactRational raw, packed;
+    cr_init(&raw);
+    raw.whole = (int16_t)0x8003;
+    for (int t = 0; t < MAX_TUPLES; t++) {
+        raw.tuples[t] = (uint16_t)(1 << 8 | t);  // No end flag anywhere
+    }
+    uint8_t buf[CR_MAX_PACKED_SIZE];
+    cr_unpack(buf, cr_pack(&raw, buf, sizeof(buf)), &packed);
+    CompactRational trailing = cr_from_fraction(1, 2, NULL);
+    trailing.tuples[3] = 0x1234;  // Ignored: after the end flag
+    cr_column_init(&col);
+    cr_column_append(&col, &raw, NULL);
+    cr_column_append(&col, &trailing, NULL);
+    cr_column_append(&col, &fractions[0], NULL);
+    CompactRational got = cr_column_get(&col, 0, NULL);
+    check(same_value(&got, &packed), "missing end flag forced as cr_pack does");
+    got = cr_column_get(&col, 1, NULL);
+    check(same_value(&got, &fractions[0]) && col.pattern_count == 2, "tuples after the end flag are dropped");
+    printf("\n");
+
+    // Test 4: Errors
+    printf("Test 4: Errors\n");
+    got = cr_column_get(&col, 3, &error);
+    check(error.code == CR_ERROR_OUT_OF_BOUNDS && error.value1 == 3 && error.value2 == 3 &&
+          strstr(error.message, "column") != NULL && got.whole == 0, "get past the end");
+    check(cr_column_unpack(&col, 5, 1, out, &error) == 0 && error.code == CR_ERROR_OUT_OF_BOUNDS, "unpack past the end");
+    cr_column_free(&col);
+
+    cr_column_init(&col);
+    bool filled = true;
+    for (uint32_t n = 0; n < CR_COLUMN_MAX_PATTERNS; n++) {
+        CompactRational v = raw_pattern(n);
+        filled = filled && cr_column_append(&col, &v, NULL);
+    }
+    CompactRational extra = raw_pattern(CR_COLUMN_MAX_PATTERNS), repeat = raw_pattern(12345);
+    check(filled && col.pattern_count == CR_COLUMN_MAX_PATTERNS, "65536 distinct patterns");
+    check(!cr_column_append(&col, &extra, &error) && error.code == CR_ERROR_OUT_OF_BOUNDS &&
+          col.count == CR_COLUMN_MAX_PATTERNS, "a new pattern beyond the limit is refused");
+    got = cr_column_get(&col, 12345, NULL);
+    check(cr_column_append(&col, &repeat, NULL) && same_value(&got, &repeat), "known patterns still append");
+    cr_column_free(&col);
+    printf("\n");
+
+    printf("=== Column Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_column();
+    return failures == 0 ? 0 : 1;
+}
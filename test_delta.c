@@ -0,0 +1,145 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// DELTA CODEC TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+enum { N = 10000 };
+static CompactRational values[N], decoded[N], expected[N];
+
+// Encode values[0..n) in one call and decode them back in chunks of chunk
+static bool round_trip(size_t n, size_t chunk, size_t* bytes) {
+    CRDeltaEncoder enc;
+    cr_delta_encoder_init(&enc);
+    bool ok = cr_delta_encode(&enc, values, n, NULL) && cr_delta_encoder_flush(&enc, NULL);
+    *bytes = enc.size;
+
+    // What cr_pack and cr_unpack make of each value
+    for (size_t i = 0; i < n; i++) {
+        uint8_t buf[CR_MAX_PACKED_SIZE];
+        cr_unpack(buf, cr_pack(&values[i], buf, sizeof(buf)), &expected[i]);
+    }
+
+    CRDeltaDecoder dec;
+    CRError error;
+    cr_delta_decoder_init(&dec, enc.data, enc.size);
+    size_t done = 0, got;
+    while ((got = cr_delta_decode(&dec, decoded + done, chunk, &error)) > 0) {
+        done += got;
+    }
+    ok = ok && error.code == CR_SUCCESS && done == n && memcmp(decoded, expected, n * sizeof(CompactRational)) == 0;
+    for (size_t i = 0; ok && i < n; i++) {
+        Rational a = cr_to_rational(&decoded[i]), b = cr_to_rational(&values[i]);
+        ok = a.numerator == b.numerator && a.denominator == b.denominator;
+    }
+    cr_delta_encoder_free(&enc);
+    return ok;
+}
+
+void test_delta() {
+    printf("=== Delta Codec Tests ===\n\n");
+    size_t bytes;
+
+    // Test 1: A cumulative score column
+    printf("Test 1: Slowly changing scores\n");
+    int32_t total = -5000;
+    for (int i = 0; i < N; i++) {
+        total += i % 7 == 0 ? 2 : 1;
+        values[i] = i % 50 == 0 ? cr_from_fraction(2 * total + 1, 2, NULL) : cr_from_int(total, NULL);
+    }
+    check(round_trip(N, N, &bytes), "round trip bit for bit and through cr_to_rational");
+    check(bytes * 8 < (size_t)N * 6, "under 6 bits per value (packed: 16 or more)");
+    check(round_trip(N, 1, &bytes) && round_trip(N, 77, &bytes) && round_trip(N, 128, &bytes),
+          "decoding 1, 77 and 128 values at a time");
+    printf("\n");
+
+    // Test 2: Sorted leaderboard with repeated fractions
+    printf("Test 2: Repeated tuple sequences\n");
+    CompactRational third = cr_encode_optimal(1, 251LL * 253 * 254, NULL);
+    for (int i = 0; i < N; i++) {
+        values[i] = third;
+        values[i].whole = (int16_t)(0x8000 | ((10000 - i / 3) & 0x7FFF));
+    }
+    check(round_trip(N, 1000, &bytes) && bytes < (size_t)N, "runs of a three-tuple sequence cost under a byte per value");
+    printf("\n");
+
+    // Test 3: Worst cases
+    printf("Test 3: Worst cases\n");
+    uint32_t seed = 7;
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int32_t w = (i % 2 ? MAX_WHOLE_VALUE : MIN_WHOLE_VALUE);
+        values[i] = (seed >> 16) % 3 == 0 ? cr_from_int(w, NULL)
+                                           : cr_encode_optimal((int64_t)w * 1000 + (seed >> 8) % 1000, 1 + (seed >> 4) % 997, NULL);
+    }
+    check(round_trip(N, 300, &bytes), "full-range deltas and random fractions");
+    CompactRational raw;
+    cr_init(&raw);
+    raw.whole = (int16_t)0x8005;
+    for (int t = 0; t < MAX_TUPLES; t++) {
+        raw.tuples[t] = (uint16_t)(3 << 8 | t);  // No end flag
+    }
+    values[0] = raw;
+    values[1] = cr_from_fraction(1, 2, NULL);
+    values[1].tuples[2] = 0xBEEF;  // After the end flag
+    check(round_trip(2, 2, &bytes), "encodings normalized as cr_pack does");
+    check(round_trip(0, 10, &bytes) && bytes == 0, "empty stream");
+    for (int i = 0; i < 300; i++) {
+        cr_init(&values[i]);
+        values[i].whole = 0x4000;  // -16384, below MIN_WHOLE_VALUE but a valid field
+        if (i % 3 == 1) values[i] = cr_from_int(MAX_WHOLE_VALUE, NULL);
+        if (i % 3 == 2) {
+            values[i] = cr_from_fraction(1, 3, NULL);
+            values[i].whole = (int16_t)0xC000;
+        }
+    }
+    check(round_trip(300, 300, &bytes) && cr_to_rational(&decoded[0]).numerator == -16384, "whole field -16384 round trips");
+    printf("\n");
+
+    // Test 4: Streaming and errors
+    printf("Test 4: Streaming\n");
+    for (int i = 0; i < N; i++) {
+        values[i] = cr_from_int(i % 300, NULL);
+    }
+    CRDeltaEncoder enc;
+    CRError error;
+    cr_delta_encoder_init(&enc);
+    bool appended = true;
+    for (int i = 0; i < N; i += 333) {
+        appended = appended && cr_delta_encode(&enc, values + i, (size_t)(N - i < 333 ? N - i : 333), &error);
+    }
+    cr_delta_encoder_flush(&enc, &error);
+    CRDeltaDecoder dec;
+    cr_delta_decoder_init(&dec, enc.data, enc.size);
+    check(appended && enc.count == N && cr_delta_decode(&dec, decoded, N + 5, &error) == N &&
+          memcmp(decoded, values, sizeof(values)) == 0, "appended in pieces, decoded at once");
+    check(cr_delta_decode(&dec, decoded, 10, &error) == 0 && error.code == CR_SUCCESS, "end of stream");
+
+    uint8_t width = enc.data[1];
+    enc.data[1] = 17;  // Bit width out of range
+    cr_delta_decoder_init(&dec, enc.data, enc.size);
+    check(cr_delta_decode(&dec, decoded, N, &error) == 0 && error.code == CR_ERROR_INVALID_ENCODING &&
+          error.value1 == 0, "malformed first block");
+    enc.data[1] = width;
+    cr_delta_decoder_init(&dec, enc.data, enc.size - 1);
+    size_t prefix = cr_delta_decode(&dec, decoded, N, &error);
+    check(prefix == N - N % CR_DELTA_BLOCK && error.code == CR_ERROR_INVALID_ENCODING, "truncated last block");
+    cr_delta_encoder_free(&enc);
+    printf("\n");
+
+    printf("=== Delta Codec Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_delta();
+    return failures == 0 ? 0 : 1;
+}
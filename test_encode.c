@@ -0,0 +1,131 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// ============================================================================
+// OPTIMAL ENCODING TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool equals_fraction(const CompactRational* cr, int64_t num, int64_t denom) {
+    Rational expected = {num, denom};
+    reduce_rational(&expected);
+    Rational got = cr_to_rational(cr);
+    return got.numerator == expected.numerator && got.denominator == expected.denominator;
+}
+
+static int tuple_count(const CompactRational* cr) {
+    return (int)(cr_size(cr) - 2) / 2;
+}
+
+static int64_t lcm(int64_t a, int64_t b) {
+    return a / gcd(a, b) * b;
+}
+
+// Brute force: does some pair of antichain denominators have an lcm that q divides?
+static bool pair_exists(int64_t q) {
+    for (int d1 = MIN_DENOMINATOR; d1 <= MAX_DENOMINATOR; d1++) {
+        for (int d2 = d1; d2 <= MAX_DENOMINATOR; d2++) {
+            if (lcm(d1, d2) % q == 0) return true;
+        }
+    }
+    return false;
+}
+
+void test_encode() {
+    printf("=== Optimal Encoding Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Agrees with cr_from_fraction wherever one tuple suffices
+    printf("Test 1: Single-tuple fractions\n");
+    bool same = true;
+    for (int q = 1; q <= MAX_DENOMINATOR; q++) {
+        for (int p = -2 * q; p <= 2 * q; p += 3) {
+            CompactRational a = cr_from_fraction(p, q, NULL);
+            CompactRational b = cr_encode_optimal(p, q, &error);
+            if (memcmp(&a, &b, sizeof(a)) != 0 || error.code != CR_SUCCESS) same = false;
+        }
+    }
+    check(same, "bit-identical to cr_from_fraction for denominators 1..255");
+    printf("\n");
+
+    // Test 2: Denominators split across several tuples
+    printf("Test 2: Multi-tuple exact encodings\n");
+    CompactRational cr = cr_encode_optimal(1, 131 * 137, &error);
+    check(equals_fraction(&cr, 1, 131 * 137) && tuple_count(&cr) == 2 && error.code == CR_SUCCESS,
+          "1/17947 uses two tuples");
+    cr = cr_encode_optimal(7 * 17947 + 5, 17947, &error);
+    check(equals_fraction(&cr, 7 * 17947 + 5, 17947), "7 5/17947 is exact");
+    cr = cr_encode_optimal(-3, 131 * 137 * 139, &error);
+    check(equals_fraction(&cr, -3, 131 * 137 * 139) && tuple_count(&cr) == 3, "-3/2494633 uses three tuples");
+    cr = cr_encode_optimal(301, 256 * 3, &error);
+    check(error.code == CR_ERROR_INEXACT, "301/768 (2^8 factor) reports CR_ERROR_INEXACT");
+    printf("  301/768 approximated with error %.3g\n", fabs(cr_to_double(&cr, NULL) - 301.0 / 768));
+    check(fabs(cr_to_double(&cr, NULL) - 301.0 / 768) < 1e-9, "approximation is close");
+    cr = cr_encode_optimal(INT64_MIN, -1, &error);
+    check(equals_fraction(&cr, MAX_WHOLE_VALUE, 1) && error.code == CR_ERROR_VALUE_CLAMPED,
+          "INT64_MIN/-1 clamps to the largest whole");
+    cr = cr_encode_optimal(INT64_MIN, 2, &error);
+    check(equals_fraction(&cr, MIN_WHOLE_VALUE, 1) && error.code == CR_ERROR_VALUE_CLAMPED,
+          "INT64_MIN/2 clamps to the smallest whole");
+    cr = cr_encode_optimal(INT64_MIN, INT64_MIN, &error);
+    check(equals_fraction(&cr, 1, 1) && error.code == CR_SUCCESS, "INT64_MIN/INT64_MIN is 1");
+    cr = cr_encode_optimal(-INT64_MAX, INT64_MIN, &error);
+    check(error.code == CR_ERROR_INEXACT && fabs(cr_to_double(&cr, NULL) - 1.0) < 1e-9,
+          "-INT64_MAX/INT64_MIN (2^63 factor) is approximated just under 1");
+    cr = cr_encode_optimal(1, 0, &error);
+    check(error.code == CR_ERROR_DIVISION_BY_ZERO, "division by zero is reported");
+    printf("\n");
+
+    // Test 3: Exact and minimal against brute force over pairs
+    printf("Test 3: Denominators 256..3000 against brute force\n");
+    bool exact = true;
+    bool minimal = true;
+    int two = 0, more = 0, inexact = 0;
+    for (int64_t q = 256; q <= 3000; q++) {
+        int64_t p = q / 2 + 1;
+        while (gcd(p, q) != 1) p++;
+        cr = cr_encode_optimal(p, q, &error);
+        if (error.code == CR_ERROR_INEXACT) {
+            inexact++;
+            if (pair_exists(q)) minimal = false;
+            continue;
+        }
+        if (!equals_fraction(&cr, p, q)) exact = false;
+        if ((tuple_count(&cr) == 2) != pair_exists(q)) minimal = false;
+        if (tuple_count(&cr) == 2) two++; else more++;
+    }
+    printf("  %d two-tuple, %d with more tuples, %d inexact\n", two, more, inexact);
+    check(exact, "every exact encoding decodes to p/q");
+    check(minimal, "two tuples exactly when a pair of denominators exists");
+    printf("\n");
+
+    // Test 4: Speed
+    printf("Test 4: Speed\n");
+    clock_t start = clock();
+    int calls = 0;
+    for (int rep = 0; rep < 20; rep++) {
+        for (int64_t q = 256; q <= 3000; q++, calls++) {
+            cr = cr_encode_optimal(1, q, NULL);
+        }
+    }
+    double us = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / calls;
+    printf("  %.2f us per encoding\n", us);
+    check(us < 100.0, "well under 100 us per encoding");
+    printf("\n");
+
+    printf("=== Optimal Encoding Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_encode();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+// ============================================================================
+// ERROR REPORTING TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+// Format a status and compare it with the message a CRError received
+static bool message_matches(const CRError* error) {
+    char buf[256];
+    CRStatus status = cr_last_error();
+    cr_error_format(buf, sizeof(buf), &status);
+    return strcmp(buf, error->message) == 0;
+}
+
+static void* clamp_in_thread(void* arg) {
+    uint32_t* flags = (uint32_t*)arg;
+    cr_error_clear();
+    cr_from_int(100000, NULL);
+    *flags = cr_error_flags();
+    return NULL;
+}
+
+void test_error() {
+    printf("=== Error Reporting Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Sticky flags without a CRError
+    printf("Test 1: Sticky flags\n");
+    cr_error_clear();
+    check(cr_error_flags() == 0 && cr_last_error().code == CR_SUCCESS, "clear state after cr_error_clear");
+    cr_from_fraction(1, 0, NULL);
+    cr_from_int(20000, NULL);
+    cr_from_int(5, NULL);
+    check(cr_error_flags() == (CR_ERROR_FLAG(CR_ERROR_DIVISION_BY_ZERO) | CR_ERROR_FLAG(CR_ERROR_VALUE_CLAMPED)),
+          "both failures recorded, success does not clear them");
+    CRStatus last = cr_last_error();
+    check(last.code == CR_ERROR_VALUE_CLAMPED && last.op == CR_OP_FROM_INT && last.value1 == 20000 &&
+          last.value2 == MAX_WHOLE_VALUE, "last failure holds code, operation and values");
+    check(sizeof(CRStatus) == 16, "CRStatus is 16 bytes");
+    cr_error_clear();
+    check(cr_error_flags() == 0, "cr_error_clear resets flags");
+    CRError both;
+    cr_encode_optimal(INT64_C(20000) * 1000003 + 1, 1000003, &both);
+    check(both.code == CR_ERROR_VALUE_CLAMPED && cr_last_error().code == CR_ERROR_VALUE_CLAMPED &&
+          cr_error_flags() == (CR_ERROR_FLAG(CR_ERROR_VALUE_CLAMPED) | CR_ERROR_FLAG(CR_ERROR_INEXACT)),
+          "rounded and clamped: the clamp is reported, both flags are set");
+    cr_error_clear();
+    cr_approximate(30000.123456789, 1, 1, NULL);
+    check(cr_error_flags() == (CR_ERROR_FLAG(CR_ERROR_VALUE_CLAMPED) | CR_ERROR_FLAG(CR_ERROR_INEXACT)),
+          "the same through cr_approximate");
+    cr_error_clear();
+    printf("\n");
+
+    // Test 2: CRError messages come from the same status
+    printf("Test 2: Messages\n");
+    cr_from_int(-20000, &error);
+    printf("  %s\n", error.message);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && message_matches(&error), "clamp message");
+    cr_from_fraction(3, 0, &error);
+    printf("  %s\n", error.message);
+    check(strcmp(error.message, "Division by zero (numerator=3, denominator=0)") == 0 && message_matches(&error),
+          "division message");
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    cr_packed_get(&pa, 7, &error);
+    printf("  %s\n", error.message);
+    check(error.code == CR_ERROR_OUT_OF_BOUNDS && error.value1 == 7 && message_matches(&error), "bounds message");
+    cr_packed_free(&pa);
+    cr_from_int(1, &error);
+    check(error.code == CR_SUCCESS && strcmp(error.message, "Success") == 0, "success message");
+    char small[8];
+    CRStatus status = cr_last_error();
+    size_t len = cr_error_format(small, sizeof(small), &status);
+    check(len > sizeof(small) && strlen(small) == sizeof(small) - 1, "truncates and returns full length");
+    printf("\n");
+
+    // Test 3: Per-thread state
+    printf("Test 3: Thread isolation\n");
+    cr_error_clear();
+    uint32_t thread_flags = 0;
+    pthread_t id;
+    pthread_create(&id, NULL, clamp_in_thread, &thread_flags);
+    pthread_join(id, NULL);
+    check(thread_flags == CR_ERROR_FLAG(CR_ERROR_VALUE_CLAMPED), "worker sees its own failure");
+    check(cr_error_flags() == 0, "main thread flags untouched");
+    printf("\n");
+
+    printf("=== Error Reporting Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_error();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// COLUMN FILE TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+#define PATH "test_file.crcol"
+enum { N = 10000, BLOCK = 1000 };
+
+static CompactRational values[N];
+
+// Mixed column: mostly integers, some fractions, a few negatives
+static void make_values(void) {
+    for (int i = 0; i < N; i++) {
+        if (i % 3 == 0) {
+            values[i] = cr_from_fraction(i % 1000 - 300, 7 + i % 200, NULL);
+        } else {
+            values[i] = cr_from_int(i % 500 - 100, NULL);
+        }
+    }
+}
+
+static double to_double(const CompactRational* cr) {
+    return cr_to_double(cr, NULL);
+}
+
+static bool block_stats_match(const CRFile* f) {
+    for (size_t b = 0; b < f->block_count; b++) {
+        const CRFileBlock* blk = &f->blocks[b];
+        double lo = 1e9, hi = -1e9, sum = 0.0;
+        uint32_t ints = 0;
+        for (size_t i = b * BLOCK; i < (b + 1) * BLOCK && i < N; i++) {
+            double v = to_double(&values[i]);
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+            sum += v;
+            if (!(values[i].whole & 0x8000)) ints++;
+        }
+        // Many distinct denominators: the fraction is approximated, to within 1e-3
+        double got = (double)blk->sum_whole + to_double(&blk->sum_fraction);
+        double tolerance = blk->flags & CR_FILE_BLOCK_SUM_INEXACT ? 1e-3 : 1e-6;
+        if (to_double(&blk->min) != lo || to_double(&blk->max) != hi) return false;
+        if (blk->integer_count != ints || got - sum > tolerance || sum - got > tolerance) return false;
+    }
+    return true;
+}
+
+// Overwrite bytes of the written file in place
+static void patch_file(long offset, const void* bytes, size_t n) {
+    FILE* fp = fopen(PATH, "r+b");
+    fseek(fp, offset, SEEK_SET);
+    fwrite(bytes, 1, n, fp);
+    fclose(fp);
+}
+
+void test_file() {
+    printf("=== Column File Tests ===\n\n");
+    CRError error;
+    make_values();
+
+    // Test 1: Streaming writer
+    printf("Test 1: Write in uneven chunks\n");
+    CRFileWriter w;
+    check(cr_file_writer_open(&w, PATH, BLOCK, &error), "writer opens");
+    bool appended = true;
+    for (int start = 0; start < N; start += 777) {
+        int n = N - start < 777 ? N - start : 777;
+        if (!cr_file_writer_append(&w, values + start, (size_t)n, &error)) appended = false;
+    }
+    check(appended, "all chunks appended");
+    check(cr_file_writer_close(&w, &error) && error.code == CR_SUCCESS, "writer closes");
+    printf("\n");
+
+    // Test 2: Mapped reading
+    printf("Test 2: Open and read in place\n");
+    CRFile f;
+    check(cr_file_open(&f, PATH, CR_FILE_VERIFY, &error), "opens with CR_FILE_VERIFY");
+    check(cr_file_count(&f) == N && f.block_count == (N + BLOCK - 1) / BLOCK, "count and block count");
+    check(f.values.data >= f.map && f.values.data < f.map + f.map_size, "stream is read from the mapping");
+    bool same = true, bitmap = true;
+    for (size_t i = 0; i < N; i++) {
+        CompactRational cr = cr_file_get(&f, i, NULL);
+        if (memcmp(&cr, &values[i], sizeof(cr)) != 0) same = false;
+        if (cr_file_is_integer(&f, i) != !(values[i].whole & 0x8000)) bitmap = false;
+    }
+    check(same, "every value round-trips bit for bit");
+    check(bitmap, "integer bitmap matches bit 15");
+    CompactRational range[64];
+    check(cr_unpack_array(&f.values, 5000, 64, range, NULL) == 64 &&
+          memcmp(range, values + 5000, sizeof(range)) == 0, "range decode through the view");
+    check(block_stats_match(&f), "block min, max, sum and integer count");
+    printf("\n");
+
+    // Test 3: Views copy before growing
+    printf("Test 3: Appending to a view\n");
+    CRPackedArray copy = f.values;
+    CompactRational extra = cr_from_fraction(1, 3, NULL);
+    check(cr_packed_append(&copy, &extra, &error) && !copy.view && copy.count == N + 1, "append detaches");
+    CompactRational last = cr_packed_get(&copy, N, NULL);
+    CompactRational first = cr_packed_get(&copy, 0, NULL);
+    check(memcmp(&last, &extra, sizeof(last)) == 0 && memcmp(&first, &values[0], sizeof(first)) == 0,
+          "copied array holds old and new values");
+    cr_packed_free(&copy);
+    CRPackedArray view = f.values;
+    cr_packed_free(&view);  // Must not free the mapping
+    check(view.count == 0 && cr_file_get(&f, 1, NULL).whole == values[1].whole, "freeing a view releases nothing");
+    cr_file_close(&f);
+    printf("\n");
+
+    // Test 4: One-call writer from a packed array
+    printf("Test 4: cr_file_write_packed\n");
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    cr_pack_array(values, N, &pa, NULL);
+    check(cr_file_write_packed(PATH, &pa, 0, &error), "written with default block size");
+    check(cr_file_open(&f, PATH, 0, &error) && f.header->block_size == CR_FILE_DEFAULT_BLOCK_SIZE &&
+          f.values.size == pa.size && memcmp(f.values.data, pa.data, pa.size) == 0, "stream bytes identical");
+    cr_file_close(&f);
+    cr_packed_free(&pa);
+    printf("\n");
+
+    // Test 5: Rejected files
+    printf("Test 5: Malformed files\n");
+    check(!cr_file_open(&f, "does-not-exist.crcol", 0, &error) && error.code == CR_ERROR_IO, "missing file");
+    printf("  %s\n", error.message);
+    patch_file(0, "X", 1);
+    check(!cr_file_open(&f, PATH, 0, &error) && error.code == CR_ERROR_INVALID_ENCODING &&
+          error.value1 == CR_FILE_BAD_MAGIC, "bad magic");
+    printf("  %s\n", error.message);
+    patch_file(0, "C", 1);
+    uint8_t bad_flag = 0xFF;
+    long second = (long)(sizeof(CRFileHeader) + cr_size(&values[0]));
+    patch_file(second + 1, &bad_flag, 1);  // Integer value 1 now claims tuples
+    check(cr_file_open(&f, PATH, 0, &error), "unverified open trusts the stream");
+    cr_file_close(&f);
+    check(!cr_file_open(&f, PATH, CR_FILE_VERIFY, &error) && error.code == CR_ERROR_INVALID_ENCODING &&
+          error.value1 == CR_FILE_BAD_STREAM && error.value2 == 1, "verified open finds value 1");
+    printf("  %s\n", error.message);
+    uint8_t good_flag = (uint8_t)((uint16_t)values[1].whole >> 8);
+    patch_file(second + 1, &good_flag, 1);
+
+    cr_file_open(&f, PATH, 0, NULL);
+    long entry = (long)(f.header->index_offset + sizeof(uint64_t));  // Values from CR_PACKED_INDEX_STRIDE
+    uint64_t past_end = f.values.size + 1000, at_end = f.values.size;
+    cr_file_close(&f);
+    patch_file(entry, &past_end, sizeof(past_end));
+    check(cr_file_open(&f, PATH, 0, &error), "unverified open trusts the index");
+    CompactRational got = cr_file_get(&f, CR_PACKED_INDEX_STRIDE, &error);
+    check(error.code == CR_ERROR_INVALID_ENCODING && error.value1 == CR_PACKED_INDEX_STRIDE && got.whole == 0,
+          "entry past the stream: reads report CR_ERROR_INVALID_ENCODING");
+    check(cr_unpack_array(&f.values, CR_PACKED_INDEX_STRIDE + 1, 4, range, &error) == 0 &&
+          error.code == CR_ERROR_INVALID_ENCODING, "and range decodes stop before reading");
+    uint8_t wire[64];
+    size_t written = 1;
+    check(cr_write_packed(wire, sizeof(wire), &f.values, CR_PACKED_INDEX_STRIDE, 4, &written) == 0 &&
+          written == 0, "and write_packed copies nothing");
+    check(cr_file_get(&f, CR_PACKED_INDEX_STRIDE - 1, &error).whole == values[CR_PACKED_INDEX_STRIDE - 1].whole &&
+          error.code == CR_SUCCESS, "other entries still read");
+    cr_file_close(&f);
+    patch_file(entry, &at_end, sizeof(at_end));
+    cr_file_open(&f, PATH, 0, NULL);
+    cr_file_get(&f, CR_PACKED_INDEX_STRIDE + 3, &error);
+    check(error.code == CR_ERROR_INVALID_ENCODING, "entry at the end of the stream: the skip is checked");
+    cr_file_close(&f);
+    check(!cr_file_open(&f, PATH, CR_FILE_VERIFY, &error) && error.value1 == CR_FILE_BAD_STREAM,
+          "verified open rejects the index");
+    FILE* fp = fopen(PATH, "ab");
+    fputc(0, fp);
+    fclose(fp);
+    check(!cr_file_open(&f, PATH, 0, &error) && error.code == CR_ERROR_INVALID_ENCODING &&
+          error.value1 == CR_FILE_BAD_LAYOUT, "size mismatch");
+    remove(PATH);
+    printf("\n");
+
+    printf("=== Column File Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_file();
+    return failures == 0 ? 0 : 1;
+}
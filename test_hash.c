@@ -0,0 +1,179 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// HASHING AND GROUPING TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+// A raw encoding: whole plus numerators[i]/denominators[i]
+static CompactRational raw(int16_t whole, const int* numerators, const int* denominators, int tuples) {
+    CompactRational cr;
+    memset(&cr, 0, sizeof(cr));
+    cr.whole = (int16_t)((whole & 0x7FFF) | (tuples > 0 ? 0x8000 : 0));
+    for (int i = 0; i < tuples; i++) {
+        cr.tuples[i] = (uint16_t)(numerators[i] << 8 | (denominators[i] - 128) | (i == tuples - 1 ? 0x80 : 0));
+    }
+    return cr;
+}
+
+static bool same_hash(const CompactRational* a, const CompactRational* b) {
+    return cr_equal(a, b) && cr_hash(a) == cr_hash(b);
+}
+
+void test_hash() {
+    printf("=== Hashing and Grouping Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Equal values hash equal, however they are encoded
+    printf("Test 1: Value hash\n");
+    CompactRational split = raw(0, (int[]){64, 32}, (int[]){128, 128}, 2);
+    CompactRational merged = raw(0, (int[]){96}, (int[]){128}, 1);
+    check(same_hash(&split, &merged), "64/128 + 32/128 equals 96/128");
+    CompactRational thirds = raw(0, (int[]){64, 43, 22}, (int[]){128, 129, 132}, 3);
+    CompactRational one = cr_from_int(1, NULL);
+    check(same_hash(&thirds, &one), "1/2 + 1/3 + 1/6 equals 1");
+    CompactRational canonical = cr_canonicalize(&split, NULL);
+    check(same_hash(&split, &canonical), "non-canonical encoding equals its cr_canonicalize form");
+    CompactRational half = cr_from_fraction(-1, 2, NULL);
+    CompactRational negative = raw(-1, (int[]){64}, (int[]){128}, 1);
+    check(same_hash(&half, &negative), "-1 + 64/128 equals -1/2");
+    CompactRational stale = cr_from_int(5, NULL);
+    stale.tuples[0] = 0x1234;
+    CompactRational five = cr_from_int(5, NULL);
+    check(same_hash(&stale, &five), "tuple words are ignored without the tuple flag");
+
+    CompactRational third = cr_from_fraction(1, 3, NULL);
+    CompactRational two_thirds = cr_from_fraction(2, 3, NULL);
+    CompactRational minus_five = cr_from_int(-5, NULL);
+    check(!cr_equal(&third, &two_thirds) && cr_hash(&third) != cr_hash(&two_thirds), "1/3 differs from 2/3");
+    check(!cr_equal(&five, &minus_five) && cr_hash(&five) != cr_hash(&minus_five), "5 differs from -5");
+    printf("\n");
+
+    // Test 2: The encoding hash on canonical input
+    printf("Test 2: Encoding hash\n");
+    bool consistent = true, spread = true;
+    for (int d = 1; d <= 300; d++) {
+        CompactRational a = cr_encode_optimal(7, d, NULL), b = cr_encode_optimal(14, 2 * d, NULL);
+        CompactRational next = cr_encode_optimal(8, d, NULL);
+        consistent = consistent && cr_hash_bits(&a) == cr_hash_bits(&b);
+        spread = spread && cr_hash_bits(&a) != cr_hash_bits(&next);
+    }
+    check(consistent, "cr_encode_optimal output: equal values, equal hashes");
+    check(spread, "neighbouring values hash apart");
+    stale = five;
+    stale.tuples[2] = 0xFFFF;
+    CompactRational ended = merged;
+    ended.tuples[1] = 0xABCD;
+    check(cr_hash_bits(&stale) == cr_hash_bits(&five) && cr_hash_bits(&ended) == cr_hash_bits(&merged),
+          "words past the end flag are ignored");
+    check(cr_hash_bits(&split) != cr_hash_bits(&merged), "but distinct encodings of one value differ");
+    printf("\n");
+
+    // Test 3: Adding, looking up and listing
+    printf("Test 3: Count map\n");
+    CRCountMap map;
+    check(cr_count_map_init(&map, 8, 0, &error) && error.code == CR_SUCCESS && map.mask + 1 >= 16, "initialized");
+    cr_count_map_add(&map, &split, 2, NULL);
+    cr_count_map_add(&map, &merged, 3, NULL);
+    cr_count_map_add(&map, &canonical, 1, &error);
+    cr_count_map_add(&map, &third, 1, NULL);
+    check(error.code == CR_SUCCESS && map.size == 2, "three encodings of 3/4 share one entry");
+    check(cr_count_map_get(&map, &merged) == 6 && cr_count_map_get(&map, &third) == 1 &&
+          cr_count_map_get(&map, &two_thirds) == 0, "counts looked up by value");
+    CompactRational keys[4];
+    uint64_t counts[4];
+    size_t listed = cr_count_map_entries(&map, keys, counts, 4);
+    uint64_t total = 0;
+    for (size_t i = 0; i < listed; i++) {
+        total += counts[i];
+    }
+    check(listed == 2 && total == 7 && cr_count_map_entries(&map, NULL, NULL, 1) == 1, "entries listed");
+
+    bool filled = true;
+    for (int i = 0; filled && i < 1000; i++) {
+        CompactRational v = cr_from_int(i, NULL);
+        filled = cr_count_map_add(&map, &v, 1, &error);
+    }
+    check(!filled && error.code == CR_ERROR_OUT_OF_BOUNDS && cr_last_error().op == CR_OP_COUNT_MAP &&
+          error.value1 == (int32_t)(map.mask + 1) && map.size == map.mask + 1, "full table reported");
+    check(cr_count_map_get(&map, &third) == 1 && cr_count_map_get(&map, &two_thirds) == 0,
+          "lookups still terminate when full");
+    cr_count_map_free(&map);
+
+    cr_count_map_init(&map, 8, CR_COUNT_CANONICAL, NULL);
+    cr_count_map_add(&map, &split, 2, NULL);
+    cr_count_map_add(&map, &merged, 3, NULL);
+    check(map.size == 2 && cr_count_map_get(&map, &merged) == 3, "CR_COUNT_CANONICAL keys by encoding");
+    cr_count_map_free(&map);
+    printf("\n");
+
+    // Test 4: Parallel counting matches a serial count
+    printf("Test 4: Counting a packed column\n");
+    enum { N = 200000, DISTINCT = 3000 };
+    CompactRational* values = malloc(N * sizeof(CompactRational));
+    uint32_t seed = 11;
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int32_t k = (int32_t)(seed >> 8) % DISTINCT;
+        values[i] = i % 4 == 0 ? cr_from_int(k, NULL) : cr_from_fraction(k, 2 + k % 37, NULL);
+    }
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    cr_pack_array(values, N, &pa, NULL);
+    CRCountMap serial;
+    cr_count_map_init(&serial, 2 * DISTINCT, 0, NULL);
+    for (int i = 0; i < N; i++) {
+        cr_count_map_add(&serial, &values[i], 1, NULL);
+    }
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        cr_count_map_init(&map, 2 * DISTINCT, 0, NULL);
+        bool counted = cr_count_packed(&map, &pa, threads, &error);
+        bool same = map.size == serial.size;
+        for (int i = 0; same && i < N; i += 7) {
+            same = cr_count_map_get(&map, &values[i]) == cr_count_map_get(&serial, &values[i]);
+        }
+        char description[80];
+        snprintf(description, sizeof(description), "%d thread%s: same counts as serial adds", threads,
+                 threads == 1 ? "" : "s");
+        check(counted && error.code == CR_SUCCESS && same, description);
+        cr_count_map_free(&map);
+    }
+
+    cr_count_map_init(&map, 2 * DISTINCT, CR_COUNT_CANONICAL, NULL);
+    cr_count_packed(&map, &pa, 0, &error);
+    check(error.code == CR_SUCCESS && map.size == serial.size && cr_count_map_get(&map, &values[1]) ==
+          cr_count_map_get(&serial, &values[1]), "canonical column, one thread per CPU");
+    cr_count_packed(&map, &pa, 2, NULL);
+    check(cr_count_map_get(&map, &values[1]) == 2 * cr_count_map_get(&serial, &values[1]), "counting again adds");
+    cr_count_map_free(&map);
+
+    cr_count_map_init(&map, 100, 0, NULL);
+    check(!cr_count_packed(&map, &pa, 2, &error) && error.code == CR_ERROR_OUT_OF_BOUNDS, "small map fills up");
+    cr_count_map_free(&map);
+
+    CRPackedArray empty;
+    cr_packed_init(&empty);
+    cr_count_map_init(&map, 1, 0, NULL);
+    check(cr_count_packed(&map, &empty, 4, &error) && error.code == CR_SUCCESS && map.size == 0, "empty column");
+    cr_count_map_free(&map);
+    cr_count_map_free(&serial);
+    cr_packed_free(&pa);
+    free(values);
+    printf("\n");
+
+    printf("=== Hashing and Grouping Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_hash();
+    return failures == 0 ? 0 : 1;
+}
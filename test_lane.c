@@ -0,0 +1,159 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// 16-BIT LANE TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+// Largest integer <= the value
+static int64_t value_floor(const CompactRational* cr) {
+    Rational r = cr_to_rational(cr);
+    return r.numerator / r.denominator - (r.numerator % r.denominator < 0 ? 1 : 0);
+}
+
+// The lane contract: w <= value < w + MAX_TUPLES, i.e. floor in [w, w + MAX_TUPLES)
+static bool lane_bounds(cr16_t lane, const CompactRational* cr) {
+    int64_t floor = value_floor(cr);
+    return floor >= cr16_whole(lane) && floor < cr16_whole(lane) + MAX_TUPLES;
+}
+
+void test_lane() {
+    printf("=== 16-Bit Lane Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Lanes share the whole word of CompactRational
+    printf("Test 1: Integer lanes\n");
+    bool round_trip = true;
+    for (int32_t v = MIN_WHOLE_VALUE; v <= MAX_WHOLE_VALUE; v++) {
+        CompactRational full = cr_from_int(v, NULL);
+        cr16_t lane = cr16_from_int(v);
+        CompactRational back = cr16_to_cr(lane);
+        if (lane != cr16_from_cr(&full) || cr16_whole(lane) != v || !cr16_is_integer(lane) ||
+            memcmp(&back, &full, sizeof(full)) != 0) {
+            round_trip = false;
+        }
+    }
+    check(round_trip, "every integer matches cr_from_int and promotes back exactly");
+    check(cr16_whole(cr16_from_int(100000)) == MAX_WHOLE_VALUE && cr16_whole(cr16_from_int(-100000)) == MIN_WHOLE_VALUE,
+          "cr16_from_int saturates");
+    printf("\n");
+
+    // Test 2: Tagged lanes
+    printf("Test 2: Tagged lanes\n");
+    CompactRational neg = cr_from_fraction(-7, 3, NULL);
+    cr16_t lane = cr16_from_cr(&neg);
+    check(!cr16_is_integer(lane) && cr16_whole(lane) == -3, "-7/3 is tagged with its floor");
+    cr16_t sum = cr16_add(lane, cr16_from_int(5));
+    check(!cr16_is_integer(sum) && cr16_whole(sum) == 2, "sums with a tagged lane stay tagged");
+    CompactRational promoted = cr16_to_cr(lane);
+    check(promoted.whole == cr_from_int(-3, NULL).whole, "a tagged lane promotes to its floor");
+    printf("\n");
+
+    // Test 3: Arithmetic
+    printf("Test 3: Arithmetic\n");
+    check(cr16_whole(cr16_add(cr16_from_int(-20), cr16_from_int(7))) == -13 &&
+          cr16_whole(cr16_sub(cr16_from_int(-20), cr16_from_int(7))) == -27, "add and subtract");
+    check(cr16_whole(cr16_add(cr16_from_int(MAX_WHOLE_VALUE), cr16_from_int(1))) == MAX_WHOLE_VALUE &&
+          cr16_whole(cr16_sub(cr16_from_int(MIN_WHOLE_VALUE), cr16_from_int(1))) == MIN_WHOLE_VALUE,
+          "saturation at both ends");
+    printf("\n");
+
+    // Test 4: Arrays
+    printf("Test 4: Arrays\n");
+    enum { N = 1000 };
+    static CompactRational values[N];
+    static cr16_t lanes[N], others[N], out[N];
+    for (int i = 0; i < N; i++) {
+        values[i] = i % 10 == 0 ? cr_from_fraction(i * 3 + 1, 3, NULL) : cr_from_int(i - 500, NULL);
+        others[i] = cr16_from_int(2 * i);
+    }
+    check(cr16_from_array(values, N, lanes) == N / 10, "one in ten values is tagged");
+    size_t tagged = 0;
+    int64_t expected = 0;
+    for (int i = 0; i < N; i++) {
+        expected += cr16_whole(lanes[i]);
+    }
+    check(cr16_sum(lanes, N, &tagged) == expected && tagged == N / 10, "cr16_sum and the tagged count");
+
+    size_t redo = cr16_add_array(lanes, others, out, N, &error);
+    bool exact = true;
+    for (int i = 0; i < N; i++) {
+        if (!cr16_is_integer(out[i])) continue;
+        CompactRational full = cr_add(&values[i], &(CompactRational){(int16_t)others[i], {0}}, NULL);
+        if (cr16_from_cr(&full) != out[i]) exact = false;
+    }
+    check(redo == N / 10 && error.code == CR_SUCCESS && exact, "integer results match cr_add");
+
+    cr16_t big[N];
+    for (int i = 0; i < N; i++) {
+        big[i] = cr16_from_int(i == 700 ? MAX_WHOLE_VALUE : 16000);
+    }
+    cr16_add_array(big, big, big, N, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && error.value1 == 32000 && cr16_whole(big[700]) == MAX_WHOLE_VALUE,
+          "clamp reported with the first unclamped sum, in place");
+    for (int i = 0; i < N; i++) {
+        big[i] = cr16_from_int(i == 700 ? -MAX_WHOLE_VALUE : 1);
+    }
+    cr16_add_array(big, big, out, N, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && error.value1 == -2 * MAX_WHOLE_VALUE,
+          "clamp found in a later block");
+    printf("\n");
+
+    // Test 5: Tagged wholes from the encoders are lower bounds, not floors
+    printf("Test 5: Encoder and cr_add lanes\n");
+    bool bounded = true;
+    int below_floor = 0;
+    for (int64_t d = 2; d <= 3000; d++) {
+        CompactRational encoded = cr_encode_optimal(d * 7 + 5, d, NULL);
+        cr16_t lane = cr16_from_cr(&encoded);
+        bounded = bounded && lane_bounds(lane, &encoded);
+        below_floor += cr16_whole(lane) < value_floor(&encoded);
+    }
+    check(bounded && below_floor > 0, "cr_encode_optimal: floor in [w, w + MAX_TUPLES), often above w");
+
+    bool sums_bounded = true, lane_sums_bounded = true;
+    int sums_below = 0;
+    for (int i = 2; i < 600; i++) {
+        CompactRational a = cr_from_fraction(i, 2 + i % 97, NULL), b = cr_from_fraction(-3 * i, 3 + i % 89, NULL);
+        CompactRational total = cr_add(&a, &b, NULL);
+        cr16_t lane = cr16_from_cr(&total);
+        if (!cr16_is_integer(lane)) {
+            sums_bounded = sums_bounded && lane_bounds(lane, &total);
+            sums_below += cr16_whole(lane) < value_floor(&total);
+        }
+        // cr16_add of two tagged lanes: a + b in [s, s + 2 * MAX_TUPLES)
+        cr16_t s = cr16_add(cr16_from_cr(&a), cr16_from_cr(&b));
+        int64_t floor = value_floor(&total);
+        lane_sums_bounded = lane_sums_bounded && floor >= cr16_whole(s) && floor < cr16_whole(s) + 2 * MAX_TUPLES;
+    }
+    check(sums_bounded && sums_below > 0, "cr_add: the same bound, and the same gap");
+    check(lane_sums_bounded, "cr16_add of tagged lanes bounds the sum from below");
+
+    static CompactRational encoded[N];
+    for (int i = 0; i < N; i++) {
+        encoded[i] = cr_encode_optimal(i * 1000 + 7, 131 * 137 + i, NULL);
+    }
+    cr16_from_array(encoded, N, lanes);
+    int64_t lane_total = cr16_sum(lanes, N, &tagged), floors = 0;
+    for (int i = 0; i < N; i++) {
+        floors += value_floor(&encoded[i]);
+    }
+    check(floors >= lane_total && floors < lane_total + MAX_TUPLES * (int64_t)tagged,
+          "cr16_sum is within MAX_TUPLES per tagged lane below the floors");
+    printf("\n");
+
+    printf("=== 16-Bit Lane Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_lane();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// PACKED STORAGE TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool same_value(const CompactRational* a, const CompactRational* b) {
+    Rational ra = cr_to_rational(a);
+    Rational rb = cr_to_rational(b);
+    return ra.numerator == rb.numerator && ra.denominator == rb.denominator;
+}
+
+void test_packed() {
+    printf("=== Packed Storage Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Single value round trip and byte layout
+    printf("Test 1: Single value layout (7 1/3)\n");
+    CompactRational v = cr_from_fraction(22, 3, NULL);
+    uint8_t buf[CR_MAX_PACKED_SIZE];
+    size_t written = cr_pack(&v, buf, sizeof(buf));
+    check(written == 4, "7 1/3 packs into 4 bytes");
+    check(buf[0] == 0x07 && buf[1] == 0x80, "whole is little-endian with bit 15 set");
+    check(buf[2] == 0x81 && buf[3] == 43, "tuple is denominator byte then numerator");
+
+    CompactRational back;
+    check(cr_unpack(buf, written, &back) == 4, "unpack consumes 4 bytes");
+    check(memcmp(&back, &v, sizeof(v)) == 0, "round trip is bit-identical");
+    check(cr_unpack(buf, 3, &back) == 0, "truncated stream is rejected");
+    check(cr_pack(&v, buf, 3) == 0, "pack refuses a short buffer");
+    printf("\n");
+
+    // Test 2: Integers cost 2 bytes
+    printf("Test 2: Integer values\n");
+    CompactRational neg = cr_from_int(-100, NULL);
+    check(cr_pack(&neg, buf, sizeof(buf)) == 2, "-100 packs into 2 bytes");
+    check(cr_unpack(buf, 2, &back) == 2 && same_value(&back, &neg), "-100 round trips");
+    printf("\n");
+
+    // Test 3: Missing end flag is normalized on pack
+    printf("Test 3: End flag normalization\n");
+    CompactRational full;
+    cr_init(&full);
+    full.whole = (int16_t)0x8001;
+    for (int i = 0; i < MAX_TUPLES; i++) {
+        full.tuples[i] = (uint16_t)((1 << 8) | i);  // 1/(128+i), no end flag
+    }
+    written = cr_pack(&full, buf, sizeof(buf));
+    check(written == CR_MAX_PACKED_SIZE, "five tuples pack into 12 bytes");
+    check(cr_unpack(buf, written, &back) == written && same_value(&back, &full),
+          "value without end flag round trips");
+    printf("\n");
+
+    // Test 4: Column of mostly integers
+    printf("Test 4: Packed column footprint and random access\n");
+    enum { N = 10000 };
+    static CompactRational values[N];
+    for (int i = 0; i < N; i++) {
+        if (i % 10 == 3) {
+            values[i] = cr_from_fraction(2 * i + 1, 2, NULL);   // halves
+        } else if (i % 10 == 7) {
+            values[i] = cr_from_fraction(3 * i + 1, 3, NULL);   // thirds
+        } else {
+            values[i] = cr_from_int(i % 5000 - 2500, NULL);     // integers
+        }
+    }
+
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    check(cr_pack_array(values, N, &pa, &error) && error.code == CR_SUCCESS, "cr_pack_array succeeds");
+    check(pa.count == N, "count matches");
+    check(pa.size == (size_t)N * 2 + (size_t)(N / 5) * 2, "stream holds exactly 2+2n bytes per value");
+    printf("  Footprint: %zu bytes (%.2f bytes/value vs %zu in struct form)\n",
+           cr_packed_footprint(&pa), (double)cr_packed_footprint(&pa) / N, sizeof(CompactRational));
+
+    bool all_match = true;
+    for (int i = 0; i < N; i++) {
+        CompactRational got = cr_packed_get(&pa, (size_t)i, NULL);
+        if (!same_value(&got, &values[i])) all_match = false;
+    }
+    check(all_match, "cr_packed_get returns every value");
+
+    cr_packed_get(&pa, N, &error);
+    check(error.code == CR_ERROR_OUT_OF_BOUNDS, "out-of-range index reports CR_ERROR_OUT_OF_BOUNDS");
+    printf("\n");
+
+    // Test 5: Bulk unpack from the middle of a stride
+    printf("Test 5: Bulk unpack\n");
+    static CompactRational decoded[N];
+    size_t got = cr_unpack_array(&pa, 1000 + 37, 500, decoded, &error);
+    bool range_match = got == 500;
+    for (size_t i = 0; i < got; i++) {
+        if (!same_value(&decoded[i], &values[1037 + i])) range_match = false;
+    }
+    check(range_match && error.code == CR_SUCCESS, "500 values from index 1037 match");
+    got = cr_unpack_array(&pa, N - 10, 100, decoded, NULL);
+    check(got == 10, "range past the end is truncated");
+    printf("\n");
+
+    // Test 6: Appending one at a time matches the bulk path
+    printf("Test 6: Incremental append\n");
+    CRPackedArray inc;
+    cr_packed_init(&inc);
+    bool appended = true;
+    for (int i = 0; i < N; i++) {
+        if (!cr_packed_append(&inc, &values[i], NULL)) appended = false;
+    }
+    check(appended && inc.size == pa.size && memcmp(inc.data, pa.data, pa.size) == 0,
+          "incremental stream equals bulk stream");
+    cr_packed_free(&inc);
+    cr_packed_free(&pa);
+    check(pa.data == NULL && pa.count == 0, "free resets the array");
+    printf("\n");
+
+    printf("=== Packed Storage Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_packed();
+    return failures == 0 ? 0 : 1;
+}
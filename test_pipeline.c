@@ -0,0 +1,170 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PATH "test_pipeline.crcol"
+
+// ============================================================================
+// BULK CONVERSION TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+// Serial reference: cr_encode_optimal per pair, packed in one call
+static void reference_pack(const Rational* pairs, size_t n, CRPackedArray* out) {
+    CompactRational* values = malloc(n * sizeof(CompactRational));
+    for (size_t i = 0; i < n; i++) {
+        values[i] = cr_encode_optimal(pairs[i].numerator, pairs[i].denominator, NULL);
+    }
+    cr_packed_init(out);
+    cr_pack_array(values, n, out, NULL);
+    free(values);
+}
+
+static bool same_packed(const CRPackedArray* a, const CRPackedArray* b) {
+    return a->count == b->count && a->size == b->size && memcmp(a->data, b->data, a->size) == 0;
+}
+
+void test_pipeline() {
+    printf("=== Bulk Conversion Tests ===\n\n");
+    CRError error;
+
+    // Integers, small and large denominators, unreduced and negative pairs,
+    // over enough chunks to wrap the slot ring several times
+    enum { N = 25 * CR_PIPELINE_CHUNK + 123 };
+    Rational* pairs = malloc(N * sizeof(Rational));
+    uint64_t seed = 42;
+    for (size_t i = 0; i < N; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        int64_t num = (int64_t)(seed >> 40) - (1 << 23);
+        switch (i % 5) {
+            case 0: pairs[i] = (Rational){num % 16000, 1}; break;
+            case 1: pairs[i] = (Rational){num % 40000, 3 + (int64_t)(seed >> 60)}; break;
+            case 2: pairs[i] = (Rational){num % 30000 * 6, -12}; break;
+            case 3: pairs[i] = (Rational){num % 1000, 128 + (int64_t)(seed >> 57)}; break;
+            default: pairs[i] = (Rational){num * 1000003, INT64_C(251) * 253 * 1000003}; break;
+        }
+    }
+    CRPackedArray expected;
+    reference_pack(pairs, N, &expected);
+
+    // Test 1: Every thread count matches the serial conversion
+    printf("Test 1: Packed output\n");
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        CRPackedArray got;
+        cr_packed_init(&got);
+        size_t written = cr_pipeline_pack(pairs, N, threads, &got, &error);
+        char description[80];
+        snprintf(description, sizeof(description), "%d thread%s: bit for bit as cr_encode_optimal",
+                 threads, threads == 1 ? "" : "s");
+        check(written == N && error.code == CR_SUCCESS && same_packed(&got, &expected), description);
+        cr_packed_free(&got);
+    }
+    CRPackedArray appended;
+    cr_packed_init(&appended);
+    cr_pipeline_pack(pairs, 1000, 0, &appended, NULL);
+    cr_pipeline_pack(pairs + 1000, N - 1000, 0, &appended, NULL);
+    check(same_packed(&appended, &expected), "one thread per CPU; two calls append");
+    cr_packed_free(&appended);
+    printf("\n");
+
+    // Test 2: The file sink
+    printf("Test 2: Column file output\n");
+    CRFileWriter w;
+    bool opened = cr_file_writer_open(&w, PATH, 1000, NULL);
+    size_t written = cr_pipeline_write(pairs, N, 3, &w, &error);
+    check(opened && written == N && error.code == CR_SUCCESS && cr_file_writer_close(&w, NULL), "written and closed");
+    CRFile f;
+    bool same = cr_file_open(&f, PATH, CR_FILE_VERIFY, NULL) && cr_file_count(&f) == N;
+    for (size_t i = 0; same && i < N; i++) {
+        CompactRational a = cr_file_get(&f, i, NULL), b = cr_packed_get(&expected, i, NULL);
+        same = memcmp(&a, &b, sizeof(a)) == 0;
+    }
+    check(same, "file verifies and holds the same values");
+    if (same) cr_file_close(&f);
+    remove(PATH);
+    printf("\n");
+
+    // Test 3: The first failing row is reported, and every row converted
+    printf("Test 3: Errors\n");
+    Rational* bad = malloc(N * sizeof(Rational));
+    memcpy(bad, pairs, N * sizeof(Rational));
+    for (size_t i = 0; i < N; i++) {
+        if (i % 5 == 4) bad[i] = (Rational){i % 30000, 2};  // No inexact rows
+    }
+    bad[9 * CR_PIPELINE_CHUNK + 7] = (Rational){1, 1000003};
+    bad[17 * CR_PIPELINE_CHUNK] = (Rational){5, 0};
+    bad[3 * CR_PIPELINE_CHUNK + 1] = (Rational){INT64_C(1) << 40, 1};
+    CRPackedArray bad_expected;
+    reference_pack(bad, N, &bad_expected);
+    bool all_first = true, all_same = true;
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        CRPackedArray got;
+        cr_packed_init(&got);
+        cr_pipeline_pack(bad, N, threads, &got, &error);
+        all_first = all_first && error.code == CR_ERROR_VALUE_CLAMPED && error.value1 == INT32_MAX &&
+                    error.value2 == MAX_WHOLE_VALUE;
+        all_same = all_same && same_packed(&got, &bad_expected);
+        cr_packed_free(&got);
+    }
+    check(all_first, "earliest row wins: the clamp, not the later division by zero");
+    check(all_same, "failing rows still convert as cr_encode_optimal does");
+
+    cr_error_clear();
+    CRPackedArray got;
+    cr_packed_init(&got);
+    bad[3 * CR_PIPELINE_CHUNK + 1] = (Rational){7, 1};
+    cr_pipeline_pack(bad, N, 2, &got, &error);
+    check(error.code == CR_ERROR_INEXACT && error.value2 == MAX_TUPLES, "inexact row reported");
+    check(cr_error_flags() == (CR_ERROR_FLAG(CR_ERROR_INEXACT) | CR_ERROR_FLAG(CR_ERROR_DIVISION_BY_ZERO)),
+          "worker flags are merged into the caller's");
+    cr_packed_free(&got);
+
+    cr_error_clear();
+    cr_packed_init(&got);
+    cr_pipeline_pack(bad, N, 1, &got, NULL);
+    check(cr_error_flags() == (CR_ERROR_FLAG(CR_ERROR_INEXACT) | CR_ERROR_FLAG(CR_ERROR_DIVISION_BY_ZERO)),
+          "so are inline conversion's");
+    cr_packed_free(&got);
+    cr_packed_free(&bad_expected);
+    free(bad);
+    printf("\n");
+
+    // Test 4: Edge cases
+    printf("Test 4: Edge cases\n");
+    cr_packed_init(&got);
+    check(cr_pipeline_pack(pairs, 0, 4, &got, &error) == 0 && error.code == CR_SUCCESS && got.count == 0,
+          "no pairs");
+    Rational extremes[] = {{INT64_MIN, 2}, {INT64_MIN, 1}, {INT64_MAX, INT64_MAX}, {-3, -6}, {0, -5},
+                           {INT64_MIN, -1}, {INT64_MIN, INT64_MIN}};
+    size_t count = sizeof(extremes) / sizeof(extremes[0]);
+    CRPackedArray extremes_expected;
+    reference_pack(extremes, count, &extremes_expected);
+    cr_pipeline_pack(extremes, count, 8, &got, &error);
+    check(same_packed(&got, &extremes_expected) && error.code == CR_ERROR_VALUE_CLAMPED,
+          "extreme numerators, negative denominators, more threads than chunks");
+    CompactRational flipped = cr_packed_get(&got, 5, NULL);
+    CompactRational one = cr_packed_get(&got, 6, NULL);
+    check(cr_to_rational(&flipped).numerator == MAX_WHOLE_VALUE && cr_to_rational(&one).numerator == 1 &&
+          cr_to_rational(&one).denominator == 1, "INT64_MIN/-1 clamps to +16383, INT64_MIN/INT64_MIN is 1");
+    cr_pipeline_pack(extremes + 5, 1, 1, &got, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED, "and reports the clamp");
+    cr_packed_free(&got);
+    cr_packed_free(&extremes_expected);
+    printf("\n");
+
+    cr_packed_free(&expected);
+    free(pairs);
+    printf("=== Bulk Conversion Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_pipeline();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// SORT, TOP-K AND HISTOGRAM TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+// Raw single-tuple value whole + num/(128 + offset), possibly non-canonical
+static CompactRational raw_tuple(int whole, int num, int offset) {
+    CompactRational cr;
+    cr_init(&cr);
+    cr.whole = (int16_t)(0x8000 | (whole & 0x7FFF));
+    cr.tuples[0] = (uint16_t)((num << 8) | 0x80 | offset);
+    return cr;
+}
+
+static uint32_t rng_state = 12345;
+
+static uint32_t next_random(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 8;
+}
+
+// A mix of integers, single tuples, multi-tuple fractions and raw encodings
+static CompactRational random_value(void) {
+    int whole = (int)(next_random() % 2001) - 1000;
+    switch (next_random() % 4) {
+        case 0: return cr_from_int(whole, NULL);
+        case 1: return cr_from_fraction(whole * 7 + (int)(next_random() % 7), 7, NULL);
+        case 2: return cr_encode_optimal((int64_t)whole * 30031 + next_random() % 30031, 30031, NULL);
+        default: return raw_tuple(whole, (int)(next_random() % 256), (int)(next_random() % 128));
+    }
+}
+
+// order is a permutation sorted by value, equal values by index
+static bool is_stable_order(const CompactRational* values, const size_t* order, size_t n) {
+    bool* seen = calloc(n, sizeof(bool));
+    bool ok = true;
+    for (size_t i = 0; i < n && ok; i++) {
+        if (order[i] >= n || seen[order[i]]) {
+            ok = false;
+            break;
+        }
+        seen[order[i]] = true;
+        if (i > 0) {
+            int c = cr_cmp(&values[order[i - 1]], &values[order[i]]);
+            if (c > 0 || (c == 0 && order[i - 1] > order[i])) ok = false;
+        }
+    }
+    free(seen);
+    return ok;
+}
+
+void test_sort() {
+    printf("=== Sort, Top-k and Histogram Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Keys preserve order
+    printf("Test 1: Sort keys\n");
+    enum { KEYS = 20000 };
+    static CompactRational sample[KEYS];
+    for (int i = 0; i < KEYS; i++) {
+        sample[i] = random_value();
+    }
+    bool monotone = true;
+    for (int i = 1; i < KEYS; i++) {
+        int c = cr_cmp(&sample[i - 1], &sample[i]);
+        uint64_t ka = cr_sort_key(&sample[i - 1]), kb = cr_sort_key(&sample[i]);
+        if ((c < 0 && ka > kb) || (c > 0 && ka < kb) || (c == 0 && ka != kb)) monotone = false;
+    }
+    check(monotone, "a < b implies key(a) <= key(b); equal values share a key");
+    CompactRational three = cr_from_int(3, NULL), raw_three = raw_tuple(2, 128, 0);
+    check(cr_sort_key(&three) == cr_sort_key(&raw_three), "2 + 128/128 has the key of 3");
+    CompactRational lo = cr_from_int(MIN_WHOLE_VALUE, NULL), hi = raw_tuple(MAX_WHOLE_VALUE, 255, 0);
+    check(cr_sort_key(&lo) == (uint64_t)1 << 40 && cr_sort_key(&hi) < (uint64_t)1 << 56,
+          "keys of the whole range fit 56 bits");
+    printf("\n");
+
+    // Test 2: Mixed column
+    printf("Test 2: Sort a mixed column\n");
+    enum { N = 100000 };
+    static CompactRational values[N];
+    static size_t order[N];
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    for (int i = 0; i < N; i++) {
+        values[i] = (i % 10 == 0) ? values[i / 2] : random_value();  // Plenty of repeats
+    }
+    cr_pack_array(values, N, &pa, NULL);
+    check(cr_sort(&pa, order, &error) && error.code == CR_SUCCESS, "sort succeeds");
+    check(is_stable_order(values, order, N), "100000 values in exact, stable order");
+    cr_packed_free(&pa);
+    printf("\n");
+
+    // Test 3: Values closer than the key resolution
+    printf("Test 3: Exact tie breaking\n");
+    const int64_t d1 = 251LL * 253 * 254 * 255 * 239, d2 = 251LL * 253 * 254 * 255 * 241;
+    CompactRational close[4];
+    close[0] = cr_encode_optimal(1, d1, &error);  // Larger
+    bool exact = error.code == CR_SUCCESS;
+    close[1] = cr_encode_optimal(1, d2, &error);
+    exact = exact && error.code == CR_SUCCESS;
+    close[2] = close[0];
+    close[3] = close[1];
+    check(exact && cr_sort_key(&close[0]) == cr_sort_key(&close[1]) && cr_cmp(&close[0], &close[1]) > 0,
+          "1/d1 and 1/d2 differ but share a key");
+    cr_packed_init(&pa);
+    cr_pack_array(close, 4, &pa, NULL);
+    size_t close_order[4];
+    cr_sort(&pa, close_order, NULL);
+    check(close_order[0] == 1 && close_order[1] == 3 && close_order[2] == 0 && close_order[3] == 2,
+          "cr_cmp orders the tied run: 1, 3, 0, 2");
+    cr_packed_free(&pa);
+    printf("\n");
+
+    // Test 4: Integer column with duplicates and non-canonical encodings
+    printf("Test 4: Integer column\n");
+    cr_packed_init(&pa);
+    for (int i = 0; i < N; i++) {
+        values[i] = (i % 3 == 0) ? raw_tuple((i % 50) - 26, 128, 0) : cr_from_int((i % 50) - 25, NULL);
+    }
+    cr_pack_array(values, N, &pa, NULL);
+    check(cr_sort(&pa, order, NULL) && is_stable_order(values, order, N),
+          "equal integers keep index order across encodings");
+    cr_packed_free(&pa);
+    printf("\n");
+
+    // Test 5: Top-k
+    printf("Test 5: Top-k\n");
+    cr_packed_init(&pa);
+    for (int i = 0; i < N; i++) {
+        values[i] = (i % 10 == 0) ? values[i / 2] : random_value();
+    }
+    cr_pack_array(values, N, &pa, NULL);
+    cr_sort(&pa, order, NULL);
+    size_t top[100];
+    check(cr_topk(&pa, 100, top, &error) == 100 && error.code == CR_SUCCESS, "returns 100 indices");
+    bool matches = true;
+    for (int i = 0; i < 100; i++) {
+        int c = i > 0 ? cr_cmp(&values[top[i - 1]], &values[top[i]]) : 1;
+        if (c < 0 || (c == 0 && top[i - 1] > top[i])) matches = false;
+        if (cr_cmp(&values[top[i]], &values[order[N - 1 - i]]) != 0) matches = false;
+    }
+    check(matches, "largest first, the same values as the tail of the sort");
+    check(cr_topk(&pa, 0, top, NULL) == 0, "k = 0 returns nothing");
+    cr_packed_free(&pa);
+
+    cr_packed_init(&pa);
+    cr_pack_array(close, 4, &pa, NULL);
+    check(cr_topk(&pa, 10, top, NULL) == 4 && top[0] == 0 && top[1] == 2 && top[2] == 1 && top[3] == 3,
+          "k > count: all values, ties by index");
+    cr_packed_free(&pa);
+    printf("\n");
+
+    // Test 6: Histogram
+    printf("Test 6: Histogram\n");
+    cr_packed_init(&pa);
+    cr_pack_array(values, N, &pa, NULL);
+    CompactRational edges[5] = {
+        cr_from_int(-500, NULL), cr_from_fraction(-1, 3, NULL), cr_from_int(0, NULL),
+        cr_from_fraction(1001, 7, NULL), cr_from_int(800, NULL)
+    };
+    uint64_t counts[4], expected[4] = {0, 0, 0, 0};
+    size_t in_range = 0;
+    for (int i = 0; i < N; i++) {
+        for (int b = 0; b < 4; b++) {
+            if (cr_cmp(&values[i], &edges[b]) >= 0 && cr_cmp(&values[i], &edges[b + 1]) < 0) {
+                expected[b]++;
+                in_range++;
+            }
+        }
+    }
+    size_t binned = cr_histogram(&pa, edges, 4, counts, &error);
+    check(binned == in_range && error.code == CR_SUCCESS, "binned count matches brute force");
+    check(memcmp(counts, expected, sizeof(counts)) == 0, "per-bin counts match brute force");
+    cr_packed_free(&pa);
+
+    CompactRational on_edges[3] = {raw_tuple(-1, 128, 0), close[1], close[0]};  // 0, 1/d2, 1/d1
+    CompactRational tight[3] = {cr_from_int(0, NULL), close[0], cr_from_int(1, NULL)};
+    cr_packed_init(&pa);
+    cr_pack_array(on_edges, 3, &pa, NULL);
+    cr_histogram(&pa, tight, 2, counts, NULL);
+    check(counts[0] == 2 && counts[1] == 1, "edges are inclusive below, exact at equal keys");
+    cr_packed_free(&pa);
+    printf("\n");
+
+    // Test 7: Malformed stream
+    printf("Test 7: Malformed stream\n");
+    cr_packed_init(&pa);
+    cr_pack_array(close, 4, &pa, NULL);
+    pa.count = 5;  // Claims a value the stream does not hold
+    check(!cr_sort(&pa, close_order, &error) && error.code == CR_ERROR_INVALID_ENCODING && error.value1 == 4,
+          "cr_sort reports the first unreadable index");
+    check(cr_topk(&pa, 2, top, &error) == 0 && error.code == CR_ERROR_INVALID_ENCODING,
+          "cr_topk reports it too");
+    check(cr_histogram(&pa, tight, 2, counts, &error) == 4 && error.code == CR_ERROR_INVALID_ENCODING,
+          "cr_histogram keeps the counts up to the bad value");
+    pa.count = 4;
+    cr_packed_free(&pa);
+    printf("\n");
+
+    printf("=== Sort, Top-k and Histogram Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_sort();
+    return failures == 0 ? 0 : 1;
+}
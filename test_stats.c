@@ -0,0 +1,137 @@
+#include "compact_rational.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// STATISTICS TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+// Counter growth since an earlier snapshot
+static uint64_t delta(const CRStats* before, CRStatCounter counter) {
+    CRStats now = cr_stats_snapshot();
+    return now.counters[counter] - before->counters[counter];
+}
+
+static void* fraction_worker(void* arg) {
+    (void)arg;
+    for (int i = 1; i <= 1000; i++) {
+        cr_from_fraction(1, 1000 + i, NULL);
+    }
+    return NULL;
+}
+
+void test_stats() {
+    printf("=== Statistics Tests ===\n\n");
+    CRStats before = cr_stats_snapshot();
+
+    if (!before.enabled) {
+        // Test 1: Without CR_ENABLE_STATS the hooks compile away
+        printf("Test 1: Disabled build (rebuild with make STATS=1 for the full suite)\n");
+        CompactRational a = cr_from_fraction(1, 1000, NULL), b = cr_from_fraction(1, 7, NULL);
+        cr_add(&a, &b, NULL);
+        cr_to_rational(&a);
+        CRStats after = cr_stats_snapshot();
+        CRStats zero;
+        memset(&zero, 0, sizeof(zero));
+        check(memcmp(&after, &zero, sizeof(zero)) == 0, "snapshots read zero");
+        printf("\n");
+        printf("=== Statistics Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+        return;
+    }
+
+    // Test 1: Encoding outcomes
+    printf("Test 1: cr_from_fraction\n");
+    cr_from_fraction(1, 3, NULL);
+    cr_from_fraction(5, 255, NULL);
+    check(delta(&before, CR_STAT_FROM_FRACTION) == 2 && delta(&before, CR_STAT_FROM_FRACTION_LOSSY) == 0,
+          "exact denominators counted, not lossy");
+    cr_from_fraction(1, 1000, NULL);
+    check(delta(&before, CR_STAT_FROM_FRACTION) == 3 && delta(&before, CR_STAT_FROM_FRACTION_LOSSY) == 1,
+          "denominator 1000 takes the lossy branch");
+    printf("\n");
+
+    // Test 2: Addition paths
+    printf("Test 2: cr_add\n");
+    before = cr_stats_snapshot();
+    CompactRational third = cr_from_fraction(1, 3, NULL), seventh = cr_from_fraction(1, 7, NULL);
+    CompactRational two = cr_from_int(2, NULL);
+    cr_add(&two, &third, NULL);
+    cr_add(&third, &third, NULL);
+    check(delta(&before, CR_STAT_ADD) == 2 && delta(&before, CR_STAT_ADD_SLOW) == 0, "fast paths");
+    cr_add(&third, &seventh, NULL);
+    cr_sub(&third, &seventh, NULL);
+    CRStats after = cr_stats_snapshot();
+    uint64_t timed = 0;
+    for (int i = 0; i < CR_STATS_CYCLE_BUCKETS; i++) {
+        timed += after.add_slow_cycles[i] - before.add_slow_cycles[i];
+    }
+    check(delta(&before, CR_STAT_ADD) == 4 && delta(&before, CR_STAT_ADD_SLOW) == 2 && timed == 2,
+          "different denominators take the timed 128-bit path, cr_sub included");
+    before = after;
+    CompactRational two_tuples = cr_encode_optimal(1, 251LL * 253, NULL);
+    cr_sub(&third, &two_tuples, NULL);
+    after = cr_stats_snapshot();
+    timed = 0;
+    for (int i = 0; i < CR_STATS_CYCLE_BUCKETS; i++) {
+        timed += after.add_slow_cycles[i] - before.add_slow_cycles[i];
+    }
+    check(delta(&before, CR_STAT_ADD) == 1 && delta(&before, CR_STAT_ADD_SLOW) == 1 && timed == 1,
+          "cr_sub of a multi-tuple value counts its direct 128-bit path");
+    printf("\n");
+
+    // Test 3: Clamps and approximations
+    printf("Test 3: Clamps\n");
+    before = cr_stats_snapshot();
+    cr_from_int(100000, NULL);
+    check(delta(&before, CR_STAT_CLAMPED) == 1 && delta(&before, CR_STAT_ADD_CLAMPED) == 0, "cr_from_int clamp");
+    CompactRational top = cr_from_int(MAX_WHOLE_VALUE, NULL);
+    cr_add(&top, &top, NULL);
+    check(delta(&before, CR_STAT_CLAMPED) == 2 && delta(&before, CR_STAT_ADD_CLAMPED) == 1, "cr_add clamp");
+    cr_encode_optimal(1, 1000003, NULL);
+    check(delta(&before, CR_STAT_INEXACT) == 1, "inexact encoding");
+    printf("\n");
+
+    // Test 4: Decode depth
+    printf("Test 4: cr_to_rational depth\n");
+    before = cr_stats_snapshot();
+    CompactRational pair = cr_encode_optimal(1, 17947, NULL);
+    cr_to_rational(&two);
+    cr_to_rational(&third);
+    cr_to_rational(&third);
+    cr_to_rational(&pair);
+    after = cr_stats_snapshot();
+    check(after.to_rational_depth[0] - before.to_rational_depth[0] == 1 &&
+          after.to_rational_depth[1] - before.to_rational_depth[1] == 2 &&
+          after.to_rational_depth[2] - before.to_rational_depth[2] == 1, "one call per tuples walked");
+    printf("\n");
+
+    // Test 5: Threads that exit still count
+    printf("Test 5: Threads\n");
+    before = cr_stats_snapshot();
+    enum { THREADS = 4 };
+    pthread_t ids[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        pthread_create(&ids[t], NULL, fraction_worker, NULL);
+    }
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    check(delta(&before, CR_STAT_FROM_FRACTION) == THREADS * 1000 &&
+          delta(&before, CR_STAT_FROM_FRACTION_LOSSY) == THREADS * 1000, "counts of exited threads are kept");
+    printf("\n");
+
+    printf("=== Statistics Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_stats();
+    return failures == 0 ? 0 : 1;
+}
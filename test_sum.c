@@ -0,0 +1,179 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================================
+// COLUMN SUM TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool equals_fraction(const CompactRational* cr, int64_t num, int64_t denom) {
+    Rational expected = {num, denom};
+    reduce_rational(&expected);
+    Rational got = cr_to_rational(cr);
+    return got.numerator == expected.numerator && got.denominator == expected.denominator;
+}
+
+// Raw single-tuple value whole + num/(128 + offset)
+static CompactRational raw_tuple(int whole, int num, int offset) {
+    CompactRational cr;
+    cr_init(&cr);
+    cr.whole = (int16_t)(0x8000 | (whole & 0x7FFF));
+    cr.tuples[0] = (uint16_t)((num << 8) | 0x80 | offset);
+    return cr;
+}
+
+void test_sum() {
+    printf("=== Column Sum Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Empty column
+    printf("Test 1: Empty column\n");
+    CompactRational sum = cr_sum_parallel(NULL, 0, 4, &error);
+    check(equals_fraction(&sum, 0, 1) && error.code == CR_SUCCESS, "sum of nothing is 0");
+    printf("\n");
+
+    // Test 2: Intermediate totals far outside the 15-bit range
+    printf("Test 2: No intermediate clamping\n");
+    enum { N = 200000 };
+    static CompactRational values[N];
+    static const int32_t tail_num[4] = {-27999, -28001, -41999, -42001};
+    static const int32_t tail_den[4] = {2, 2, 3, 3};
+    for (int i = 0; i < N; i++) {
+        if (i < N / 2) {
+            values[i] = cr_from_int(i % 2 ? 16000 : 12000, NULL);
+        } else {
+            values[i] = cr_from_fraction(tail_num[i % 4], tail_den[i % 4], NULL);  // -14000 +- 1/2, 1/3
+        }
+    }
+    values[0] = cr_from_fraction(96005, 8, NULL);  // 12000 5/8
+    // Exact total: 50000 * 28000 - 100000 * 14000 + 5/8
+    sum = cr_sum_parallel(values, N, 4, &error);
+    check(error.code == CR_SUCCESS, "no error reported");
+    check(equals_fraction(&sum, 5, 8), "total matches exact rational sum (5/8)");
+
+    CompactRational serial = cr_from_int(0, NULL);
+    for (int i = 0; i < N; i++) {
+        serial = cr_add(&serial, &values[i], NULL);
+    }
+    printf("  Serial cr_add chain gives %.4f, parallel sum gives %.4f\n",
+           cr_to_double(&serial, NULL), cr_to_double(&sum, NULL));
+    printf("\n");
+
+    // Test 3: Thread count does not change the result
+    printf("Test 3: Thread counts\n");
+    bool identical = true;
+    int counts[] = {1, 2, 3, 7, 0, -1};
+    for (size_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+        CompactRational other = cr_sum_parallel(values, N, counts[k], NULL);
+        if (memcmp(&other, &sum, sizeof(sum)) != 0) identical = false;
+    }
+    check(identical, "1, 2, 3, 7 and auto threads are bit-identical");
+    printf("\n");
+
+    // Test 4: Equal fractions on different denominators merge
+    printf("Test 4: Canonical merging\n");
+    CompactRational pair[2] = {raw_tuple(0, 64, 0), raw_tuple(0, 75, 22)};  // 64/128 + 75/150
+    sum = cr_sum_parallel(pair, 2, 1, &error);
+    check(equals_fraction(&sum, 1, 1) && cr_size(&sum) == 2, "64/128 + 75/150 = 1 with no tuple");
+    pair[0] = cr_from_fraction(1, 3, NULL);
+    pair[1] = cr_from_fraction(1, 6, NULL);
+    sum = cr_sum_parallel(pair, 2, 1, &error);
+    check(equals_fraction(&sum, 1, 2) && sum.tuples[0] == (uint16_t)((64 << 8) | 0x80),
+          "1/3 + 1/6 = 64/128");
+    printf("\n");
+
+    // Test 5: Final whole part out of range
+    printf("Test 5: Final clamping\n");
+    for (int i = 0; i < 20000; i++) {
+        values[i] = cr_from_int(16000, NULL);
+    }
+    sum = cr_sum_parallel(values, 20000, 2, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && error.value1 == 320000000, "clamp reports the exact total");
+    check(equals_fraction(&sum, MAX_WHOLE_VALUE, 1), "result clamps to MAX_WHOLE_VALUE");
+    printf("\n");
+
+    // Test 6: More distinct denominators than tuples
+    printf("Test 6: Too many tuples\n");
+    int primes[] = {131, 137, 139, 149, 151, 157};
+    double expected = 0.0;
+    for (int i = 0; i < 6; i++) {
+        values[i] = raw_tuple(0, 1, primes[i] - MIN_DENOMINATOR);
+        expected += 1.0 / primes[i];
+    }
+    sum = cr_sum_parallel(values, 6, 1, &error);
+    check(error.code == CR_ERROR_TUPLE_BOUNDS && error.value1 == 6, "CR_ERROR_TUPLE_BOUNDS with tuple count");
+    check(cr_size(&sum) <= 2 + 2 * MAX_TUPLES, "result fits MAX_TUPLES");
+    check(fabs(cr_to_double(&sum, NULL) - expected) < 1e-4, "approximation stays close");
+    for (int i = 0; i < 6; i++) {
+        values[i] = raw_tuple(0, 1, i);
+    }
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        sum = cr_sum_parallel(values, 6, threads, &error);
+        char description[80];
+        snprintf(description, sizeof(description), "1/128 + ... + 1/133 is exact on five tuples, %d thread%s",
+                 threads, threads == 1 ? "" : "s");
+        check(error.code == CR_SUCCESS && equals_fraction(&sum, 3152989591LL, 68565777280LL) &&
+              cr_size(&sum) == 2 + 2 * MAX_TUPLES, description);
+    }
+    printf("\n");
+
+    // Test 7: Weighted sums
+    printf("Test 7: cr_weighted_sum\n");
+    CompactRational weights[4] = {
+        cr_from_fraction(1, 3, NULL), cr_from_fraction(1, 4, NULL),
+        cr_from_fraction(1, 6, NULL), cr_from_fraction(1, 4, NULL)
+    };
+    CompactRational scores[4] = {
+        cr_from_int(90, NULL), cr_from_fraction(171, 2, NULL), cr_from_int(72, NULL), cr_from_fraction(387, 4, NULL)
+    };
+    sum = cr_weighted_sum(weights, scores, 4, &error);
+    // 90/3 + 171/8 + 72/6 + 387/16 = 30 + 12 + 21.375 + 24.1875
+    check(error.code == CR_SUCCESS && equals_fraction(&sum, 1401, 16), "grade: 87 9/16");
+    sum = cr_weighted_sum(NULL, NULL, 0, &error);
+    check(error.code == CR_SUCCESS && equals_fraction(&sum, 0, 1), "no pairs is 0");
+
+    enum { W = 100000 };
+    static CompactRational wcol[W], scol[W];
+    const int64_t wn[6] = {1, 1, 1, 1, 3, 2}, wd[6] = {3, 4, 6, 5, 8, 7};
+    const int64_t lw = 840, ls = 4;
+    int64_t ref = 0, ref400 = 0;
+    for (int i = 0; i < W; i++) {
+        if (i == 400) ref400 = ref;
+        int k = (i * 7) % 6;
+        int64_t sn = (i * 37) % 401 - 100, sd = (int64_t)1 << (i % 3);  // -100..300 in halves and quarters
+        wcol[i] = cr_from_fraction((int32_t)wn[k], (int32_t)wd[k], NULL);
+        scol[i] = cr_from_fraction((int32_t)(sn * sd + i % 2), (int32_t)sd, NULL);
+        ref += wn[k] * (lw / wd[k]) * (sn * sd + i % 2) * (ls / sd);
+    }
+    CompactRational ws = cr_weighted_sum(wcol, scol, 400, &error);
+    check(error.code == CR_SUCCESS && equals_fraction(&ws, ref400, lw * ls), "400 mixed pairs match exact arithmetic");
+    ws = cr_weighted_sum(wcol, scol, W, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && error.value1 == (int32_t)(ref / (lw * ls)),
+          "100000 pairs: exact total reported when clamped");
+
+    for (int i = 0; i < 6; i++) {
+        wcol[i] = raw_tuple(0, 1, primes[i] - MIN_DENOMINATOR);
+        scol[i] = cr_from_int(i + 1, NULL);
+    }
+    ws = cr_weighted_sum(wcol, scol, 6, &error);
+    double wexpected = 0.0;
+    for (int i = 0; i < 6; i++) wexpected += (i + 1.0) / primes[i];
+    check(error.code == CR_ERROR_INEXACT && fabs(cr_to_double(&ws, NULL) - wexpected) < 1e-4,
+          "six prime denominators: approximated and reported");
+    printf("\n");
+
+    printf("=== Column Sum Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_sum();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// TEXT PARSING AND FORMATTING TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool equals_fraction(const CompactRational* cr, int64_t num, int64_t denom) {
+    Rational expected = {num, denom};
+    reduce_rational(&expected);
+    Rational got = cr_to_rational(cr);
+    return got.numerator == expected.numerator && got.denominator == expected.denominator;
+}
+
+static bool parses_to(const char* text, int64_t num, int64_t denom) {
+    CompactRational cr;
+    CRError error;
+    size_t used = cr_parse(text, strlen(text), &cr, &error);
+    return used == strlen(text) && error.code == CR_SUCCESS && equals_fraction(&cr, num, denom);
+}
+
+static bool formats_as(const CompactRational* cr, uint32_t flags, const char* expected) {
+    char buf[CR_FORMAT_MAX];
+    size_t n = cr_format(buf, sizeof(buf), cr, flags);
+    return n == strlen(expected) && strcmp(buf, expected) == 0;
+}
+
+void test_text() {
+    printf("=== Text Parsing and Formatting Tests ===\n\n");
+    CRError error;
+    CompactRational cr;
+
+    // Test 1: Single values
+    printf("Test 1: cr_parse forms\n");
+    check(parses_to("7", 7, 1) && parses_to("-12", -12, 1) && parses_to("+3", 3, 1), "integers");
+    check(parses_to("22/3", 22, 3) && parses_to("-1/3", -1, 3), "fractions");
+    check(parses_to("7 1/3", 22, 3) && parses_to("-7 1/3", -22, 3) && parses_to("7\t 1/3", 22, 3),
+          "mixed numbers (sign applies to the whole)");
+    check(parses_to("0.5", 1, 2) && parses_to("-2.25", -9, 4) && parses_to(".75", 3, 4), "decimals");
+    check(cr_parse("  5 apples", 10, &cr, NULL) == 3 && equals_fraction(&cr, 5, 1),
+          "stops after the number; leading blanks skipped");
+    check(cr_parse("7 8", 3, &cr, NULL) == 1, "\"7 8\" is the integer 7");
+    check(cr_parse("abc", 3, &cr, &error) == 0 && error.code == CR_ERROR_SYNTAX, "syntax error reported");
+    check(cr_parse("1/0", 3, &cr, &error) == 0 && error.code == CR_ERROR_SYNTAX, "zero denominator rejected");
+    check(cr_parse("5.", 2, &cr, &error) == 0 && cr_parse("1234567890123456789", 19, &cr, NULL) == 0,
+          "\"5.\" and 19-digit runs rejected");
+    cr_parse("20000", 5, &cr, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && equals_fraction(&cr, MAX_WHOLE_VALUE, 1), "clamping reported");
+    cr_parse("0.123456789", 11, &cr, &error);
+    check(error.code == CR_ERROR_INEXACT, "decimal needing 5^9 reported inexact");
+    printf("\n");
+
+    // Test 2: Formatting
+    printf("Test 2: cr_format\n");
+    CompactRational third = cr_from_fraction(22, 3, NULL), neg = cr_from_fraction(-22, 3, NULL);
+    CompactRational small = cr_from_fraction(-1, 3, NULL), integer = cr_from_int(-42, NULL);
+    check(formats_as(&third, 0, "7 1/3") && formats_as(&neg, 0, "-7 1/3"), "mixed numbers");
+    check(formats_as(&small, 0, "-1/3") && formats_as(&integer, 0, "-42"), "proper fractions and integers");
+    check(formats_as(&third, CR_FORMAT_IMPROPER, "22/3") && formats_as(&neg, CR_FORMAT_IMPROPER, "-22/3"),
+          "CR_FORMAT_IMPROPER");
+    char tiny[4];
+    check(cr_format(tiny, sizeof(tiny), &third, 0) == 5 && strcmp(tiny, "7 1") == 0,
+          "truncates like snprintf and returns the full length");
+    printf("\n");
+
+    // Test 3: Round trip
+    printf("Test 3: Format/parse round trip\n");
+    bool round_trip = true;
+    for (int64_t d = 1; d < 3000 && round_trip; d += 7) {
+        for (int64_t n = -3 * d; n <= 3 * d; n += d / 3 + 1) {
+            CompactRational v = cr_encode_optimal(n * 1000 + 1, d * 1000, NULL);
+            char buf[64];
+            for (uint32_t flags = 0; flags <= CR_FORMAT_IMPROPER; flags++) {
+                size_t len = cr_format(buf, sizeof(buf), &v, flags);
+                CompactRational back;
+                if (cr_parse(buf, len, &back, NULL) != len || cr_cmp(&back, &v) != 0) round_trip = false;
+            }
+        }
+    }
+    check(round_trip, "every formatted value parses back to the same value");
+    printf("\n");
+
+    // Test 4: Delimited fields
+    printf("Test 4: cr_parse_array\n");
+    const char* csv = "1,-2, 7 1/3 ,0.5\r\n12345678,22/3\n\n-40000\n";
+    CompactRational values[16];
+    size_t consumed;
+    size_t n = cr_parse_array(csv, strlen(csv), ',', true, values, 16, &consumed, &error);
+    check(n == 7 && consumed == strlen(csv), "7 fields, blank line and CR LF handled");
+    check(equals_fraction(&values[0], 1, 1) && equals_fraction(&values[1], -2, 1) &&
+          equals_fraction(&values[2], 22, 3) && equals_fraction(&values[3], 1, 2) &&
+          equals_fraction(&values[5], 22, 3), "values decoded");
+    check(error.code == CR_ERROR_VALUE_CLAMPED && error.value1 == 12345678 &&
+          equals_fraction(&values[6], MIN_WHOLE_VALUE, 1), "first clamped value reported, parsing continued");
+
+    n = cr_parse_array("1,2,,3", 6, ',', true, values, 16, &consumed, &error);
+    check(n == 2 && error.code == CR_ERROR_SYNTAX && error.value1 == 2 && error.value2 == 4,
+          "empty field: syntax error at field 2, byte 4");
+    n = cr_parse_array("1,x2,3", 6, ',', true, values, 16, &consumed, &error);
+    check(n == 1 && consumed == 2 && error.code == CR_ERROR_SYNTAX && error.value1 == 1, "bad field stops parsing");
+    n = cr_parse_array("1,2,3,4", 7, ',', true, values, 3, &consumed, NULL);
+    check(n == 3 && consumed == 6, "stops when out is full");
+    printf("\n");
+
+    // Test 5: Streaming across buffer boundaries
+    printf("Test 5: Streaming\n");
+    char text[4096];
+    size_t len = 0;
+    enum { FIELDS = 300 };
+    static CompactRational expected[FIELDS];
+    for (int i = 0; i < FIELDS; i++) {
+        expected[i] = (i % 3 == 0) ? cr_from_int(i * 37 - 5000, NULL) : cr_from_fraction(i * 13 - 1900, 7 + i % 11, NULL);
+        len += cr_format(text + len, sizeof(text) - len, &expected[i], 0);
+        text[len++] = (i % 10 == 9) ? '\n' : '\t';
+    }
+    len--;  // No separator after the last field
+    bool streamed = true;
+    for (size_t split = 1; split < len; split += 13) {
+        static CompactRational got[FIELDS];
+        size_t head_used;
+        size_t head = cr_parse_array(text, split, '\t', false, got, FIELDS, &head_used, NULL);
+        size_t tail = cr_parse_array(text + head_used, len - head_used, '\t', true, got + head, FIELDS - head,
+                                     NULL, &error);
+        if (head + tail != FIELDS || error.code != CR_SUCCESS) streamed = false;
+        for (int i = 0; i < FIELDS && streamed; i++) {
+            if (cr_cmp(&got[i], &expected[i]) != 0) streamed = false;
+        }
+    }
+    check(streamed, "any split point yields the same 300 values");
+    printf("\n");
+
+    // Test 6: Straight to packed form
+    printf("Test 6: cr_parse_packed\n");
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    check(cr_parse_packed(text, len, '\t', true, &pa, &consumed, &error) && error.code == CR_SUCCESS,
+          "parse succeeds");
+    bool packed_ok = pa.count == FIELDS && consumed == len;
+    for (int i = 0; i < FIELDS && packed_ok; i++) {
+        CompactRational v = cr_packed_get(&pa, (size_t)i, NULL);
+        if (cr_cmp(&v, &expected[i]) != 0) packed_ok = false;
+    }
+    check(packed_ok, "300 values appended in order");
+    check(!cr_parse_packed("1,2,oops", 8, ',', true, &pa, &consumed, &error) && error.code == CR_ERROR_SYNTAX &&
+          pa.count == FIELDS + 2, "values before a syntax error are kept");
+    cr_packed_free(&pa);
+    printf("\n");
+
+    // Test 7: Decimal and encoding forms
+    printf("Test 7: cr_format flags\n");
+    CompactRational half = cr_from_fraction(-1, 2, NULL), tiny_neg = cr_encode_optimal(-1, 255 * 254 * 253, NULL);
+    check(formats_as(&third, CR_FORMAT_DECIMAL, "7 1/3 (7.333333)") &&
+          formats_as(&neg, CR_FORMAT_DECIMAL | CR_FORMAT_IMPROPER, "-22/3 (-7.333333)"), "CR_FORMAT_DECIMAL");
+    check(formats_as(&half, CR_FORMAT_FIXED, "-0.500000") && formats_as(&integer, CR_FORMAT_FIXED, "-42.000000") &&
+          formats_as(&tiny_neg, CR_FORMAT_FIXED, "-0.000000"), "CR_FORMAT_FIXED");
+    check(formats_as(&third, CR_FORMAT_ENCODING, "Encoding: whole=0x8007 (bit15=1) [43/129(end)]") &&
+          formats_as(&integer, CR_FORMAT_ENCODING, "Encoding: whole=0x7FD6 (bit15=0)"), "CR_FORMAT_ENCODING");
+    bool like_printf = true;
+    for (int i = 0; i < 20000 && like_printf; i++) {
+        int64_t d = 1001 + 2 * (i % 499);  // Prime to 10, so no exact ties
+        if (d % 5 == 0) continue;
+        CompactRational v = cr_encode_optimal((int64_t)i * 7919 - 80000000, d, NULL);
+        char ours[CR_FORMAT_MAX], theirs[CR_FORMAT_MAX];
+        cr_format(ours, sizeof(ours), &v, CR_FORMAT_FIXED);
+        snprintf(theirs, sizeof(theirs), "%.6f", cr_to_double(&v, NULL));
+        if (strcmp(ours, theirs) != 0) like_printf = false;
+    }
+    check(like_printf, "CR_FORMAT_FIXED matches printf(\"%.6f\") away from ties");
+    CompactRational longest;
+    cr_init(&longest);
+    longest.whole = (int16_t)0xC001;  // -16383 with tuples
+    for (int i = 0; i < MAX_TUPLES; i++) {
+        longest.tuples[i] = (uint16_t)((255 - i) << 8 | (127 - i));
+    }
+    longest.tuples[MAX_TUPLES - 1] |= 0x80;
+    char big[CR_FORMAT_MAX];
+    size_t big_len = cr_format(big, sizeof(big), &longest, CR_FORMAT_DECIMAL | CR_FORMAT_IMPROPER);
+    check(big_len < CR_FORMAT_MAX && cr_format(big, sizeof(big), &longest, CR_FORMAT_ENCODING) < CR_FORMAT_MAX,
+          "five-tuple values fit CR_FORMAT_MAX");
+    printf("\n");
+
+    // Test 8: Whole columns
+    printf("Test 8: cr_format_array\n");
+    char column[4096];
+    size_t column_len;
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] == '\n') text[i] = '\t';
+    }
+    check(cr_format_array(column, sizeof(column), expected, FIELDS, '\t', 0, &column_len) == FIELDS &&
+          column_len == len + 1 && memcmp(column, text, len) == 0 && column[len] == '\t',
+          "matches cr_format value by value");
+    CompactRational row[3] = {third, integer, half};
+    check(cr_format_array(column, 12, row, 3, ',', 0, &column_len) == 2 && column_len == 10 &&
+          memcmp(column, "7 1/3,-42,", 10) == 0, "stops before a value that does not fit");
+    check(cr_format_array(column, 3, row, 3, ',', 0, &column_len) == 0 && column_len == 0, "nothing fits");
+    check(cr_format_array(column, sizeof(column), row, 3, '\n', CR_FORMAT_FIXED, &column_len) == 3 &&
+          column_len == 30 && memcmp(column, "7.333333\n-42.000000\n-0.500000\n", 30) == 0, "flags apply");
+    printf("\n");
+
+    printf("=== Text Parsing and Formatting Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_text();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// WIRE FORMAT VIEW TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool same_value(const CompactRational* a, const CompactRational* b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+void test_view() {
+    printf("=== Wire Format View Tests ===\n\n");
+    CRError error;
+
+    // Test 1: The specification's example, byte for byte
+    printf("Test 1: Byte layout\n");
+    CompactRational values[2] = {cr_from_fraction(22, 3, NULL), cr_from_int(42, NULL)};
+    uint8_t buf[64];
+    size_t written;
+    const uint8_t expected[] = {0x07, 0x80, 0x81, 0x2B, 0x2A, 0x00};
+    check(cr_write_values(buf, sizeof(buf), values, 2, &written) == 2 && written == sizeof(expected) &&
+          memcmp(buf, expected, sizeof(expected)) == 0, "7 1/3 then 42 is 07 80 81 2B 2A 00");
+
+    CRView v;
+    cr_view_init(&v, expected, sizeof(expected));
+    CompactRational got[4];
+    check(cr_view_read(&v, got, 4, &error) == 2 && error.code == CR_SUCCESS && same_value(&got[0], &values[0]) &&
+          same_value(&got[1], &values[1]) && cr_view_remaining(&v) == 0 && v.count == 2,
+          "read back from a const buffer");
+    check(!cr_view_next(&v, &got[0], &error) && error.code == CR_SUCCESS, "end of data");
+    printf("\n");
+
+    // Test 2: Agrees with the packed array
+    printf("Test 2: Against CRPackedArray\n");
+    enum { N = 5000 };
+    CompactRational* column = malloc(N * sizeof(CompactRational));
+    CompactRational* decoded = malloc(N * sizeof(CompactRational));
+    for (int i = 0; i < N; i++) {
+        column[i] = i % 3 == 0 ? cr_from_int(i - 2500, NULL)
+                               : cr_encode_optimal(i * 7 - 17000, 2 + i % 250, NULL);
+    }
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    cr_pack_array(column, N, &pa, NULL);
+    uint8_t* wire = malloc(pa.size);
+    check(cr_write_values(wire, pa.size, column, N, &written) == N && written == pa.size &&
+          memcmp(wire, pa.data, pa.size) == 0, "cr_write_values writes the packed stream");
+    const CompactRational** pointers = malloc(N * sizeof(CompactRational*));
+    for (int i = 0; i < N; i++) {
+        pointers[i] = &column[N - 1 - i];
+    }
+    CRPackedArray reversed;
+    cr_packed_init(&reversed);
+    for (int i = 0; i < N; i++) {
+        cr_packed_append(&reversed, pointers[i], NULL);
+    }
+    check(cr_write_gather(wire, pa.size, pointers, N, &written) == N && written == reversed.size &&
+          memcmp(wire, reversed.data, written) == 0, "cr_write_gather follows the pointers");
+    cr_packed_free(&reversed);
+
+    cr_view_init(&v, pa.data, pa.size);
+    bool same = cr_view_read(&v, decoded, N, &error) == N && error.code == CR_SUCCESS;
+    for (int i = 0; same && i < N; i++) {
+        same = same_value(&decoded[i], &column[i]);
+    }
+    check(same, "every value decodes as stored");
+
+    cr_view_init(&v, pa.data, pa.size);
+    CompactRational at;
+    check(cr_view_skip(&v, 1234, NULL) == 1234 && cr_view_next(&v, &at, NULL) && same_value(&at, &column[1234]),
+          "skip lands on the next value");
+    CRAccumulator from_view, from_values;
+    cr_acc_init(&from_view);
+    cr_acc_init(&from_values);
+    cr_acc_add_array(&from_values, column + 1235, N - 1235);
+    check(cr_view_accumulate(&v, N, &from_view, &error) == N - 1235 && error.code == CR_SUCCESS &&
+          memcmp(&from_view, &from_values, sizeof(from_view)) == 0, "accumulating from bytes matches cr_acc_add");
+    printf("\n");
+
+    // Test 3: Receive buffers cut values anywhere
+    printf("Test 3: Cut-off values\n");
+    bool resumed = true;
+    for (size_t chunk = 1; chunk <= 13 && resumed; chunk += 3) {
+        uint8_t carry[64 + 12];
+        size_t carried = 0, total = 0, offset = 0;
+        while (offset < pa.size) {
+            size_t take = pa.size - offset < chunk ? pa.size - offset : chunk;
+            memcpy(carry + carried, pa.data + offset, take);
+            offset += take;
+            cr_view_init(&v, carry, carried + take);
+            total += cr_view_read(&v, decoded + total, N - total, &error);
+            resumed = resumed && error.code == CR_SUCCESS;
+            carried = cr_view_remaining(&v);
+            memmove(carry, carry + v.pos, carried);
+        }
+        resumed = resumed && total == N && carried == 0 && same_value(&decoded[N - 1], &column[N - 1]);
+    }
+    check(resumed, "carrying the remainder over receives of 1 to 13 bytes decodes the column");
+
+    uint8_t partial[] = {0x07, 0x80, 0x01, 0x2B, 0x02};
+    cr_view_init(&v, partial, sizeof(partial));
+    check(!cr_view_next(&v, &at, &error) && error.code == CR_SUCCESS && cr_view_remaining(&v) == 5,
+          "a value without its end flag yet is left for later");
+    printf("\n");
+
+    // Test 4: Malformed streams and full send buffers
+    printf("Test 4: Errors and limits\n");
+    uint8_t bad[] = {0x05, 0x00, 0x00, 0x80, 0x01, 0x01, 0x02, 0x01, 0x03, 0x01, 0x04, 0x01, 0x05, 0x01, 0x2A, 0x00};
+    cr_view_init(&v, bad, sizeof(bad));
+    check(cr_view_read(&v, got, 4, &error) == 1 && error.code == CR_ERROR_INVALID_ENCODING && error.value1 == 1 &&
+          error.value2 == 2 && v.pos == 2 && strstr(error.message, "byte 2") != NULL,
+          "five tuples without an end flag are rejected where they start");
+    check(cr_view_skip(&v, 1, &error) == 0 && error.code == CR_ERROR_INVALID_ENCODING, "and the view stays there");
+
+    check(cr_write_values(buf, 5, values, 2, &written) == 1 && written == 4, "a value that does not fit is not started");
+    check(cr_write_values(buf, 0, values, 2, &written) == 0 && written == 0, "no room");
+
+    size_t n = cr_write_packed(wire, 100, &pa, 77, N, &written);
+    CRPackedArray front;
+    cr_packed_init(&front);
+    cr_pack_array(column + 77, n, &front, NULL);
+    CompactRational next_value = column[77 + n];
+    check(n > 0 && written == front.size && written <= 100 && written + cr_size(&next_value) > 100 &&
+          memcmp(wire, front.data, written) == 0, "cr_write_packed copies whole values from an index seek");
+    cr_packed_free(&front);
+    check(cr_write_packed(wire, pa.size, &pa, 0, N, &written) == N && written == pa.size, "the whole stream");
+    check(cr_write_packed(wire, pa.size, &pa, N, 1, &written) == 0 && written == 0, "past the end");
+    printf("\n");
+
+    cr_packed_free(&pa);
+    free(pointers);
+    free(wire);
+    free(decoded);
+    free(column);
+    printf("=== Wire Format View Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_view();
+    return failures == 0 ? 0 : 1;
+}
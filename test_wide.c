@@ -0,0 +1,141 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// WIDE WHOLE PART TEST CASES
+// ============================================================================
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+static bool formats_as64(const CompactRational64* cr, uint32_t flags, const char* expected) {
+    char buf[CR_FORMAT_MAX];
+    size_t n = cr64_format(buf, sizeof(buf), cr, flags);
+    return n == strlen(expected) && strcmp(buf, expected) == 0;
+}
+
+void test_wide() {
+    printf("=== Wide Whole Part Tests ===\n\n");
+    CRError error;
+
+    // Test 1: Layout
+    printf("Test 1: Layout\n");
+    check(sizeof(CompactRational16) == sizeof(CompactRational), "CompactRational16 is CompactRational");
+    CompactRational32 a32 = cr32_from_int(1000000000, &error);
+    check(error.code == CR_SUCCESS && a32.whole == 1000000000, "32-bit integer stored in bits 30-0");
+    CompactRational64 a64 = cr64_from_fraction(-7, 2, &error);
+    check(error.code == CR_SUCCESS && (uint64_t)a64.whole == (0x8000000000000000ull | 0x7FFFFFFFFFFFFFFCull) &&
+          a64.tuples[0] == ((64 << 8) | 0x80), "-7/2 is -4 + 64/128 with bit 63 set");
+    printf("\n");
+
+    // Test 2: Range and clamping
+    printf("Test 2: Range\n");
+    CompactRational32 big32 = cr32_from_int(INT64_C(5000000000), &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && big32.whole == CR32_MAX_WHOLE_VALUE, "32-bit clamps at 2^30 - 1");
+    CompactRational64 big = cr64_from_int(INT64_C(123456789012345), &error);
+    check(error.code == CR_SUCCESS && cr64_to_double(&big, NULL) == 123456789012345.0, "64-bit holds 1.2e14");
+    CompactRational64 top = cr64_from_int(INT64_MAX, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && top.whole == CR64_MAX_WHOLE_VALUE, "64-bit clamps at 2^62 - 1");
+    CompactRational64 min_frac = cr64_from_fraction(INT64_MIN, -1, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && min_frac.whole == CR64_MAX_WHOLE_VALUE,
+          "INT64_MIN / -1 clamps instead of overflowing");
+    cr64_from_fraction(5, 0, &error);
+    check(error.code == CR_ERROR_DIVISION_BY_ZERO, "zero denominator reported");
+    printf("\n");
+
+    // Test 3: Widening and narrowing
+    printf("Test 3: Widen and narrow\n");
+    bool round_trip = true;
+    for (int64_t d = 1; d < 2000 && round_trip; d += 13) {
+        for (int64_t n = -20000 * d; n <= 20000 * d; n += 997 * d + 11) {
+            CompactRational v = cr_encode_optimal(n, d, NULL);
+            CompactRational32 w32 = cr32_from_cr(&v);
+            CompactRational64 w64 = cr64_from_cr(&v);
+            CompactRational b32 = cr32_to_cr(&w32, &error), b64 = cr64_to_cr(&w64, NULL);
+            if (error.code != CR_SUCCESS || memcmp(&b32, &v, sizeof(v)) != 0 || memcmp(&b64, &v, sizeof(v)) != 0) {
+                round_trip = false;
+            }
+        }
+    }
+    check(round_trip, "16 -> 32/64 -> 16 is bit-exact");
+    CompactRational narrowed = cr64_to_cr(&big, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED && cr_to_double(&narrowed, NULL) == MAX_WHOLE_VALUE,
+          "narrowing clamps to MAX_WHOLE_VALUE");
+    printf("\n");
+
+    // Test 4: Arithmetic past the 16-bit range
+    printf("Test 4: Arithmetic\n");
+    CompactRational third = cr_from_fraction(1, 3, NULL);
+    CompactRational64 total;
+    cr64_init(&total);
+    CompactRational64 step = cr64_from_fraction(16000 * 3 + 1, 3, NULL);  // 16000 1/3
+    for (int i = 0; i < 3000; i++) {
+        total = cr64_add(&total, &step, &error);
+    }
+    check(error.code == CR_SUCCESS && total.whole == 48001000,
+          "3000 * (16000 1/3) = 48001000 exactly");
+    CompactRational64 back = cr64_sub(&total, &step, NULL);
+    CompactRational64 expected = cr64_from_fraction(2999LL * (16000 * 3 + 1), 3, NULL);
+    check(cr64_cmp(&back, &expected) == 0, "subtraction");
+    CompactRational64 negated = cr64_neg(&expected, NULL);
+    CompactRational64 zero = cr64_add(&negated, &expected, NULL);
+    check(zero.whole == 0 && cr64_to_double(&negated, NULL) == -cr64_to_double(&expected, NULL), "negation");
+    CompactRational32 w = cr32_from_cr(&third), sum32 = cr32_add(&w, &w, NULL);
+    check(cr32_cmp(&sum32, &w) > 0 && cr32_to_double(&sum32, NULL) == 2.0 / 3.0, "32-bit fraction arithmetic");
+    CompactRational64 near = cr64_from_int(CR64_MAX_WHOLE_VALUE, NULL);
+    cr64_add(&near, &step, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED, "clamps only outside the 64-bit range");
+    printf("\n");
+
+    // Test 5: Exact comparison
+    printf("Test 5: Comparison\n");
+    CompactRational64 x = cr64_from_fraction(INT64_C(1000000000000) * 239 + 1, 239, NULL);
+    CompactRational64 y = cr64_from_fraction(INT64_C(1000000000000) * 241 + 1, 241, NULL);
+    check(cr64_cmp(&x, &y) > 0 && cr64_cmp(&y, &x) < 0 && cr64_cmp(&x, &x) == 0,
+          "10^12 + 1/239 > 10^12 + 1/241, beyond double resolution");
+    CompactRational64 lo = cr64_from_int(CR64_MIN_WHOLE_VALUE, NULL);
+    check(cr64_cmp(&lo, &top) < 0 && cr64_cmp(&top, &lo) > 0, "whole range without overflow");
+    printf("\n");
+
+    // Test 6: Formatting
+    printf("Test 6: Formatting\n");
+    check(formats_as64(&total, 0, "48001000") && formats_as64(&back, 0, "47984999 2/3"), "mixed numbers");
+    check(formats_as64(&negated, CR_FORMAT_IMPROPER, "-143954999/3") &&
+          formats_as64(&negated, CR_FORMAT_FIXED, "-47984999.666667"), "improper and fixed");
+    CompactRational tiny = cr_encode_optimal(1, 255 * 254, NULL);
+    CompactRational64 huge = cr64_from_int(CR64_MAX_WHOLE_VALUE - 1, NULL), tiny64 = cr64_from_cr(&tiny);
+    huge = cr64_add(&huge, &tiny64, NULL);
+    check(formats_as64(&huge, CR_FORMAT_IMPROPER, "298698903413541914412541/64770"), "improper numerator over 2^64");
+    check(formats_as64(&a64, CR_FORMAT_ENCODING, "Encoding: whole=0xFFFFFFFFFFFFFFFC (bit63=1) [64/128(end)]"),
+          "64-bit encoding");
+    char text[CR_FORMAT_MAX];
+    cr32_format(text, sizeof(text), &sum32, CR_FORMAT_DECIMAL);
+    check(strcmp(text, "2/3 (0.666667)") == 0, "32-bit format");
+    printf("\n");
+
+    // Test 7: Column totals
+    printf("Test 7: cr64_sum_parallel\n");
+    enum { N = 100000 };
+    static CompactRational column[N];
+    for (int i = 0; i < N; i++) {
+        column[i] = (i % 2) ? cr_from_fraction(16000 * 7 + 3, 7, NULL) : cr_from_int(16383, NULL);
+    }
+    CompactRational64 sum = cr64_sum_parallel(column, N, 4, &error);
+    CompactRational64 expect = cr64_from_fraction(INT64_C(50000) * 16383 * 7 + INT64_C(50000) * (16000 * 7 + 3), 7, NULL);
+    check(error.code == CR_SUCCESS && cr64_cmp(&sum, &expect) == 0, "1.6e9 total, exact, no clamp");
+    cr_sum_parallel(column, N, 4, &error);
+    check(error.code == CR_ERROR_VALUE_CLAMPED, "cr_sum_parallel still clamps the same total");
+    printf("\n");
+
+    printf("=== Wide Whole Part Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_wide();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include "compact_rational.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// ZONE MAP TEST CASES
+// ============================================================================
+
+#define PATH "test_zone.crcol"
+#define BLOCK 256
+
+static int failures = 0;
+
+static void check(bool condition, const char* description) {
+    printf("  %s: %s\n", condition ? "PASS" : "FAIL", description);
+    if (!condition) failures++;
+}
+
+enum { N = 5000 };
+static CompactRational values[N];
+static uint64_t bitmap[(N + 63) / 64];
+
+// Whether a filter bitmap selects exactly the values in [lo, hi]
+static bool matches_scan(const uint64_t* bits, const CompactRational* lo, const CompactRational* hi, size_t selected) {
+    size_t expected = 0;
+    for (size_t i = 0; i < N; i++) {
+        bool in = (lo == NULL || cr_cmp(&values[i], lo) >= 0) && (hi == NULL || cr_cmp(&values[i], hi) <= 0);
+        if (in != (bool)((bits[i / 64] >> (i % 64)) & 1)) return false;
+        expected += in;
+    }
+    return expected == selected;
+}
+
+void test_zone() {
+    printf("=== Zone Map Tests ===\n\n");
+    CRError error;
+
+    // Values that rise slowly, so blocks cover narrow ranges; the tail is integers
+    for (int i = 0; i < N; i++) {
+        values[i] = i < 3000 ? cr_from_fraction(i, 7, NULL) : cr_from_int(i / 3 - 600, NULL);
+    }
+    CRPackedArray pa;
+    cr_packed_init(&pa);
+    cr_pack_array(values, N, &pa, NULL);
+
+    // Test 1: Built statistics match the column file's
+    printf("Test 1: Statistics\n");
+    CRZoneMap zm;
+    check(cr_zone_map_build(&zm, &pa, BLOCK, &error) && error.code == CR_SUCCESS &&
+          zm.block_count == (N + BLOCK - 1) / BLOCK, "zone map built");
+    cr_file_write_packed(PATH, &pa, BLOCK, NULL);
+    CRFile f;
+    bool opened = cr_file_open(&f, PATH, 0, NULL);
+    check(opened && f.block_count == zm.block_count &&
+          memcmp(f.blocks, zm.blocks, zm.block_count * sizeof(CRFileBlock)) == 0, "identical to the file's block table");
+    CompactRational first_min = cr_from_int(0, NULL), first_max = cr_from_fraction(BLOCK - 1, 7, NULL);
+    check(cr_cmp(&zm.blocks[0].min, &first_min) == 0 && cr_cmp(&zm.blocks[0].max, &first_max) == 0 &&
+          zm.blocks[zm.block_count - 1].integer_count == zm.blocks[zm.block_count - 1].count, "min, max and integer count");
+    printf("\n");
+
+    // Test 2: Filters agree with a full scan
+    printf("Test 2: Filters\n");
+    CompactRational b[4] = {
+        cr_from_fraction(179, 2, NULL), cr_from_fraction(301, 3, NULL), cr_from_int(500, NULL), cr_from_int(-5, NULL),
+    };
+    bool all_ok = true;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            size_t selected = cr_filter_range(&pa, &zm, &b[i], &b[j], bitmap, &error);
+            all_ok = all_ok && error.code == CR_SUCCESS && matches_scan(bitmap, &b[i], &b[j], selected);
+        }
+        size_t selected = cr_filter_range(&pa, &zm, &b[i], NULL, bitmap, NULL);
+        all_ok = all_ok && matches_scan(bitmap, &b[i], NULL, selected);
+        selected = cr_filter_range(&pa, &zm, NULL, &b[i], bitmap, NULL);
+        all_ok = all_ok && matches_scan(bitmap, NULL, &b[i], selected);
+    }
+    check(all_ok, "every bound pair, open bounds and empty ranges");
+    check(cr_filter_range(&pa, &zm, NULL, NULL, bitmap, NULL) == N && matches_scan(bitmap, NULL, NULL, N),
+          "no bounds selects everything");
+    check(cr_filter_range(&pa, &zm, &b[0], NULL, bitmap, NULL) == N - 627, "scores >= 89 1/2");
+    if (opened) {
+        CRZoneMap view;
+        cr_zone_map_from_file(&view, &f);
+        size_t selected = cr_filter_range(&f.values, &view, &b[3], &b[1], bitmap, &error);
+        check(error.code == CR_SUCCESS && matches_scan(bitmap, &b[3], &b[1], selected), "file view");
+        cr_zone_map_free(&view);
+        cr_file_close(&f);
+    }
+    printf("\n");
+
+    // Test 3: Whole blocks are decided from their statistics
+    printf("Test 3: Skipping\n");
+    size_t block1 = (size_t)zm.blocks[1].offset, block2 = (size_t)zm.blocks[2].offset;
+    memset(pa.data + block1, 0xFF, block2 - block1);  // Garbage the second block
+    CompactRational lo = cr_from_int(200, NULL), hi = cr_from_int(300, NULL);
+    size_t selected = cr_filter_range(&pa, &zm, &lo, &hi, bitmap, &error);
+    check(error.code == CR_SUCCESS && matches_scan(bitmap, &lo, &hi, selected), "blocks outside the range are not read");
+    lo = cr_from_int(0, NULL);
+    selected = cr_filter_range(&pa, &zm, &lo, &hi, bitmap, &error);
+    check(error.code == CR_SUCCESS && matches_scan(bitmap, &lo, &hi, selected), "nor blocks inside it");
+    lo = cr_from_int(40, NULL);
+    selected = cr_filter_range(&pa, &zm, &lo, &hi, bitmap, &error);
+    check(!matches_scan(bitmap, &lo, &hi, selected), "a straddled block is decoded (and sees the garbage)");
+    printf("\n");
+
+    // Test 4: Errors and edge cases
+    printf("Test 4: Errors\n");
+    CRPackedArray empty;
+    cr_packed_init(&empty);
+    CRZoneMap none;
+    check(cr_zone_map_build(&none, &empty, 0, &error) && none.block_count == 0 &&
+          cr_filter_range(&empty, &none, NULL, NULL, bitmap, &error) == 0 && error.code == CR_SUCCESS, "empty array");
+    cr_filter_range(&empty, &zm, NULL, NULL, bitmap, &error);
+    check(error.code == CR_ERROR_OUT_OF_BOUNDS && error.value1 == N && error.value2 == 0, "zone map of another array");
+    cr_zone_map_free(&none);
+    cr_zone_map_free(&zm);
+    cr_packed_free(&pa);
+    remove(PATH);
+    printf("\n");
+
+    printf("=== Zone Map Tests Complete: %d failure%s ===\n", failures, failures == 1 ? "" : "s");
+}
+
+int main() {
+    test_zone();
+    return failures == 0 ? 0 : 1;
+}